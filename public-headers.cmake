@@ -2,10 +2,16 @@
 # "Public headers" stands for headers exposing to clients.
 
 # First list all headers here
+# Headers of the C++20 coroutine executor belong to target thread-pool-sorter-coroutine.
 file (GLOB_RECURSE THREAD_POOL_SORTER_PUBLIC_HEADERS_LIST RELATIVE "${PROJECT_SOURCE_DIR}" "${PROJECT_SOURCE_DIR}/src/*.h")
+list (FILTER THREAD_POOL_SORTER_PUBLIC_HEADERS_LIST EXCLUDE REGEX "^src/coroutine/")
+
+file (GLOB_RECURSE THREAD_POOL_SORTER_COROUTINE_PUBLIC_HEADERS_LIST RELATIVE "${PROJECT_SOURCE_DIR}" "${PROJECT_SOURCE_DIR}/src/coroutine/*.h")
 
 # Concat list items with semicolon to satisfy set_target_properties()
 list (JOIN THREAD_POOL_SORTER_PUBLIC_HEADERS_LIST "\;" THREAD_POOL_SORTER_PUBLIC_HEADERS)
+list (JOIN THREAD_POOL_SORTER_COROUTINE_PUBLIC_HEADERS_LIST "\;" THREAD_POOL_SORTER_COROUTINE_PUBLIC_HEADERS)
 
 # Cleanup
 unset (THREAD_POOL_SORTER_PUBLIC_HEADERS_LIST)
+unset (THREAD_POOL_SORTER_COROUTINE_PUBLIC_HEADERS_LIST)
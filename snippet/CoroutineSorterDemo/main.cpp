@@ -0,0 +1,77 @@
+/**
+ * @file main.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 协程流水线分块排序示例程序入口文件。
+ * @details 每个块由一个协程完成 读取 -> 排序 -> 写出 三个阶段：读写时协程挂起，I/O 由线程池的 I/O 通道完成，排序在计算线程上执行。所有块的协程同时启动，在途 I/O 数量远多于线程数。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include <iostream>
+#include <chrono>
+#include <algorithm>
+#include <vector>
+
+#include "lthreadpool.h"
+#include "lrandom.h"
+#include "lutil.h"
+#include "ltask.h"
+#include "lasyncfile.h"
+
+
+/**
+ * @brief 排序一个块：异步读取，排序，异步写回同一偏移，得到一个有序段（run）。
+ */
+LTask<bool> sortChunk(LAsyncFile &input, LAsyncFile &output, long long offset, size_t bytes)
+{
+    std::vector<int> buffer(bytes / sizeof(int));
+
+    size_t readBytes = co_await input.read(buffer.data(), bytes, offset);
+    buffer.resize(readBytes / sizeof(int));
+
+    std::sort(buffer.begin(), buffer.end());
+
+    co_await output.write(buffer.data(), buffer.size() * sizeof(int), offset);
+
+
+    co_return std::is_sorted(buffer.begin(), buffer.end());
+}
+
+
+int main()
+{
+    // 生成测试文件。
+    const std::string testFilePath = LUtil::executableDirectory() + "test.bin";
+    const std::string runsFilePath = testFilePath + ".runs";
+    LRandom::genRandomFile(testFilePath, 0, 1000000, 10000000);
+
+    LThreadPoolOptions options;
+    options.ioThreads = 2;
+    LThreadPool pool(options);
+
+    LAsyncFile input(&pool);
+    input.open(testFilePath, LAsyncFile::OpenMode::Read);
+    LAsyncFile output(&pool);
+    output.open(runsFilePath, LAsyncFile::OpenMode::Write);
+
+    // 每块 1 MB，同时启动所有块的协程。
+    constexpr size_t chunkBytes = 1 << 20;
+    long long fileSize = input.size();
+
+    auto before = std::chrono::high_resolution_clock::now();
+
+    std::vector<std::future<bool>> futures;
+    for (long long offset = 0; offset < fileSize; offset += chunkBytes) futures.push_back(LCoroutine::spawn(pool, sortChunk(input, output, offset, chunkBytes)));
+
+    size_t sortedRuns = 0;
+    for (auto &f : futures) sortedRuns += pool.wait(f) ? 1 : 0;
+
+    auto now = std::chrono::high_resolution_clock::now();
+    std::cout << sortedRuns << " of " << futures.size() << " runs generated by coroutines in "
+              << std::chrono::duration_cast<std::chrono::milliseconds>(now - before).count()
+              << " ms.\n";
+
+
+    return 0;
+}
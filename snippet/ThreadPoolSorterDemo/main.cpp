@@ -28,8 +28,12 @@ int main()
               << std::chrono::duration_cast<std::chrono::milliseconds>(now - before).count()
               << " ms.\n";
 
-    // 创建线程池。
-    LThreadPool pool(12);
+    // 创建线程池。计算线程数取自进程可用 CPU 集合与 cgroup 配额，并按拓扑绑定到 CPU；2 个 I/O 线程负责块读取与临时文件写出。
+    LThreadPoolOptions options;
+    options.ioThreads = 2;
+    options.pinWorkers = true;
+    LThreadPool pool(options);
+    std::cout << "Thread pool started with " << pool.size() << " worker threads.\n";
 
     // 开始线程池排序。
     LSorter sorter(&pool);
@@ -41,6 +45,14 @@ int main()
               << std::chrono::duration_cast<std::chrono::milliseconds>(now - before).count()
               << " ms.\n";
 
+    // 输出线程池统计：利用率低而排队时间长说明任务供给不足，I/O 利用率接近 1 说明受限于磁盘。
+    LThreadPoolStats stats = pool.stats();
+    std::cout << "Tasks completed: " << stats.completed
+              << ", cpu utilization: " << stats.utilization() * 100 << "%"
+              << ", io utilization: " << stats.ioUtilization() * 100 << "%\n"
+              << "Queue wait p50/p99: " << stats.queueWait.percentile(50) / 1000 << "/" << stats.queueWait.percentile(99) / 1000 << " us"
+              << ", run time p50/p99: " << stats.runTime.percentile(50) / 1000 << "/" << stats.runTime.percentile(99) / 1000 << " us.\n";
+
 
     return 0;
 }
@@ -0,0 +1,123 @@
+/**
+ * @file lasyncfile.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 可被协程等待的异步文件类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lasyncfile.h"
+
+#include <stdexcept>
+#include <system_error>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+
+
+LAsyncFile::LAsyncFile(LThreadPool *pool) : m_pool(pool)
+{
+    if (!pool) throw std::runtime_error("Pointer pool is a nullptr.");
+}
+
+LAsyncFile::~LAsyncFile()
+{
+    close();
+
+    if (m_pool) m_pool = nullptr;
+}
+
+void LAsyncFile::open(const std::string &filePath, OpenMode mode)
+{
+    close();
+
+    int flags = O_RDONLY;
+    if (OpenMode::Write == mode) flags = O_WRONLY | O_CREAT | O_TRUNC;
+    if (OpenMode::ReadWrite == mode) flags = O_RDWR | O_CREAT;
+    m_fd = ::open(filePath.c_str(), flags | O_CLOEXEC, 0644);
+    if (m_fd < 0) throw std::runtime_error("Failed to open file " + filePath + ", errno " + std::to_string(errno) + ".");
+}
+
+void LAsyncFile::close()
+{
+    if (m_fd >= 0) ::close(m_fd);
+    m_fd = -1;
+}
+
+bool LAsyncFile::isOpen() const
+{
+    return m_fd >= 0;
+}
+
+long long LAsyncFile::size() const
+{
+    struct stat st;
+    if (m_fd < 0 || 0 != fstat(m_fd, &st)) return 0;
+
+
+    return st.st_size;
+}
+
+LAsyncFile::IoAwaiter LAsyncFile::read(void *buffer, size_t bytes, long long offset)
+{
+    return {m_pool, m_fd, buffer, bytes, offset, false};
+}
+
+LAsyncFile::IoAwaiter LAsyncFile::write(const void *buffer, size_t bytes, long long offset)
+{
+    return {m_pool, m_fd, const_cast<void *>(buffer), bytes, offset, true};
+}
+
+void LAsyncFile::IoAwaiter::await_suspend(std::coroutine_handle<> handle)
+{
+    // 协程挂起期间 awaiter 位于协程帧中，地址保持有效，直到协程被恢复。
+    // I/O 线程完成读写后，将协程重新调度到计算通道恢复执行，而不是在 I/O 线程上继续运行协程体。
+    // 调度失败（如线程池正在停止）时协程尚未恢复，awaiter 仍然有效：记录异常并直接在 I/O 线程上恢复，由 await_resume() 重新抛出，
+    // 否则异常被 I/O 任务的 future 吞掉，协程帧既不恢复也不销毁，等待它的任务永远不会完成。
+    pool->enqueueIo(LThreadPool::Priority::Normal, [this, pool = pool, handle]() {
+        perform();
+
+        try
+        {
+            pool->enqueue([handle]() { handle.resume(); });
+        }
+        catch (...)
+        {
+            exception = std::current_exception();
+            handle.resume();
+        }
+    });
+}
+
+size_t LAsyncFile::IoAwaiter::await_resume() const
+{
+    if (exception) std::rethrow_exception(exception);
+    if (0 != error) throw std::system_error(error, std::generic_category(), isWrite ? "LAsyncFile write" : "LAsyncFile read");
+
+
+    return result;
+}
+
+void LAsyncFile::IoAwaiter::perform()
+{
+    // 循环读写直到完成请求的字节数，读操作遇到文件末尾提前结束。
+    char *data = static_cast<char *>(buffer);
+    while (result < bytes)
+    {
+        ssize_t n = isWrite ? ::pwrite(fd, data + result, bytes - result, offset + result)
+                            : ::pread(fd, data + result, bytes - result, offset + result);
+        if (n < 0)
+        {
+            if (EINTR == errno) continue;
+
+            error = errno;
+            return;
+        }
+        if (0 == n) return;
+
+        result += n;
+    }
+}
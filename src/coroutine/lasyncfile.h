@@ -0,0 +1,145 @@
+/**
+ * @file lasyncfile.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 可被协程等待的异步文件类头文件。
+ * @details LAsyncFile 的 read() / write() 返回 awaiter，co_await 时协程挂起，读写操作交给 LThreadPool 的 I/O 通道执行，完成后协程被重新调度到计算通道恢复。等待 I/O 的协程不占用任何计算线程，因此同一时刻在途的 I/O 数量只受协程数量限制，而不受计算线程数量限制。
+ * 本头文件需要 C++20，仅在开启 WITH_COROUTINE 选项时由 thread-pool-sorter-coroutine 目标使用。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LASYNCFILE_H_
+#define _LASYNCFILE_H_
+
+#include "lglobalmacros.h"
+
+#include <coroutine>
+#include <exception>
+#include <string>
+
+#include "lthreadpool.h"
+
+
+/**
+ * @class LAsyncFile
+ * @brief 可被协程等待的异步文件。
+ *
+ * @note 使用方法
+ *   LAsyncFile file(&pool);
+ *   file.open(path, LAsyncFile::OpenMode::Read);
+ *   size_t n = co_await file.read(buffer, bytes, offset);
+ */
+class LAsyncFile
+{
+    L_CLASS_NONCOPYABLE(LAsyncFile)
+
+public:
+
+    /**
+     * @brief 打开模式。
+     */
+    enum class OpenMode
+    {
+        Read = 0, // 只读打开已有文件。
+        Write,    // 只写打开，不存在则创建，存在则截断。
+        ReadWrite // 读写打开，不存在则创建，不截断。
+    };
+
+    /**
+     * @brief 一次读写操作的 awaiter，co_await 的结果为实际读写的字节数。
+     * @note 读操作遇到文件末尾时返回的字节数可能小于请求的字节数；出错时在 co_await 处抛出 std::system_error，无法调度回计算通道时重新抛出调度失败的异常。
+     */
+    struct IoAwaiter
+    {
+        LThreadPool *pool;                      // 执行 I/O 与恢复协程的线程池。
+        int fd;                                 // 文件描述符。
+        void *buffer;                           // 读写缓冲区。
+        size_t bytes;                           // 请求的字节数。
+        long long offset;                       // 文件偏移。
+        bool isWrite;                           // 是否为写操作。
+        size_t result = 0;                      // 实际读写的字节数。
+        int error = 0;                          // 出错时的 errno。
+        std::exception_ptr exception = nullptr; // 无法将协程调度回计算通道（如线程池已停止）时的异常。
+
+        bool await_ready() const noexcept { return 0 == bytes; }
+
+        void await_suspend(std::coroutine_handle<> handle);
+
+        size_t await_resume() const;
+
+        /**
+         * @brief 在 I/O 线程中执行读写。
+         */
+        void perform();
+    };
+
+    /**
+     * @brief 构造函数。
+     * @param pool 外部线程池指针。
+     */
+    LAsyncFile(LThreadPool *pool);
+
+    /**
+     * @brief 析构函数，关闭文件。
+     */
+    virtual ~LAsyncFile();
+
+    /**
+     * @brief 打开文件，失败抛出 std::runtime_error。
+     * @param filePath 文件路径。
+     * @param mode 打开模式。
+     */
+    void open(const std::string &filePath, OpenMode mode);
+
+    /**
+     * @brief 关闭文件。
+     */
+    void close();
+
+    /**
+     * @brief 文件是否已打开。
+     * @return 已打开返回 true。
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief 返回文件大小。
+     * @return 文件字节数。
+     */
+    long long size() const;
+
+    /**
+     * @brief 从指定偏移读取数据。
+     * @param buffer 目标缓冲区。
+     * @param bytes 请求的字节数。
+     * @param offset 文件偏移。
+     * @return IoAwaiter 可被 co_await 的对象，结果为实际读取的字节数。
+     */
+    IoAwaiter read(void *buffer, size_t bytes, long long offset);
+
+    /**
+     * @brief 向指定偏移写入数据。
+     * @param buffer 源缓冲区。
+     * @param bytes 写入的字节数。
+     * @param offset 文件偏移。
+     * @return IoAwaiter 可被 co_await 的对象，结果为实际写入的字节数。
+     */
+    IoAwaiter write(const void *buffer, size_t bytes, long long offset);
+
+
+private:
+
+    /**
+     * @brief 外部线程池指针。
+     */
+    LThreadPool *m_pool = nullptr;
+
+    /**
+     * @brief 文件描述符，未打开为 -1。
+     */
+    int m_fd = -1;
+};
+
+
+#endif
@@ -0,0 +1,265 @@
+/**
+ * @file ltask.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief C++20 协程任务类头文件。
+ * @details LTask<T> 是惰性启动的协程任务：创建后不会立即执行，被 co_await 时才开始运行，完成后通过对称转移（symmetric transfer）直接恢复等待者。配合 LThreadPool::schedule() 可以让协程在线程池工作线程上执行，配合 LAsyncFile 可以在等待磁盘 I/O 时挂起而不占用工作线程。
+ * 本头文件需要 C++20，仅在开启 WITH_COROUTINE 选项时由 thread-pool-sorter-coroutine 目标使用。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LTASK_H_
+#define _LTASK_H_
+
+#include <coroutine>
+#include <exception>
+#include <future>
+#include <memory>
+#include <optional>
+#include <utility>
+
+#include "lthreadpool.h"
+
+
+template <class T>
+class LTask;
+
+
+namespace LCoroutineDetail
+{
+    /**
+     * @brief 协程任务 promise 的公共部分：惰性启动、结束时恢复等待者、保存异常。
+     */
+    struct PromiseBase
+    {
+        /**
+         * @brief 协程结束时的 awaiter，恢复等待者，没有等待者时返回 noop 协程。
+         */
+        struct FinalAwaiter
+        {
+            bool await_ready() const noexcept { return false; }
+
+            template <class Promise>
+            std::coroutine_handle<> await_suspend(std::coroutine_handle<Promise> handle) const noexcept
+            {
+                std::coroutine_handle<> continuation = handle.promise().continuation;
+
+
+                return continuation ? continuation : std::noop_coroutine();
+            }
+
+            void await_resume() const noexcept {}
+        };
+
+        std::suspend_always initial_suspend() const noexcept { return {}; }
+
+        FinalAwaiter final_suspend() const noexcept { return {}; }
+
+        void unhandled_exception() noexcept { exception = std::current_exception(); }
+
+        std::coroutine_handle<> continuation; // 等待本任务完成的协程。
+        std::exception_ptr exception;         // 协程体抛出的异常。
+    };
+
+    /**
+     * @brief 有返回值的协程任务 promise。
+     */
+    template <class T>
+    struct Promise : PromiseBase
+    {
+        template <class U>
+        void return_value(U &&value) { result.emplace(std::forward<U>(value)); }
+
+        T take()
+        {
+            if (exception) std::rethrow_exception(exception);
+
+
+            return std::move(*result);
+        }
+
+        std::optional<T> result; // 协程返回值。
+    };
+
+    /**
+     * @brief 无返回值的协程任务 promise。
+     */
+    template <>
+    struct Promise<void> : PromiseBase
+    {
+        void return_void() const noexcept {}
+
+        void take()
+        {
+            if (exception) std::rethrow_exception(exception);
+        }
+    };
+
+    /**
+     * @brief 即发即弃的协程，启动后立即执行，结束时自动销毁协程帧。
+     */
+    struct Detached
+    {
+        struct promise_type
+        {
+            Detached get_return_object() const noexcept { return {}; }
+            std::suspend_never initial_suspend() const noexcept { return {}; }
+            std::suspend_never final_suspend() const noexcept { return {}; }
+            void return_void() const noexcept {}
+            void unhandled_exception() const noexcept { std::terminate(); }
+        };
+    };
+}
+
+
+/**
+ * @class LTask
+ * @brief 惰性启动、可被 co_await 的协程任务。
+ * @tparam T 返回值类型，默认 void。
+ *
+ * @note 使用方法
+ *   LTask<int> compute(LThreadPool &pool)
+ *   {
+ *       co_await pool.schedule(); // 切换到线程池工作线程执行。
+ *       co_return 42;
+ *   }
+ *
+ *   int value = LCoroutine::syncWait(pool, compute(pool));
+ */
+template <class T = void>
+class LTask
+{
+
+public:
+
+    struct promise_type : LCoroutineDetail::Promise<T>
+    {
+        LTask get_return_object() noexcept { return LTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+    };
+
+    /**
+     * @brief 移动构造函数。
+     */
+    LTask(LTask &&other) noexcept : m_handle(std::exchange(other.m_handle, {})) {}
+
+    /**
+     * @brief 移动赋值运算符。
+     */
+    LTask &operator=(LTask &&other) noexcept
+    {
+        if (this != &other)
+        {
+            if (m_handle) m_handle.destroy();
+            m_handle = std::exchange(other.m_handle, {});
+        }
+
+
+        return *this;
+    }
+
+    LTask(const LTask &other) = delete;
+    LTask &operator=(const LTask &other) = delete;
+
+    /**
+     * @brief 析构函数，销毁协程帧。
+     */
+    virtual ~LTask()
+    {
+        if (m_handle) m_handle.destroy();
+    }
+
+    bool await_ready() const noexcept { return !m_handle || m_handle.done(); }
+
+    /**
+     * @brief 记录等待者并通过对称转移启动本任务。
+     */
+    std::coroutine_handle<> await_suspend(std::coroutine_handle<> continuation) noexcept
+    {
+        m_handle.promise().continuation = continuation;
+
+
+        return m_handle;
+    }
+
+    /**
+     * @brief 返回任务结果，协程体抛出的异常在此重新抛出。
+     */
+    T await_resume() { return m_handle.promise().take(); }
+
+
+private:
+
+    explicit LTask(std::coroutine_handle<promise_type> handle) noexcept : m_handle(handle) {}
+
+
+private:
+
+    /**
+     * @brief 协程句柄。
+     */
+    std::coroutine_handle<promise_type> m_handle;
+};
+
+
+namespace LCoroutine
+{
+    /**
+     * @brief 在线程池上启动协程任务，返回可获取结果的 future。
+     * @param pool 线程池。
+     * @param task 协程任务。
+     * @return std::future<T> 任务结果。
+     * @note 任务立即被调度到线程池计算通道执行，调用者不会阻塞。可以同时启动远多于工作线程数量的任务，它们在等待 I/O 时挂起，不占用工作线程。
+     */
+    template <class T>
+    std::future<T> spawn(LThreadPool &pool, LTask<T> task)
+    {
+        auto promise = std::make_shared<std::promise<T>>();
+        std::future<T> future = promise->get_future();
+
+        // 不捕获任何变量的协程 lambda，参数会被复制到协程帧中，生命周期安全。
+        [](LThreadPool &pool, LTask<T> task, std::shared_ptr<std::promise<T>> promise) -> LCoroutineDetail::Detached {
+            // 调度放在 try 中：线程池已停止时 schedule() 抛出的异常同样交给 future，而不是逃出协程导致 std::terminate。
+            try
+            {
+                co_await pool.schedule();
+
+                if constexpr (std::is_void_v<T>)
+                {
+                    co_await task;
+                    promise->set_value();
+                }
+                else
+                {
+                    promise->set_value(co_await task);
+                }
+            }
+            catch (...)
+            {
+                promise->set_exception(std::current_exception());
+            }
+        }(pool, std::move(task), promise);
+
+
+        return future;
+    }
+
+    /**
+     * @brief 在线程池上执行协程任务并阻塞等待结果。
+     * @param pool 线程池。
+     * @param task 协程任务。
+     * @return T 任务结果。
+     * @note 等待通过 LThreadPool::wait() 进行，可以在线程池任务内部调用。
+     */
+    template <class T>
+    T syncWait(LThreadPool &pool, LTask<T> task)
+    {
+        std::future<T> future = spawn(pool, std::move(task));
+
+
+        return pool.wait(future);
+    }
+}
+
+
+#endif
@@ -0,0 +1,844 @@
+/**
+ * @file lblockio.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 按块读写文件的类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lblockio.h"
+
+#include "lglobalmacros.h"
+#include "liouring.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <memory>
+#include <new>
+#include <stdexcept>
+
+#ifdef L_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/stat.h>
+#endif
+
+
+/**
+ * @brief 分配 count 个 blockSize 字节的对齐块缓冲区，对齐满足 O_DIRECT 对缓冲区地址的要求。
+ * @param count 块数量。
+ * @param blockSize 块字节数。
+ * @return 管理整块内存的 shared_ptr。
+ */
+static std::shared_ptr<char> allocateBlocks(size_t count, size_t blockSize)
+{
+    size_t bytes = std::max<size_t>(1, count * blockSize);
+
+
+    return std::shared_ptr<char>(static_cast<char *>(::operator new(bytes, std::align_val_t(LBlockIo::directAlignment))), [](char *ptr) { //
+        ::operator delete(ptr, std::align_val_t(LBlockIo::directAlignment));
+    });
+}
+
+/**
+ * @brief 向下、向上取整到 O_DIRECT 对齐单位的整数倍。
+ */
+static size_t alignDown(size_t bytes)
+{
+    return bytes / LBlockIo::directAlignment * LBlockIo::directAlignment;
+}
+
+static size_t alignUp(size_t bytes)
+{
+    return alignDown(bytes + LBlockIo::directAlignment - 1);
+}
+
+/**
+ * @brief 生成带 errno 描述的异常信息。
+ */
+static std::string errorMessage(const std::string &what, const std::string &filePath, int error)
+{
+    return what + " " + filePath + ": " + std::strerror(error);
+}
+
+#ifdef L_OS_LINUX
+
+/**
+ * @brief 使用 io_uring 读写文件的一段区间。
+ * @param ring io_uring 实例。
+ * @param fd 文件描述符。
+ * @param buffer 内存缓冲区。
+ * @param bytes 字节数。
+ * @param offset 文件偏移。
+ * @param write true 为写，false 为读。
+ * @param blockSize 单个请求的字节数。
+ * @return 成功返回 0，失败返回 errno。
+ */
+static int transferRange(LIoUring &ring, int fd, char *buffer, size_t bytes, uint64_t offset, bool write, size_t blockSize)
+{
+    // 函数执行逻辑：
+    // 1. 将区间拆成 blockSize 大小的段，段下标作为请求的用户数据。
+    // 2. 保持最多 ring.entries() 个请求在途，每收割一个完成事件就补交下一段。
+    // 3. 短读写时补交该段剩余的部分；出错时记录 errno，不再提交新段，但仍收割所有在途请求后才返回，保证内核不再访问缓冲区。
+    struct Segment
+    {
+        size_t begin;
+        size_t bytes;
+        size_t done;
+    };
+
+    std::vector<Segment> segments;
+    for (size_t begin = 0; begin < bytes; begin += blockSize) segments.push_back({begin, std::min(blockSize, bytes - begin), 0});
+
+    auto prepare = [&](size_t index) {
+        Segment &segment = segments[index];
+        char *address = buffer + segment.begin + segment.done;
+        unsigned int length = static_cast<unsigned int>(segment.bytes - segment.done);
+        uint64_t position = offset + segment.begin + segment.done;
+
+        if (write) ring.prepareWrite(fd, address, length, position, index);
+        else ring.prepareRead(fd, address, length, position, index);
+    };
+
+    size_t next = 0;
+    size_t inFlight = 0;
+    int error = 0;
+
+    while (next < segments.size() && inFlight < ring.entries()) prepare(next++), ++inFlight;
+    ring.submit();
+
+    while (inFlight > 0)
+    {
+        uint64_t index;
+        int result;
+        ring.waitCompletion(index, result);
+        --inFlight;
+
+        Segment &segment = segments[index];
+        if (result <= 0)
+        {
+            // 读到 0 字节说明区间超出了文件末尾。
+            if (0 == error) error = result < 0 ? -result : EIO;
+            continue;
+        }
+
+        segment.done += static_cast<size_t>(result);
+        if (0 != error) continue;
+
+        if (segment.done < segment.bytes) prepare(index), ++inFlight;
+        else if (next < segments.size()) prepare(next++), ++inFlight;
+        ring.submit();
+    }
+
+
+    return error;
+}
+
+/**
+ * @brief 打开文件，direct 为 true 时尝试加上 O_DIRECT。
+ * @param filePath 文件路径。
+ * @param flags open 标志，不含 O_DIRECT 与 O_CLOEXEC。
+ * @param direct 输入为是否尝试 O_DIRECT，文件系统不支持（open 返回 EINVAL）时去掉 O_DIRECT 重新打开并置为 false。
+ * @return 文件描述符，失败返回 -1 并设置 errno。
+ */
+static int openFile(const std::string &filePath, int flags, bool &direct)
+{
+    if (direct)
+    {
+        int fd = open(filePath.c_str(), flags | O_DIRECT | O_CLOEXEC, 0644);
+        if (fd >= 0 || EINVAL != errno) return fd;
+
+        direct = false;
+    }
+
+
+    return open(filePath.c_str(), flags | O_CLOEXEC, 0644);
+}
+
+/**
+ * @brief 使用 pread / pwrite 同步读写文件的一段区间。
+ * @param fd 文件描述符。
+ * @param buffer 内存缓冲区。
+ * @param bytes 请求的字节数。
+ * @param offset 文件偏移。
+ * @param write true 为写，false 为读。
+ * @param required 至少需要传输的字节数，读取时遇到文件末尾且已传输 required 字节视为成功，用于 O_DIRECT 下按对齐长度读取文件末尾。
+ * @return 成功返回 0，失败返回 errno，未传输够 required 字节就到达文件末尾返回 EIO。
+ */
+static int syncTransfer(int fd, char *buffer, size_t bytes, uint64_t offset, bool write, size_t required)
+{
+    size_t done = 0;
+    while (done < bytes)
+    {
+        ssize_t result = write ? pwrite(fd, buffer + done, bytes - done, static_cast<off_t>(offset + done)) : pread(fd, buffer + done, bytes - done, static_cast<off_t>(offset + done));
+        if (result < 0)
+        {
+            if (EINTR == errno) continue;
+
+            return errno;
+        }
+
+        if (0 == result) return done >= required ? 0 : EIO;
+
+        done += static_cast<size_t>(result);
+    }
+
+
+    return 0;
+}
+
+/**
+ * @brief 按选项的后端读写文件的一段区间：IoUring 后端拆分为多个在途请求，否则同步读写。
+ * @return 成功返回 0，失败返回 errno。
+ */
+static int transfer(int fd, char *buffer, size_t bytes, uint64_t offset, bool write, const LIoOptions &options, size_t blockSize)
+{
+    if (0 == bytes) return 0;
+    if (LIoBackend::IoUring != LBlockIo::effectiveBackend(options)) return syncTransfer(fd, buffer, bytes, offset, write, bytes);
+
+    // 函数执行逻辑：
+    // 1. 复用当前线程缓存的 io_uring 实例，只在首次使用或队列深度变化时创建，省去每次读写的 io_uring_setup 与 mmap。
+    //    创建失败（如超出 RLIMIT_MEMLOCK 或 ENOMEM）时改用 pread / pwrite。
+    // 2. 整段读写是一次性的，缓冲区每次不同，使用普通读写请求而不注册固定缓冲区：注册与注销的两次系统调用抵消了固定缓冲区省下的开销。
+    // 3. 请求以 EINVAL / EOPNOTSUPP 失败（内核不支持该操作）时整段改用 pread / pwrite 重做，按偏移读写可以安全地重做。
+    // 4. 读写中途抛出异常时可能仍有请求在途，丢弃该实例，下次重新创建。
+    thread_local std::unique_ptr<LIoUring> ring;
+    thread_local unsigned int ringDepth = 0;
+    if (!ring || ringDepth != options.queueDepth)
+    {
+        ring.reset();
+        try
+        {
+            ring = std::make_unique<LIoUring>(options.queueDepth);
+        }
+        catch (const std::exception &)
+        {
+            return syncTransfer(fd, buffer, bytes, offset, write, bytes);
+        }
+        ringDepth = options.queueDepth;
+    }
+
+    int error = 0;
+    try
+    {
+        error = transferRange(*ring, fd, buffer, bytes, offset, write, blockSize);
+    }
+    catch (...)
+    {
+        ring.reset();
+
+        throw;
+    }
+
+    if (EINVAL == error || EOPNOTSUPP == error) error = syncTransfer(fd, buffer, bytes, offset, write, bytes);
+
+
+    return error;
+}
+
+#endif
+
+
+LIoBackend LBlockIo::effectiveBackend(const LIoOptions &options)
+{
+    if (LIoBackend::IoUring == options.backend && LIoUring::available()) return LIoBackend::IoUring;
+
+
+    return LIoBackend::Stream;
+}
+
+void LBlockIo::readRange(const std::string &filePath, void *buffer, size_t bytes, uint64_t offset, const LIoOptions &options)
+{
+    if (0 == bytes) return;
+
+#ifdef L_OS_LINUX
+
+    // 函数执行逻辑：
+    // 1. 使用 O_DIRECT、页缓存提示或 IoUring 后端时通过文件描述符读取，O_DIRECT 仅在缓冲区地址与文件偏移都已对齐时使用。
+    //    开启页缓存提示时以 POSIX_FADV_SEQUENTIAL 加大预读。
+    // 2. O_DIRECT 下请求长度也必须对齐：对齐的主体部分直接读入目标缓冲区，末尾不足一个对齐单位的部分按整个对齐单位读入中转缓冲区，
+    //    文件在此结束时内核返回实际剩余的字节数，再复制需要的部分。
+    // 3. 否则使用文件流读取。
+    bool direct = options.direct && 0 == reinterpret_cast<uintptr_t>(buffer) % directAlignment && 0 == offset % directAlignment;
+    if (direct || options.cacheHints || LIoBackend::IoUring == effectiveBackend(options))
+    {
+        int fd = openFile(filePath, O_RDONLY, direct);
+        if (fd < 0) throw std::runtime_error(errorMessage("Failed to open", filePath, errno));
+
+        if (options.cacheHints) posix_fadvise(fd, static_cast<off_t>(offset), static_cast<off_t>(bytes), POSIX_FADV_SEQUENTIAL);
+
+        size_t body = direct ? alignDown(bytes) : bytes;
+        size_t blockSize = direct ? alignUp(options.blockSize) : options.blockSize;
+
+        int error = 0;
+        try
+        {
+            error = transfer(fd, static_cast<char *>(buffer), body, offset, false, options, blockSize);
+
+            if (0 == error && body < bytes)
+            {
+                std::shared_ptr<char> tail = allocateBlocks(1, directAlignment);
+                error = syncTransfer(fd, tail.get(), directAlignment, offset + body, false, bytes - body);
+                if (0 == error) std::memcpy(static_cast<char *>(buffer) + body, tail.get(), bytes - body);
+            }
+        }
+        catch (...)
+        {
+            close(fd);
+
+            throw;
+        }
+
+        close(fd);
+        if (0 != error) throw std::runtime_error(errorMessage("Failed to read", filePath, error));
+
+        return;
+    }
+
+#endif
+
+    std::ifstream ifs(filePath, std::ios::binary);
+    if (!ifs) throw std::runtime_error("Failed to open " + filePath + ".");
+
+    ifs.seekg(static_cast<std::streamoff>(offset));
+    ifs.read(static_cast<char *>(buffer), static_cast<std::streamsize>(bytes));
+    if (!ifs) throw std::runtime_error("Failed to read " + filePath + ".");
+}
+
+void LBlockIo::writeFile(const std::string &filePath, const void *buffer, size_t bytes, const LIoOptions &options)
+{
+#ifdef L_OS_LINUX
+
+    // 函数执行逻辑：
+    // 1. 使用 O_DIRECT、页缓存提示或 IoUring 后端时通过文件描述符写出，O_DIRECT 仅在缓冲区地址已对齐时使用。
+    // 2. O_DIRECT 下对齐的主体部分直接从源缓冲区写出，末尾不足一个对齐单位的部分复制到补零的中转缓冲区，写满一个对齐单位后将文件截断到实际长度。
+    // 3. 开启页缓存提示时，写出完成后立即发起整个文件的异步写回，不等待其完成。
+    // 4. 否则使用文件流写出。任何一步失败都删除不完整的文件。
+    bool direct = options.direct && 0 == reinterpret_cast<uintptr_t>(buffer) % directAlignment;
+    if (direct || options.cacheHints || LIoBackend::IoUring == effectiveBackend(options))
+    {
+        int fd = openFile(filePath, O_WRONLY | O_CREAT | O_TRUNC, direct);
+        if (fd < 0) throw std::runtime_error(errorMessage("Failed to create", filePath, errno));
+
+        char *data = static_cast<char *>(const_cast<void *>(buffer));
+        size_t body = direct ? alignDown(bytes) : bytes;
+        size_t blockSize = direct ? alignUp(options.blockSize) : options.blockSize;
+
+        int error = 0;
+        try
+        {
+            error = transfer(fd, data, body, 0, true, options, blockSize);
+
+            if (0 == error && body < bytes)
+            {
+                std::shared_ptr<char> tail = allocateBlocks(1, directAlignment);
+                std::memset(tail.get(), 0, directAlignment);
+                std::memcpy(tail.get(), data + body, bytes - body);
+
+                error = syncTransfer(fd, tail.get(), directAlignment, body, true, directAlignment);
+                if (0 == error && 0 != ftruncate(fd, static_cast<off_t>(bytes))) error = errno;
+            }
+
+            if (0 == error && options.cacheHints) sync_file_range(fd, 0, 0, SYNC_FILE_RANGE_WRITE);
+        }
+        catch (...)
+        {
+            close(fd);
+            std::remove(filePath.c_str());
+
+            throw;
+        }
+
+        if (0 != close(fd) && 0 == error) error = errno;
+        if (0 != error)
+        {
+            std::remove(filePath.c_str());
+
+            throw std::runtime_error(errorMessage("Failed to write", filePath, error));
+        }
+
+        return;
+    }
+
+#endif
+
+    std::ofstream ofs(filePath, std::ios::binary);
+    ofs.write(static_cast<const char *>(buffer), static_cast<std::streamsize>(bytes));
+    ofs.close();
+
+    if (!ofs)
+    {
+        std::remove(filePath.c_str());
+
+        throw std::runtime_error("Failed to write " + filePath + ".");
+    }
+}
+
+
+LBlockReader::LBlockReader(const std::string &filePath, const LIoOptions &options) : m_options(options)
+{
+    // 函数执行逻辑：
+    // 1. 不使用 IoUring 后端、O_DIRECT 与页缓存提示时：打开文件流，分配一个块缓冲区。
+    // 2. 否则打开文件描述符并取得大小，O_DIRECT 下块大小向上对齐，开启页缓存提示时以 POSIX_FADV_SEQUENTIAL 加大预读。
+    //    没有 io_uring 实例时分配一个块缓冲区，next() 中同步 pread。
+    // 3. IoUring 后端：分配 queueDepth 个块缓冲区并注册为固定缓冲区，然后为每个缓冲区提交一个读请求，
+    //    第 i 个缓冲区读取第 i 块。之后每个缓冲区被 next() 返回并消费完毕后，立即用于读取 queueDepth 块之后的那一块。
+    m_options.backend = LBlockIo::effectiveBackend(options);
+    m_options.blockSize = std::max<size_t>(1, options.blockSize);
+    m_options.queueDepth = std::max(1u, options.queueDepth);
+
+#ifdef L_OS_LINUX
+
+    if (m_options.direct || m_options.cacheHints || LIoBackend::IoUring == m_options.backend)
+    {
+        m_fd = openFile(filePath, O_RDONLY, m_options.direct);
+        if (m_fd < 0) throw std::runtime_error(errorMessage("Failed to open", filePath, errno));
+
+        struct stat st;
+        if (0 != fstat(m_fd, &st))
+        {
+            int error = errno;
+            ::close(m_fd);
+
+            throw std::runtime_error(errorMessage("Failed to stat", filePath, error));
+        }
+        m_fileSize = static_cast<uint64_t>(st.st_size);
+
+        if (m_options.cacheHints) posix_fadvise(m_fd, 0, 0, POSIX_FADV_SEQUENTIAL);
+        if (m_options.direct) m_options.blockSize = alignUp(m_options.blockSize);
+
+        // io_uring 实例创建失败（如超出 RLIMIT_MEMLOCK 或 ENOMEM）时退化为同步读写。
+        if (LIoBackend::IoUring == m_options.backend)
+        {
+            try
+            {
+                m_ring = std::make_unique<LIoUring>(m_options.queueDepth);
+            }
+            catch (const std::exception &)
+            {
+                m_options.backend = LIoBackend::Stream;
+            }
+        }
+
+        size_t slotCount = LIoBackend::IoUring == m_options.backend ? m_options.queueDepth : 1;
+        m_memory = allocateBlocks(slotCount, m_options.blockSize);
+        m_slots.resize(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) m_slots[i].buffer = m_memory.get() + i * m_options.blockSize;
+
+        if (LIoBackend::Stream == m_options.backend) return;
+
+        std::vector<std::pair<void *, size_t>> buffers;
+        for (const Slot &slot : m_slots) buffers.emplace_back(slot.buffer, m_options.blockSize);
+        m_fixed = m_ring->registerBuffers(buffers);
+
+        for (size_t i = 0; i < m_slots.size(); ++i) submitSlot(i);
+        m_ring->submit();
+
+        return;
+    }
+
+#endif
+
+    m_options.direct = false;
+    m_options.cacheHints = false;
+    m_memory = allocateBlocks(1, m_options.blockSize);
+    m_slots.resize(1);
+    m_slots[0].buffer = m_memory.get();
+
+    m_stream.open(filePath, std::ios::binary);
+    if (!m_stream) throw std::runtime_error("Failed to open " + filePath + ".");
+}
+
+LBlockReader::~LBlockReader()
+{
+#ifdef L_OS_LINUX
+
+    if (m_ring)
+    {
+        // 缓冲区释放前必须收割所有在途请求。
+        try
+        {
+            while (std::any_of(m_slots.begin(), m_slots.end(), [](const Slot &slot) { return slot.pending; })) reapOne();
+        }
+        catch (...)
+        {
+        }
+        m_ring.reset();
+    }
+
+    if (m_fd >= 0) ::close(m_fd);
+
+#endif
+}
+
+size_t LBlockReader::next(const char *&data)
+{
+    data = nullptr;
+
+    if (m_fd < 0)
+    {
+        m_stream.read(m_slots[0].buffer, static_cast<std::streamsize>(m_options.blockSize));
+        if (m_stream.bad()) throw std::runtime_error("Failed to read block.");
+
+        data = m_slots[0].buffer;
+
+
+        return static_cast<size_t>(m_stream.gcount());
+    }
+
+#ifdef L_OS_LINUX
+
+    if (!m_ring)
+    {
+        Slot &slot = m_slots[0];
+        if (m_returned) releaseSlot(0);
+        m_returned = false;
+
+        submitSlot(0);
+        if (!slot.pending) return 0;
+
+        int error = syncTransfer(m_fd, slot.buffer, slot.length, slot.offset, false, slot.bytes);
+        slot.pending = false;
+        if (0 != error) throw std::runtime_error(std::string("Failed to read block: ") + std::strerror(error));
+
+        data = slot.buffer;
+        m_returned = true;
+
+
+        return slot.bytes;
+    }
+
+#endif
+
+    // 上一次返回的槽位已被调用者消费完毕，用它读取后续的块。
+    if (m_returned)
+    {
+        size_t previous = (m_current + m_slots.size() - 1) % m_slots.size();
+        releaseSlot(previous);
+        submitSlot(previous);
+        m_ring->submit();
+        m_returned = false;
+    }
+
+    Slot &slot = m_slots[m_current];
+    if (!slot.pending && 0 == slot.bytes) return 0;
+
+    while (slot.pending) reapOne();
+
+    data = slot.buffer;
+    m_current = (m_current + 1) % m_slots.size();
+    m_returned = true;
+
+
+    return slot.bytes;
+}
+
+void LBlockReader::releaseSlot(size_t slot)
+{
+#ifdef L_OS_LINUX
+
+    // 归并游标之后的数据不会再被读取，尽早归还页缓存。
+    const Slot &s = m_slots[slot];
+    if (m_options.cacheHints && s.bytes > 0) posix_fadvise(m_fd, static_cast<off_t>(s.offset), static_cast<off_t>(s.bytes), POSIX_FADV_DONTNEED);
+
+#else
+
+    (void)slot;
+
+#endif
+}
+
+void LBlockReader::submitSlot(size_t slot)
+{
+    Slot &s = m_slots[slot];
+    s.bytes = 0;
+    s.filled = 0;
+    s.pending = false;
+
+    if (m_nextOffset >= m_fileSize) return;
+
+    // O_DIRECT 下最后一块的请求长度向上对齐，内核只返回文件实际剩余的字节数。块大小已对齐，请求长度不会超过缓冲区。
+    s.offset = m_nextOffset;
+    s.bytes = static_cast<size_t>(std::min<uint64_t>(m_options.blockSize, m_fileSize - m_nextOffset));
+    s.length = m_options.direct ? alignUp(s.bytes) : s.bytes;
+    s.pending = true;
+    m_nextOffset += s.bytes;
+
+    if (m_ring) m_ring->prepareRead(m_fd, s.buffer, static_cast<unsigned int>(s.length), s.offset, slot, m_fixed ? static_cast<int>(slot) : -1);
+}
+
+void LBlockReader::reapOne()
+{
+    uint64_t slot;
+    int result;
+    m_ring->waitCompletion(slot, result);
+
+    Slot &s = m_slots[slot];
+    if (result <= 0)
+    {
+        s.pending = false;
+
+        throw std::runtime_error(std::string("Failed to read block: ") + std::strerror(result < 0 ? -result : EIO));
+    }
+
+    // 短读时补交剩余部分，此时槽位仍保持在途状态。
+    s.filled += static_cast<size_t>(result);
+    if (s.filled < s.bytes)
+    {
+        m_ring->prepareRead(m_fd, s.buffer + s.filled, static_cast<unsigned int>(s.length - s.filled), s.offset + s.filled, slot, m_fixed ? static_cast<int>(slot) : -1);
+        m_ring->submit();
+
+        return;
+    }
+
+    s.pending = false;
+}
+
+
+LBlockWriter::LBlockWriter(const std::string &filePath, const LIoOptions &options) : m_filePath(filePath), m_options(options)
+{
+    // 函数执行逻辑：
+    // 1. 不使用 IoUring 后端、O_DIRECT 与页缓存提示时：直接打开文件流，write() 交给文件流缓冲。
+    // 2. 否则创建文件描述符，O_DIRECT 下块大小向上对齐。write() 将数据复制到当前缓冲区，缓冲区写满后写出并切换到下一个缓冲区。
+    // 3. IoUring 后端：分配 queueDepth 个块缓冲区并注册为固定缓冲区，写满的块立即提交写请求，最多 queueDepth 个块同时在途；
+    //    没有 io_uring 实例时只分配一个块缓冲区，写满后同步 pwrite。开启页缓存提示时每块写完后立即发起异步写回。
+    m_options.backend = LBlockIo::effectiveBackend(options);
+    m_options.blockSize = std::max<size_t>(1, options.blockSize);
+    m_options.queueDepth = std::max(1u, options.queueDepth);
+
+#ifdef L_OS_LINUX
+
+    if (m_options.direct || m_options.cacheHints || LIoBackend::IoUring == m_options.backend)
+    {
+        m_fd = openFile(filePath, O_WRONLY | O_CREAT | O_TRUNC, m_options.direct);
+        if (m_fd < 0) throw std::runtime_error(errorMessage("Failed to create", filePath, errno));
+
+        if (m_options.direct) m_options.blockSize = alignUp(m_options.blockSize);
+
+        // io_uring 实例创建失败（如超出 RLIMIT_MEMLOCK 或 ENOMEM）时退化为同步读写。
+        if (LIoBackend::IoUring == m_options.backend)
+        {
+            try
+            {
+                m_ring = std::make_unique<LIoUring>(m_options.queueDepth);
+            }
+            catch (const std::exception &)
+            {
+                m_options.backend = LIoBackend::Stream;
+            }
+        }
+
+        size_t slotCount = LIoBackend::IoUring == m_options.backend ? m_options.queueDepth : 1;
+        m_memory = allocateBlocks(slotCount, m_options.blockSize);
+        m_slots.resize(slotCount);
+        for (size_t i = 0; i < slotCount; ++i) m_slots[i].buffer = m_memory.get() + i * m_options.blockSize;
+
+        if (LIoBackend::Stream == m_options.backend) return;
+
+        std::vector<std::pair<void *, size_t>> buffers;
+        for (const Slot &slot : m_slots) buffers.emplace_back(slot.buffer, m_options.blockSize);
+        m_fixed = m_ring->registerBuffers(buffers);
+
+        return;
+    }
+
+#endif
+
+    m_options.direct = false;
+    m_options.cacheHints = false;
+
+    m_stream.open(filePath, std::ios::binary);
+    if (!m_stream) throw std::runtime_error("Failed to create " + filePath + ".");
+}
+
+LBlockWriter::~LBlockWriter()
+{
+    if (m_closed) return;
+
+#ifdef L_OS_LINUX
+
+    if (m_ring)
+    {
+        try
+        {
+            drain();
+        }
+        catch (...)
+        {
+        }
+        m_ring.reset();
+    }
+
+    if (m_fd >= 0) ::close(m_fd);
+
+#endif
+}
+
+void LBlockWriter::write(const void *data, size_t bytes)
+{
+    if (m_fd < 0)
+    {
+        m_stream.write(static_cast<const char *>(data), static_cast<std::streamsize>(bytes));
+        if (!m_stream) throw std::runtime_error("Failed to write " + m_filePath + ".");
+
+        return;
+    }
+
+    const char *source = static_cast<const char *>(data);
+    while (bytes > 0)
+    {
+        Slot &slot = m_slots[m_current];
+        size_t count = std::min(bytes, m_options.blockSize - slot.bytes);
+        std::memcpy(slot.buffer + slot.bytes, source, count);
+
+        slot.bytes += count;
+        source += count;
+        bytes -= count;
+
+        if (slot.bytes == m_options.blockSize) flushCurrent();
+    }
+}
+
+void LBlockWriter::close()
+{
+    if (m_closed) return;
+    m_closed = true;
+
+    if (m_fd < 0)
+    {
+        m_stream.close();
+        if (!m_stream) throw std::runtime_error("Failed to write " + m_filePath + ".");
+
+        return;
+    }
+
+#ifdef L_OS_LINUX
+
+    try
+    {
+        flushCurrent();
+        drain();
+    }
+    catch (...)
+    {
+        try
+        {
+            drain();
+        }
+        catch (...)
+        {
+        }
+        ::close(m_fd);
+
+        throw;
+    }
+
+    // O_DIRECT 下最后一块补零写满了对齐长度，截断到实际长度。
+    if (m_options.direct && 0 == m_error && 0 != m_offset % LBlockIo::directAlignment && 0 != ftruncate(m_fd, static_cast<off_t>(m_offset))) m_error = errno;
+
+    if (0 != ::close(m_fd) && 0 == m_error) m_error = errno;
+    if (0 != m_error) throw std::runtime_error(errorMessage("Failed to write", m_filePath, m_error));
+
+#endif
+}
+
+void LBlockWriter::flushCurrent()
+{
+    Slot &slot = m_slots[m_current];
+    if (slot.bytes > 0)
+    {
+        slot.offset = m_offset;
+        slot.written = 0;
+        slot.pending = true;
+        m_offset += slot.bytes;
+
+        // O_DIRECT 要求请求长度对齐，不完整的最后一块补零。
+        if (m_options.direct && 0 != slot.bytes % LBlockIo::directAlignment)
+        {
+            size_t length = alignUp(slot.bytes);
+            std::memset(slot.buffer + slot.bytes, 0, length - slot.bytes);
+            slot.bytes = length;
+        }
+
+#ifdef L_OS_LINUX
+
+        if (!m_ring)
+        {
+            int error = syncTransfer(m_fd, slot.buffer, slot.bytes, slot.offset, true, slot.bytes);
+            if (0 != error && 0 == m_error) m_error = error;
+            if (0 == error) startWriteback(m_current);
+            slot.pending = false;
+            slot.bytes = 0;
+
+            if (0 != m_error) throw std::runtime_error(errorMessage("Failed to write", m_filePath, m_error));
+
+            return;
+        }
+
+#endif
+
+        m_ring->prepareWrite(m_fd, slot.buffer, static_cast<unsigned int>(slot.bytes), slot.offset, m_current, m_fixed ? static_cast<int>(m_current) : -1);
+        m_ring->submit();
+
+        m_current = (m_current + 1) % m_slots.size();
+    }
+
+    // 下一个缓冲区可能仍在写回，等待其完成后才能复用。
+    Slot &next = m_slots[m_current];
+    while (next.pending) reapOne();
+    next.bytes = 0;
+
+    if (0 != m_error) throw std::runtime_error(errorMessage("Failed to write", m_filePath, m_error));
+}
+
+void LBlockWriter::reapOne()
+{
+    uint64_t slot;
+    int result;
+    m_ring->waitCompletion(slot, result);
+
+    Slot &s = m_slots[slot];
+    if (result <= 0)
+    {
+        if (0 == m_error) m_error = result < 0 ? -result : EIO;
+        s.pending = false;
+
+        return;
+    }
+
+    // 短写时补交剩余部分。
+    s.written += static_cast<size_t>(result);
+    if (s.written < s.bytes)
+    {
+        m_ring->prepareWrite(m_fd, s.buffer + s.written, static_cast<unsigned int>(s.bytes - s.written), s.offset + s.written, slot, m_fixed ? static_cast<int>(slot) : -1);
+        m_ring->submit();
+
+        return;
+    }
+
+    s.pending = false;
+    startWriteback(slot);
+}
+
+void LBlockWriter::drain()
+{
+    while (std::any_of(m_slots.begin(), m_slots.end(), [](const Slot &slot) { return slot.pending; })) reapOne();
+}
+
+void LBlockWriter::startWriteback(size_t slot)
+{
+#ifdef L_OS_LINUX
+
+    // 只发起写回不等待，脏页随写出进度平稳地下刷，而不是堆积到内核阈值后集中刷盘。
+    const Slot &s = m_slots[slot];
+    if (m_options.cacheHints) sync_file_range(m_fd, static_cast<off_t>(s.offset), static_cast<off_t>(s.bytes), SYNC_FILE_RANGE_WRITE);
+
+#else
+
+    (void)slot;
+
+#endif
+}
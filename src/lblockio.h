@@ -0,0 +1,319 @@
+/**
+ * @file lblockio.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 按块读写文件的类头文件。
+ * @details 排序器的所有磁盘读写都按大块进行，这里提供两种后端：
+ * 1. Stream：使用 std::ifstream / std::ofstream，可移植，每次只有一个请求在途。
+ * 2. IoUring：使用 io_uring，一个文件同时保持多个块的读写请求在途，缓冲区注册为固定缓冲区。仅 Linux 可用，不可用时自动退化为 Stream。
+ * LBlockIo 提供一次性读取文件区间、写出整个文件的静态方法；LBlockReader 与 LBlockWriter 以流的方式顺序读写，并在后台预读与写回，用于归并。
+ * 两种后端都可以选择以 O_DIRECT 打开文件绕过页缓存，或者作为更轻量的替代，向内核提供页缓存提示（均仅 Linux），此时 Stream 后端改用 pread / pwrite 同步读写。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LBLOCKIO_H_
+#define _LBLOCKIO_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <fstream>
+#include <memory>
+#include <string>
+#include <vector>
+
+
+class LIoUring;
+
+
+/**
+ * @brief 块读写后端。
+ */
+enum class LIoBackend
+{
+    Stream = 0,
+    IoUring
+};
+
+
+/**
+ * @struct LIoOptions
+ * @brief 块读写选项。
+ */
+struct LIoOptions
+{
+    /**
+     * @brief 期望使用的后端，IoUring 不可用时退化为 Stream。
+     */
+    LIoBackend backend = LIoBackend::Stream;
+
+    /**
+     * @brief 单个读写请求的字节数。按元素读取时需为元素大小的整数倍，LBlockReader 每次返回的块才由完整的元素组成，排序器会自动取整。
+     */
+    size_t blockSize = 1 << 20;
+
+    /**
+     * @brief IoUring 后端下每个文件同时在途的请求数。
+     */
+    unsigned int queueDepth = 8;
+
+    /**
+     * @brief 是否以 O_DIRECT 打开文件，读写绕过页缓存，仅 Linux 有效。
+     * @note 开启后 blockSize 向上取整为 LBlockIo::directAlignment 的整数倍。文件末尾不足一个对齐单位的部分，读取时按整个对齐单位请求，
+     * 写出时补零写满一个对齐单位，关闭前再截断到实际长度。文件系统不支持 O_DIRECT（open 返回 EINVAL）时退化为经过页缓存的读写；
+     * readRange() / writeFile() 的缓冲区地址或文件偏移未对齐时，该次读写同样退化为经过页缓存的读写。
+     */
+    bool direct = false;
+
+    /**
+     * @brief 是否向内核提供页缓存提示，仅 Linux 有效。
+     * @note 开启后读取的文件以 POSIX_FADV_SEQUENTIAL 加大预读；LBlockReader 在调用者消费完一块后以 POSIX_FADV_DONTNEED 丢弃该块的页缓存；
+     * 写出的块完成后立即以 sync_file_range 发起异步写回，避免大量脏页堆积后由内核集中刷盘。
+     */
+    bool cacheHints = false;
+};
+
+
+/**
+ * @class LBlockIo
+ * @brief 提供静态方法按块读写整段文件。
+ */
+class LBlockIo
+{
+
+public:
+
+    /**
+     * @brief O_DIRECT 要求的缓冲区地址、文件偏移与请求长度的对齐字节数，取 4 KiB 以同时满足 512 字节与 4 KiB 扇区的设备。
+     */
+    static constexpr size_t directAlignment = 4096;
+
+    /**
+     * @brief 默认构造函数。
+     */
+    LBlockIo() = default;
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LBlockIo() = default;
+
+    /**
+     * @brief 返回选项实际生效的后端。
+     * @param options 块读写选项。
+     * @return 请求 IoUring 但当前系统不支持时返回 Stream。
+     */
+    static LIoBackend effectiveBackend(const LIoOptions &options);
+
+    /**
+     * @brief 读取文件的一段区间到内存。
+     * @param filePath 文件路径。
+     * @param buffer 目标缓冲区，至少 bytes 字节。
+     * @param bytes 读取的字节数。
+     * @param offset 文件偏移。
+     * @param options 块读写选项。
+     * @note 区间超出文件末尾或读取失败时抛出 std::runtime_error。IoUring 后端将区间拆成 blockSize 大小的请求，最多 queueDepth 个同时在途。
+     * 使用 O_DIRECT 时对齐的主体部分直接读入 buffer，末尾不足一个对齐单位的部分经对齐的中转缓冲区复制。
+     */
+    static void readRange(const std::string &filePath, void *buffer, size_t bytes, uint64_t offset, const LIoOptions &options);
+
+    /**
+     * @brief 将内存写出为文件，文件已存在时覆盖。
+     * @param filePath 文件路径。
+     * @param buffer 源缓冲区。
+     * @param bytes 写出的字节数。
+     * @param options 块读写选项。
+     * @note 写出失败时删除不完整的文件并抛出 std::runtime_error。使用 O_DIRECT 时对齐的主体部分直接从 buffer 写出，末尾不足一个对齐单位的部分补零写出后截断。
+     */
+    static void writeFile(const std::string &filePath, const void *buffer, size_t bytes, const LIoOptions &options);
+};
+
+
+/**
+ * @class LBlockReader
+ * @brief 按块顺序读取文件，IoUring 后端下在后台预读后续的块。
+ *
+ * @note 使用方法
+ *   LBlockReader reader(path, options);
+ *   const char *data;
+ *   while (size_t bytes = reader.next(data)) consume(data, bytes);
+ */
+class LBlockReader
+{
+
+public:
+
+    /**
+     * @brief 构造函数，打开文件并开始预读。
+     * @param filePath 文件路径。
+     * @param options 块读写选项。
+     * @note 文件打开失败时抛出 std::runtime_error。
+     */
+    LBlockReader(const std::string &filePath, const LIoOptions &options);
+
+    /**
+     * @brief 析构函数，等待在途请求完成后关闭文件。
+     */
+    virtual ~LBlockReader();
+
+    LBlockReader(const LBlockReader &other) = delete;
+    LBlockReader &operator=(const LBlockReader &other) = delete;
+
+    /**
+     * @brief 返回下一块数据。
+     * @param data 输出参数，指向块数据，在下一次调用 next() 前有效。
+     * @return 块的字节数，除最后一块外均为 blockSize，到达文件末尾返回 0。
+     * @note 读取失败时抛出 std::runtime_error。
+     */
+    size_t next(const char *&data);
+
+
+private:
+
+    /**
+     * @brief 开启页缓存提示时丢弃调用者已消费完的槽位所在区间的页缓存。
+     * @param slot 槽位下标。
+     */
+    void releaseSlot(size_t slot);
+
+    /**
+     * @brief 为槽位安排下一块并提交读请求（没有 io_uring 实例时只安排，由调用者同步读取），文件已全部安排时不做任何事。
+     * @param slot 槽位下标。
+     */
+    void submitSlot(size_t slot);
+
+    /**
+     * @brief 收割一个完成事件并记录到对应槽位，短读时补交剩余部分。
+     */
+    void reapOne();
+
+
+private:
+
+    /**
+     * @brief 一个块缓冲区及其在途请求的状态。
+     */
+    struct Slot
+    {
+        char *buffer = nullptr; // 块缓冲区。
+        uint64_t offset = 0;    // 块在文件中的偏移。
+        size_t bytes = 0;       // 块的字节数。
+        size_t length = 0;      // 请求的字节数，O_DIRECT 下为 bytes 向上对齐。
+        size_t filled = 0;      // 已读入的字节数。
+        bool pending = false;   // 是否有在途请求。
+    };
+
+    LIoOptions m_options;              // 块读写选项，backend 为实际生效的后端，direct 为实际是否使用 O_DIRECT。
+    std::ifstream m_stream;            // 不使用文件描述符时的文件流。
+    int m_fd = -1;                     // IoUring 后端、O_DIRECT 或页缓存提示下的文件描述符，没有 io_uring 实例时同步 pread。
+    uint64_t m_fileSize = 0;           // 文件字节数。
+    uint64_t m_nextOffset = 0;         // 下一块待提交读请求的偏移。
+    std::unique_ptr<LIoUring> m_ring;  // IoUring 后端的 io_uring 实例。
+    bool m_fixed = false;              // 缓冲区是否已注册为固定缓冲区。
+    std::vector<Slot> m_slots;         // 块缓冲区，按文件顺序循环使用。
+    size_t m_current = 0;              // 下一次 next() 返回的槽位。
+    bool m_returned = false;           // 上一次 next() 是否返回了某个槽位，需在本次调用时回收。没有 io_uring 实例时即槽位 0。
+    std::shared_ptr<char> m_memory;    // 所有块缓冲区的内存。
+};
+
+
+/**
+ * @class LBlockWriter
+ * @brief 按块顺序写出文件，IoUring 后端下在后台写回已填满的块。
+ *
+ * @note 使用方法
+ *   LBlockWriter writer(path, options);
+ *   writer.write(data, bytes);
+ *   writer.close();
+ */
+class LBlockWriter
+{
+
+public:
+
+    /**
+     * @brief 构造函数，创建或覆盖文件。
+     * @param filePath 文件路径。
+     * @param options 块读写选项。
+     * @note 文件创建失败时抛出 std::runtime_error。
+     */
+    LBlockWriter(const std::string &filePath, const LIoOptions &options);
+
+    /**
+     * @brief 析构函数，未调用 close() 时等待在途请求完成后关闭文件，不抛出异常。
+     */
+    virtual ~LBlockWriter();
+
+    LBlockWriter(const LBlockWriter &other) = delete;
+    LBlockWriter &operator=(const LBlockWriter &other) = delete;
+
+    /**
+     * @brief 追加写入数据。
+     * @param data 数据。
+     * @param bytes 字节数。
+     * @note 写出失败时抛出 std::runtime_error。
+     */
+    void write(const void *data, size_t bytes);
+
+    /**
+     * @brief 写出剩余数据，等待所有请求完成并关闭文件。
+     * @note 写出失败时抛出 std::runtime_error。
+     */
+    void close();
+
+
+private:
+
+    /**
+     * @brief 提交当前槽位的写请求并切换到下一个槽位，下一个槽位仍在途时等待其完成。没有 io_uring 实例时同步写出。
+     * @note O_DIRECT 下不完整的块（只会是最后一块）补零到对齐长度后写出，由 close() 截断。
+     */
+    void flushCurrent();
+
+    /**
+     * @brief 收割一个完成事件，短写时补交剩余部分。
+     */
+    void reapOne();
+
+    /**
+     * @brief 等待所有在途请求完成。
+     */
+    void drain();
+
+    /**
+     * @brief 开启页缓存提示时为已写出的槽位所在区间发起异步写回。
+     * @param slot 槽位下标。
+     */
+    void startWriteback(size_t slot);
+
+
+private:
+
+    /**
+     * @brief 一个块缓冲区及其在途请求的状态。
+     */
+    struct Slot
+    {
+        char *buffer = nullptr; // 块缓冲区。
+        uint64_t offset = 0;    // 块在文件中的偏移。
+        size_t bytes = 0;       // 块中待写出的字节数。
+        size_t written = 0;     // 已写出的字节数。
+        bool pending = false;   // 是否有在途请求。
+    };
+
+    std::string m_filePath;            // 文件路径。
+    LIoOptions m_options;              // 块读写选项，backend 为实际生效的后端，direct 为实际是否使用 O_DIRECT。
+    std::ofstream m_stream;            // 不使用文件描述符时的文件流。
+    int m_fd = -1;                     // IoUring 后端、O_DIRECT 或页缓存提示下的文件描述符，没有 io_uring 实例时同步 pwrite。
+    uint64_t m_offset = 0;             // 下一块在文件中的偏移，即已写入数据的实际长度。
+    std::unique_ptr<LIoUring> m_ring;  // IoUring 后端的 io_uring 实例。
+    bool m_fixed = false;              // 缓冲区是否已注册为固定缓冲区。
+    std::vector<Slot> m_slots;         // 块缓冲区，循环使用。
+    size_t m_current = 0;              // 正在填充的槽位。
+    int m_error = 0;                   // 第一个失败请求的 errno。
+    bool m_closed = false;             // 是否已关闭。
+    std::shared_ptr<char> m_memory;    // 所有块缓冲区的内存。
+};
+
+
+#endif
@@ -0,0 +1,58 @@
+/**
+ * @file lcancellationtoken.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 协作式取消令牌类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lcancellationtoken.h"
+
+
+LCancelledError::LCancelledError(const std::string &message, bool deadlineExceeded) : std::runtime_error(message), m_deadlineExceeded(deadlineExceeded)
+{
+}
+
+bool LCancelledError::deadlineExceeded() const
+{
+    return m_deadlineExceeded;
+}
+
+
+LCancellationToken::LCancellationToken() : m_state(std::make_shared<State>())
+{
+}
+
+void LCancellationToken::cancel()
+{
+    m_state->cancelled.store(true, std::memory_order_release);
+}
+
+void LCancellationToken::setDeadline(Clock::time_point deadline)
+{
+    m_state->deadline.store(deadline.time_since_epoch().count(), std::memory_order_release);
+}
+
+void LCancellationToken::setTimeout(Clock::duration timeout)
+{
+    setDeadline(Clock::now() + timeout);
+}
+
+bool LCancellationToken::isCancelled() const
+{
+    if (m_state->cancelled.load(std::memory_order_acquire)) return true;
+
+    // 没有设置截止时间时不读取时钟。
+    Clock::rep deadline = m_state->deadline.load(std::memory_order_acquire);
+    if (Clock::duration::max().count() == deadline) return false;
+
+
+    return Clock::now().time_since_epoch().count() >= deadline;
+}
+
+void LCancellationToken::throwIfCancelled() const
+{
+    if (m_state->cancelled.load(std::memory_order_acquire)) throw LCancelledError("Operation cancelled.", false);
+    if (isCancelled()) throw LCancelledError("Deadline exceeded.", true);
+}
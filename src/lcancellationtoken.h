@@ -0,0 +1,132 @@
+/**
+ * @file lcancellationtoken.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 协作式取消令牌类头文件。
+ * @details LCancellationToken 在多个线程之间共享一个取消标志与一个可选的截止时间。令牌的副本共享同一份状态：调用方保留一份副本，把另一份交给长时间运行的任务，任务在循环中定期检查 isCancelled() 或调用 throwIfCancelled()，收到取消请求或超过截止时间后尽快抛出 LCancelledError 并清理现场。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LCANCELLATIONTOKEN_H_
+#define _LCANCELLATIONTOKEN_H_
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+
+/**
+ * @class LCancelledError
+ * @brief 任务被取消或超过截止时间时抛出的异常。
+ */
+class LCancelledError : public std::runtime_error
+{
+
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param message 异常信息。
+     * @param deadlineExceeded 是否因超过截止时间而取消。
+     */
+    LCancelledError(const std::string &message, bool deadlineExceeded);
+
+    /**
+     * @brief 是否因超过截止时间而取消。
+     * @return 超时返回 true，主动取消返回 false。
+     */
+    bool deadlineExceeded() const;
+
+
+private:
+
+    /**
+     * @brief 是否因超过截止时间而取消。
+     */
+    bool m_deadlineExceeded = false;
+};
+
+
+/**
+ * @class LCancellationToken
+ * @brief 可在线程间共享的协作式取消令牌，支持截止时间。
+ *
+ * @note 使用方法
+ *   LCancellationToken token;
+ *   token.setTimeout(std::chrono::minutes(10)); // 可选的截止时间。
+ *   auto result = std::async([&sorter, token] { sorter.run(path, token); });
+ *   ...
+ *   token.cancel(); // 数据已过期，请求任务尽快停止。
+ */
+class LCancellationToken
+{
+
+public:
+
+    /**
+     * @brief 时钟类型，截止时间使用单调时钟，不受系统时间调整影响。
+     */
+    using Clock = std::chrono::steady_clock;
+
+    /**
+     * @brief 构造函数，创建一份新的、未取消且没有截止时间的状态。
+     */
+    LCancellationToken();
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LCancellationToken() = default;
+
+    /**
+     * @brief 请求取消，所有共享该状态的副本都会看到。
+     */
+    void cancel();
+
+    /**
+     * @brief 设置截止时间，到达后视为已取消。
+     * @param deadline 截止时间。
+     */
+    void setDeadline(Clock::time_point deadline);
+
+    /**
+     * @brief 设置从现在起的超时时间，等价于 setDeadline(Clock::now() + timeout)。
+     * @param timeout 超时时间。
+     */
+    void setTimeout(Clock::duration timeout);
+
+    /**
+     * @brief 是否已被取消或超过截止时间。
+     * @return 已取消返回 true。
+     * @note 设置了截止时间时每次调用读取一次单调时钟，在紧凑循环中应每隔若干次迭代调用一次。
+     */
+    bool isCancelled() const;
+
+    /**
+     * @brief 已被取消或超过截止时间时抛出 LCancelledError。
+     */
+    void throwIfCancelled() const;
+
+
+private:
+
+    /**
+     * @brief 副本之间共享的状态。
+     */
+    struct State
+    {
+        std::atomic<bool> cancelled{false};                               // 是否已请求取消。
+        std::atomic<Clock::rep> deadline{Clock::duration::max().count()}; // 截止时间距时钟纪元的计数，最大值表示没有截止时间。
+    };
+
+    /**
+     * @brief 共享状态。
+     */
+    std::shared_ptr<State> m_state;
+};
+
+
+#endif
@@ -0,0 +1,259 @@
+/**
+ * @file lcputopology.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief CPU 拓扑类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lcputopology.h"
+
+#include "lglobalmacros.h"
+
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <cmath>
+#include <cctype>
+
+#ifdef L_OS_LINUX
+#include <sched.h>
+#include <pthread.h>
+#include <dirent.h>
+#endif
+
+
+/**
+ * @brief 读取文件的第一行。
+ * @param filePath 文件路径。
+ * @param line 读取结果。
+ * @return 成功返回 true。
+ */
+static bool readFirstLine(const std::string &filePath, std::string &line)
+{
+    std::ifstream ifs(filePath);
+    if (!ifs) return false;
+
+
+    return static_cast<bool>(std::getline(ifs, line));
+}
+
+/**
+ * @brief 读取文件中的一个整数。
+ * @param filePath 文件路径。
+ * @param defaultValue 读取失败时的默认值。
+ * @return 读取到的整数。
+ */
+static int readInt(const std::string &filePath, int defaultValue)
+{
+    std::ifstream ifs(filePath);
+    int value = defaultValue;
+    if (!(ifs >> value)) return defaultValue;
+
+
+    return value;
+}
+
+
+std::vector<int> LCpuTopology::availableCpus()
+{
+    std::vector<int> cpus;
+
+#ifdef L_OS_LINUX
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (0 == sched_getaffinity(0, sizeof(set), &set))
+        for (int i = 0; i < CPU_SETSIZE; ++i)
+            if (CPU_ISSET(i, &set)) cpus.push_back(i);
+
+#endif
+
+    // 获取失败或非 Linux 平台，退化为 [0, hardware_concurrency)。
+    if (cpus.empty())
+    {
+        unsigned int count = std::max(1u, std::thread::hardware_concurrency());
+        for (unsigned int i = 0; i < count; ++i) cpus.push_back(static_cast<int>(i));
+    }
+
+
+    return cpus;
+}
+
+double LCpuTopology::cgroupCpuQuota()
+{
+#ifdef L_OS_LINUX
+
+    // 找到当前进程所在的 cgroup 路径。v2 的行形如 "0::/path"，v1 的 cpu 控制器行形如 "N:cpu,cpuacct:/path"。
+    std::string v2Path = "/";
+    std::string v1Path = "/";
+    {
+        std::ifstream ifs("/proc/self/cgroup");
+        std::string line;
+        while (std::getline(ifs, line))
+        {
+            size_t first = line.find(':');
+            size_t second = line.find(':', first + 1);
+            if (std::string::npos == first || std::string::npos == second) continue;
+
+            std::string controllers = line.substr(first + 1, second - first - 1);
+            std::string path = line.substr(second + 1);
+
+            if (controllers.empty()) v2Path = path;
+
+            std::stringstream ss(controllers);
+            std::string controller;
+            while (std::getline(ss, controller, ','))
+                if ("cpu" == controller) v1Path = path;
+        }
+    }
+
+    // cgroup v2：cpu.max 内容为 "$MAX $PERIOD"，$MAX 为 "max" 表示不限制。
+    for (const std::string &dir : {"/sys/fs/cgroup" + v2Path, std::string("/sys/fs/cgroup")})
+    {
+        std::string line;
+        if (!readFirstLine(dir + "/cpu.max", line)) continue;
+
+        std::stringstream ss(line);
+        std::string quota;
+        double period = 0;
+        ss >> quota >> period;
+        if ("max" == quota || period <= 0) return 0;
+
+
+        return std::stod(quota) / period;
+    }
+
+    // cgroup v1：cpu.cfs_quota_us 为 -1 表示不限制。
+    for (const std::string &dir : {"/sys/fs/cgroup/cpu" + v1Path, "/sys/fs/cgroup/cpu,cpuacct" + v1Path, std::string("/sys/fs/cgroup/cpu")})
+    {
+        int quota = readInt(dir + "/cpu.cfs_quota_us", 0);
+        int period = readInt(dir + "/cpu.cfs_period_us", 0);
+        if (0 == quota && 0 == period) continue;
+        if (quota <= 0 || period <= 0) return 0;
+
+
+        return static_cast<double>(quota) / period;
+    }
+
+#endif
+
+
+    return 0;
+}
+
+size_t LCpuTopology::recommendedThreadCount()
+{
+    size_t count = availableCpus().size();
+
+    double quota = cgroupCpuQuota();
+    if (quota > 0) count = std::min(count, static_cast<size_t>(std::ceil(quota)));
+
+
+    return std::max<size_t>(1, count);
+}
+
+std::vector<LCpuInfo> LCpuTopology::topology()
+{
+    std::vector<LCpuInfo> infos;
+
+    for (int cpu : availableCpus())
+    {
+        LCpuInfo info;
+        info.cpu = cpu;
+
+#ifdef L_OS_LINUX
+
+        std::string cpuDir = "/sys/devices/system/cpu/cpu" + std::to_string(cpu);
+
+        info.package = std::max(0, readInt(cpuDir + "/topology/physical_package_id", 0));
+        info.l3Group = info.package;
+
+        // NUMA 节点以 cpuN/nodeM 子目录的形式给出。
+        if (DIR *dir = opendir(cpuDir.c_str()))
+        {
+            while (dirent *entry = readdir(dir))
+            {
+                std::string name = entry->d_name;
+                if (name.size() > 4 && 0 == name.compare(0, 4, "node") && std::all_of(name.begin() + 4, name.end(), ::isdigit))
+                {
+                    info.numaNode = std::stoi(name.substr(4));
+                    break;
+                }
+            }
+            closedir(dir);
+        }
+
+        // 在 cache/indexK 中找到 level 为 3 的缓存，以共享该缓存的最小 CPU 编号作为分组编号。
+        for (int index = 0;; ++index)
+        {
+            std::string cacheDir = cpuDir + "/cache/index" + std::to_string(index);
+            int level = readInt(cacheDir + "/level", -1);
+            if (-1 == level) break;
+            if (3 != level) continue;
+
+            std::string sharedList;
+            if (readFirstLine(cacheDir + "/shared_cpu_list", sharedList))
+            {
+                std::vector<int> shared = parseCpuList(sharedList);
+                if (!shared.empty()) info.l3Group = *std::min_element(shared.begin(), shared.end());
+            }
+            break;
+        }
+
+#endif
+
+        infos.push_back(info);
+    }
+
+    std::sort(infos.begin(), infos.end(), [](const LCpuInfo &a, const LCpuInfo &b) {
+        if (a.numaNode != b.numaNode) return a.numaNode < b.numaNode;
+        if (a.l3Group != b.l3Group) return a.l3Group < b.l3Group;
+        return a.cpu < b.cpu;
+    });
+
+
+    return infos;
+}
+
+bool LCpuTopology::pinCurrentThread(int cpu)
+{
+#ifdef L_OS_LINUX
+
+    if (cpu < 0 || cpu >= CPU_SETSIZE) return false;
+
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    CPU_SET(cpu, &set);
+
+
+    return 0 == pthread_setaffinity_np(pthread_self(), sizeof(set), &set);
+
+#endif
+
+
+    return false;
+}
+
+std::vector<int> LCpuTopology::parseCpuList(const std::string &cpuList)
+{
+    std::vector<int> cpus;
+
+    std::stringstream ss(cpuList);
+    std::string range;
+    while (std::getline(ss, range, ','))
+    {
+        if (range.empty() || !::isdigit(static_cast<unsigned char>(range[0]))) continue;
+
+        size_t dash = range.find('-');
+        int first = std::stoi(range.substr(0, dash));
+        int last = std::string::npos == dash ? first : std::stoi(range.substr(dash + 1));
+
+        for (int cpu = first; cpu <= last; ++cpu) cpus.push_back(cpu);
+    }
+
+
+    return cpus;
+}
@@ -0,0 +1,107 @@
+/**
+ * @file lcputopology.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief CPU 拓扑类头文件。
+ * @details LCpuTopology 提供静态方法读取当前进程可用的 CPU 集合（sched_getaffinity）、cgroup CPU 配额，以及每个 CPU 所属的物理封装、NUMA 节点和共享 L3 缓存分组（读取 /sys/devices/system/cpu）。线程池据此确定线程数量，并将工作线程按拓扑顺序绑定到 CPU 上。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LCPUTOPOLOGY_H_
+#define _LCPUTOPOLOGY_H_
+
+#include <string>
+#include <vector>
+
+
+/**
+ * @struct LCpuInfo
+ * @brief 单个逻辑 CPU 的拓扑信息。
+ */
+struct LCpuInfo
+{
+    /**
+     * @brief 逻辑 CPU 编号。
+     */
+    int cpu = 0;
+
+    /**
+     * @brief 物理封装（插槽）编号，未知时为 0。
+     */
+    int package = 0;
+
+    /**
+     * @brief NUMA 节点编号，未知时为 0。
+     */
+    int numaNode = 0;
+
+    /**
+     * @brief 共享 L3 缓存分组编号，取共享该 L3 的最小 CPU 编号，未知时等于封装编号。
+     */
+    int l3Group = 0;
+};
+
+
+/**
+ * @class LCpuTopology
+ * @brief 提供静态方法查询 CPU 拓扑与绑定线程。
+ */
+class LCpuTopology
+{
+
+public:
+
+    /**
+     * @brief 默认构造函数。
+     */
+    LCpuTopology() = default;
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LCpuTopology() = default;
+
+    /**
+     * @brief 返回当前进程允许运行的 CPU 编号列表。
+     * @return CPU 编号列表，升序。
+     * @note Linux 下通过 sched_getaffinity 获取，其他平台返回 [0, hardware_concurrency)。
+     */
+    static std::vector<int> availableCpus();
+
+    /**
+     * @brief 返回 cgroup 限制的 CPU 配额（可使用的 CPU 数，可能为小数）。
+     * @return CPU 配额，未设置限制时返回 0。
+     * @note 依次尝试 cgroup v2 的 cpu.max 与 cgroup v1 的 cpu.cfs_quota_us / cpu.cfs_period_us。
+     */
+    static double cgroupCpuQuota();
+
+    /**
+     * @brief 返回推荐的计算线程数量。
+     * @return 可用 CPU 数与 cgroup 配额（向上取整）中的较小值，至少为 1。
+     */
+    static size_t recommendedThreadCount();
+
+    /**
+     * @brief 返回所有可用 CPU 的拓扑信息。
+     * @return 按 (NUMA 节点, L3 分组, CPU 编号) 排序的拓扑信息，相邻元素尽量共享缓存与内存节点。
+     */
+    static std::vector<LCpuInfo> topology();
+
+    /**
+     * @brief 将当前线程绑定到指定 CPU。
+     * @param cpu CPU 编号。
+     * @return 成功返回 true，失败或平台不支持返回 false。
+     */
+    static bool pinCurrentThread(int cpu);
+
+    /**
+     * @brief 解析内核 cpulist 格式的字符串，例如 "0-3,8,10-11"。
+     * @param cpuList cpulist 字符串。
+     * @return 解析出的 CPU 编号列表。
+     */
+    static std::vector<int> parseCpuList(const std::string &cpuList);
+};
+
+
+#endif
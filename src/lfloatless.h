@@ -0,0 +1,104 @@
+/**
+ * @file lfloatless.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 浮点数全序比较器头文件。
+ * @details std::less 对 NaN 不构成严格弱序，-0.0 与 +0.0 相等，排序含 NaN 的数据时结果未定义；浮点数的比较也比整数慢。
+ * LFloatKey 将 float / double 的位模式一一映射为保序的无符号整数键：符号位为 0 时置位符号位，为 1 时按位取反，得到 IEEE 754 的 totalOrder，
+ * 再整体减去负 NaN 的个数，使负 NaN 从键空间的最低端绕到最高端。映射是双射，解码得到逐位相同的原值。键的顺序为：
+ * -inf < 负数 < -0.0 < +0.0 < 正数 < +inf < 正 NaN < 负 NaN，同号的 NaN 按负载（尾数）排列。
+ * LFloatLess 按键比较，排序器识别出它后块排序改为对键做基数排序，归并堆中只缓存整数键。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LFLOATLESS_H_
+#define _LFLOATLESS_H_
+
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <type_traits>
+
+
+/**
+ * @struct LFloatKey
+ * @brief float / double 与保序无符号整数键之间的双射。
+ * @tparam F float 或 double。
+ */
+template <typename F>
+struct LFloatKey
+{
+    static_assert((std::is_same<F, float>::value || std::is_same<F, double>::value) && std::numeric_limits<F>::is_iec559, "LFloatKey requires an IEEE 754 float or double.");
+
+    /**
+     * @brief 键类型，与 F 等宽的无符号整数。
+     */
+    using Bits = std::conditional_t<sizeof(F) == sizeof(uint32_t), uint32_t, uint64_t>;
+
+    /**
+     * @brief 符号位。
+     */
+    static constexpr Bits signBit = Bits(1) << (8 * sizeof(Bits) - 1);
+
+    /**
+     * @brief 负 NaN 的个数：符号位为 1、指数全 1、尾数非 0 的位模式，totalOrder 下它们占据键空间最低的一段。
+     */
+    static constexpr Bits negativeNaNs = (Bits(1) << (std::numeric_limits<F>::digits - 1)) - 1;
+
+    /**
+     * @brief 将浮点数编码为键。
+     */
+    static Bits encode(F value)
+    {
+        Bits bits;
+        std::memcpy(&bits, &value, sizeof(bits));
+
+
+        return ((bits & signBit) ? ~bits : (bits | signBit)) - negativeNaNs;
+    }
+
+    /**
+     * @brief 将键解码为浮点数，与 encode() 互逆。
+     */
+    static F decode(Bits key)
+    {
+        Bits order = key + negativeNaNs;
+        Bits bits = (order & signBit) ? (order & ~signBit) : ~order;
+
+        F value;
+        std::memcpy(&value, &bits, sizeof(value));
+
+
+        return value;
+    }
+};
+
+
+/**
+ * @struct LFloatLess
+ * @brief 按 LFloatKey 的键比较浮点数的全序比较器，NaN 与 ±0.0 的位置见文件说明。
+ * @tparam F float 或 double。
+ *
+ * @note 使用方法
+ *   LBasicSorter<double, LFloatLess<double>> sorter(&pool, options); // 与 LBasicSorter<double> 相同。
+ */
+template <typename F>
+struct LFloatLess
+{
+    bool operator()(F a, F b) const
+    {
+        return LFloatKey<F>::encode(a) < LFloatKey<F>::encode(b);
+    }
+};
+
+
+/**
+ * @brief 元素类型的默认比较器：float 与 double 为 LFloatLess，其他类型为 std::less。
+ */
+template <typename T>
+using LDefaultLess = std::conditional_t<std::is_same<T, float>::value || std::is_same<T, double>::value, LFloatLess<T>, std::less<T>>;
+
+
+#endif
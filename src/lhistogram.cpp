@@ -0,0 +1,124 @@
+/**
+ * @file lhistogram.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 无锁直方图类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lhistogram.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+
+double LHistogramSnapshot::mean() const
+{
+    if (0 == count) return 0;
+
+
+    return static_cast<double>(sum) / count;
+}
+
+uint64_t LHistogramSnapshot::percentile(double percent) const
+{
+    if (0 == count) return 0;
+
+    // 目标排名取上整，至少为 1，然后沿桶累加计数找到排名所在的桶。
+    percent = std::min(100.0, std::max(0.0, percent));
+    uint64_t rank = std::max<uint64_t>(1, static_cast<uint64_t>(std::ceil(percent / 100 * count)));
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < buckets.size(); ++i)
+    {
+        seen += buckets[i];
+        if (seen >= rank) return std::min(max, std::max(min, LHistogram::bucketUpperBound(i)));
+    }
+
+
+    return max;
+}
+
+
+LHistogram::LHistogram() : m_count(0), m_sum(0), m_min(std::numeric_limits<uint64_t>::max()), m_max(0)
+{
+    for (auto &bucket : m_buckets) bucket.store(0, std::memory_order_relaxed);
+}
+
+void LHistogram::record(uint64_t value)
+{
+    m_buckets[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    m_count.fetch_add(1, std::memory_order_relaxed);
+    m_sum.fetch_add(value, std::memory_order_relaxed);
+
+    // 最值只在确实变化时才进行 CAS，稳定之后的记录只有一次读取。
+    uint64_t current = m_min.load(std::memory_order_relaxed);
+    while (value < current && !m_min.compare_exchange_weak(current, value, std::memory_order_relaxed));
+
+    current = m_max.load(std::memory_order_relaxed);
+    while (value > current && !m_max.compare_exchange_weak(current, value, std::memory_order_relaxed));
+}
+
+LHistogramSnapshot LHistogram::snapshot() const
+{
+    LHistogramSnapshot result;
+
+    result.buckets.resize(bucketCount);
+    for (size_t i = 0; i < bucketCount; ++i) result.buckets[i] = m_buckets[i].load(std::memory_order_relaxed);
+
+    // 个数以桶的计数之和为准，保证分位数计算与桶一致。
+    for (uint64_t bucket : result.buckets) result.count += bucket;
+    result.sum = m_sum.load(std::memory_order_relaxed);
+
+    if (result.count > 0)
+    {
+        result.min = m_min.load(std::memory_order_relaxed);
+        result.max = m_max.load(std::memory_order_relaxed);
+    }
+
+
+    return result;
+}
+
+size_t LHistogram::bucketIndex(uint64_t value)
+{
+    // 函数执行逻辑：
+    // 1. 小于子桶数量的值直接以值为下标；
+    // 2. 否则取最高位所在的量级，右移到只保留最高的 subBucketBits + 1 位，得到 [32, 64) 内的子桶值；
+    // 3. 下标为量级偏移乘以子桶数量再加上子桶值，相邻量级的下标首尾相接。
+    constexpr uint64_t subBucketCount = uint64_t(1) << subBucketBits;
+    if (value < subBucketCount) return static_cast<size_t>(value);
+
+    int magnitude = 63;
+    while (!(value >> magnitude & 1)) --magnitude;
+
+    int shift = magnitude - subBucketBits;
+
+
+    return static_cast<size_t>(shift) * subBucketCount + static_cast<size_t>(value >> shift);
+}
+
+uint64_t LHistogram::bucketLowerBound(size_t index)
+{
+    constexpr size_t subBucketCount = size_t(1) << subBucketBits;
+    if (index < subBucketCount) return index;
+
+    size_t shift = index / subBucketCount - 1;
+    uint64_t sub = index - shift * subBucketCount;
+
+
+    return sub << shift;
+}
+
+uint64_t LHistogram::bucketUpperBound(size_t index)
+{
+    constexpr size_t subBucketCount = size_t(1) << subBucketBits;
+    if (index < subBucketCount) return index;
+
+    size_t shift = index / subBucketCount - 1;
+
+
+    return bucketLowerBound(index) + ((uint64_t(1) << shift) - 1);
+}
@@ -0,0 +1,170 @@
+/**
+ * @file lhistogram.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 无锁直方图类头文件。
+ * @details LHistogram 按 HDR Histogram 的对数-线性方式分桶：小于 32 的值每个值一个桶，更大的值按二进制量级分段，每段再均分为 32 个桶，因此任意值的相对误差不超过 1/32，而 64 位取值范围只需约两千个桶。record() 只做几次原子加法，可以在线程池的热路径上为每个任务记录耗时。
+ * snapshot() 返回普通的数据副本 LHistogramSnapshot，可以在其上计算均值与分位数。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LHISTOGRAM_H_
+#define _LHISTOGRAM_H_
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+#include <vector>
+
+
+/**
+ * @struct LHistogramSnapshot
+ * @brief 直方图某一时刻的数据副本。
+ */
+struct LHistogramSnapshot
+{
+    /**
+     * @brief 记录的值的个数。
+     */
+    uint64_t count = 0;
+
+    /**
+     * @brief 记录的值的总和。
+     */
+    uint64_t sum = 0;
+
+    /**
+     * @brief 记录的最小值，没有记录时为 0。
+     */
+    uint64_t min = 0;
+
+    /**
+     * @brief 记录的最大值，没有记录时为 0。
+     */
+    uint64_t max = 0;
+
+    /**
+     * @brief 每个桶的计数，下标含义见 LHistogram::bucketIndex()。
+     */
+    std::vector<uint64_t> buckets;
+
+    /**
+     * @brief 返回平均值。
+     * @return 平均值，没有记录时为 0。
+     */
+    double mean() const;
+
+    /**
+     * @brief 返回分位数。
+     * @param percent 百分位，取值 [0, 100]，如 99 表示 P99。
+     * @return 分位数所在桶的上界（不超过最大值），没有记录时为 0。
+     */
+    uint64_t percentile(double percent) const;
+};
+
+
+/**
+ * @class LHistogram
+ * @brief 可被多个线程并发写入的对数-线性直方图。
+ *
+ * @note 使用方法
+ *   LHistogram histogram;
+ *   histogram.record(latencyNs);
+ *   LHistogramSnapshot snapshot = histogram.snapshot();
+ *   uint64_t p99 = snapshot.percentile(99);
+ */
+class LHistogram
+{
+
+public:
+
+    /**
+     * @brief 每个二进制量级内的子桶数量的位数，子桶数量为 32。
+     */
+    static constexpr int subBucketBits = 5;
+
+    /**
+     * @brief 桶的总数。
+     */
+    static constexpr size_t bucketCount = (64 - subBucketBits + 1) << subBucketBits;
+
+    /**
+     * @brief 构造函数。
+     */
+    LHistogram();
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LHistogram() = default;
+
+    LHistogram(const LHistogram &other) = delete;
+    LHistogram &operator=(const LHistogram &other) = delete;
+
+    /**
+     * @brief 记录一个值。
+     * @param value 待记录的值。
+     * @note 线程安全，内部只使用 relaxed 原子操作。
+     */
+    void record(uint64_t value);
+
+    /**
+     * @brief 返回当前数据的副本。
+     * @return LHistogramSnapshot 数据副本。
+     * @note 与 record() 并发调用时，副本中各字段可能相差正在记录的少量值。
+     */
+    LHistogramSnapshot snapshot() const;
+
+    /**
+     * @brief 返回值所在桶的下标。
+     * @param value 值。
+     * @return 桶下标，取值 [0, bucketCount)。
+     */
+    static size_t bucketIndex(uint64_t value);
+
+    /**
+     * @brief 返回桶能表示的最小值。
+     * @param index 桶下标。
+     * @return 桶的下界。
+     */
+    static uint64_t bucketLowerBound(size_t index);
+
+    /**
+     * @brief 返回桶能表示的最大值。
+     * @param index 桶下标。
+     * @return 桶的上界。
+     */
+    static uint64_t bucketUpperBound(size_t index);
+
+
+private:
+
+    /**
+     * @brief 每个桶的计数。
+     */
+    std::atomic<uint64_t> m_buckets[bucketCount];
+
+    /**
+     * @brief 记录的值的个数。
+     */
+    std::atomic<uint64_t> m_count;
+
+    /**
+     * @brief 记录的值的总和。
+     */
+    std::atomic<uint64_t> m_sum;
+
+    /**
+     * @brief 记录的最小值。
+     */
+    std::atomic<uint64_t> m_min;
+
+    /**
+     * @brief 记录的最大值。
+     */
+    std::atomic<uint64_t> m_max;
+};
+
+
+#endif
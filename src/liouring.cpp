@@ -0,0 +1,265 @@
+/**
+ * @file liouring.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief io_uring 封装类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "liouring.h"
+
+#include "lglobalmacros.h"
+
+#include <stdexcept>
+#include <string>
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+
+#ifdef L_OS_LINUX
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <sys/uio.h>
+#include <linux/io_uring.h>
+#endif
+
+
+LIoUring::LIoUring(unsigned int entries)
+{
+#ifdef L_OS_LINUX
+
+    // 函数执行逻辑：
+    // 1. io_uring_setup 创建实例，内核在 params 中返回各环内字段的偏移。
+    // 2. 映射提交队列环与完成队列环（内核支持 IORING_FEAT_SINGLE_MMAP 时两者共用一次映射），以及提交队列项数组。
+    // 3. 按偏移取得头、尾、掩码等字段的地址。
+    io_uring_params params;
+    std::memset(&params, 0, sizeof(params));
+
+    m_fd = static_cast<int>(syscall(__NR_io_uring_setup, entries, &params));
+    if (m_fd < 0) throw std::runtime_error(std::string("io_uring_setup failed: ") + std::strerror(errno));
+
+    m_entries = params.sq_entries;
+    m_sqRingSize = params.sq_off.array + params.sq_entries * sizeof(unsigned int);
+    m_cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+    m_sqesSize = params.sq_entries * sizeof(io_uring_sqe);
+
+    bool singleMmap = params.features & IORING_FEAT_SINGLE_MMAP;
+    if (singleMmap) m_sqRingSize = m_cqRingSize = std::max(m_sqRingSize, m_cqRingSize);
+
+    m_sqRing = mmap(nullptr, m_sqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQ_RING);
+    m_cqRing = singleMmap ? m_sqRing : mmap(nullptr, m_cqRingSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_CQ_RING);
+    m_sqes = mmap(nullptr, m_sqesSize, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, m_fd, IORING_OFF_SQES);
+
+    if (MAP_FAILED == m_sqRing || MAP_FAILED == m_cqRing || MAP_FAILED == m_sqes)
+    {
+        int error = errno;
+        if (MAP_FAILED != m_sqes) munmap(m_sqes, m_sqesSize);
+        if (!singleMmap && MAP_FAILED != m_cqRing) munmap(m_cqRing, m_cqRingSize);
+        if (MAP_FAILED != m_sqRing) munmap(m_sqRing, m_sqRingSize);
+        close(m_fd);
+
+        throw std::runtime_error(std::string("io_uring mmap failed: ") + std::strerror(error));
+    }
+
+    char *sq = static_cast<char *>(m_sqRing);
+    m_sqHead = reinterpret_cast<unsigned int *>(sq + params.sq_off.head);
+    m_sqTail = reinterpret_cast<unsigned int *>(sq + params.sq_off.tail);
+    m_sqMask = reinterpret_cast<unsigned int *>(sq + params.sq_off.ring_mask);
+    m_sqArray = reinterpret_cast<unsigned int *>(sq + params.sq_off.array);
+
+    char *cq = static_cast<char *>(m_cqRing);
+    m_cqHead = reinterpret_cast<unsigned int *>(cq + params.cq_off.head);
+    m_cqTail = reinterpret_cast<unsigned int *>(cq + params.cq_off.tail);
+    m_cqMask = reinterpret_cast<unsigned int *>(cq + params.cq_off.ring_mask);
+    m_cqes = cq + params.cq_off.cqes;
+
+#else
+
+    (void)entries;
+
+    throw std::runtime_error("io_uring is only available on Linux.");
+
+#endif
+}
+
+LIoUring::~LIoUring()
+{
+#ifdef L_OS_LINUX
+
+    if (m_fd < 0) return;
+
+    munmap(m_sqes, m_sqesSize);
+    if (m_cqRing != m_sqRing) munmap(m_cqRing, m_cqRingSize);
+    munmap(m_sqRing, m_sqRingSize);
+    close(m_fd);
+
+#endif
+}
+
+bool LIoUring::available()
+{
+    // 函数执行逻辑：
+    // 1. 创建一个单项实例，确认内核支持 io_uring 且未被禁用。
+    // 2. 通过 IORING_REGISTER_PROBE 确认支持本类使用的 READ / WRITE / READ_FIXED / WRITE_FIXED 操作码。
+    //    IORING_OP_READ / WRITE 与探测接口同在 5.6 内核引入，更早的内核探测失败，视为不可用，否则读写请求会以 EINVAL 失败。
+    static const bool result = []() {
+        try
+        {
+            LIoUring ring(1);
+
+#ifdef L_OS_LINUX
+
+            constexpr unsigned int opCount = 256;
+            std::vector<uint64_t> storage((sizeof(io_uring_probe) + opCount * sizeof(io_uring_probe_op)) / sizeof(uint64_t) + 1, 0);
+            io_uring_probe *probe = reinterpret_cast<io_uring_probe *>(storage.data());
+            if (0 != syscall(__NR_io_uring_register, ring.m_fd, IORING_REGISTER_PROBE, probe, opCount)) return false;
+
+            for (unsigned int op : {IORING_OP_READ, IORING_OP_WRITE, IORING_OP_READ_FIXED, IORING_OP_WRITE_FIXED})
+                if (op > probe->last_op || 0 == (probe->ops[op].flags & IO_URING_OP_SUPPORTED)) return false;
+
+#endif
+
+            return true;
+        }
+        catch (const std::exception &)
+        {
+            return false;
+        }
+    }();
+
+
+    return result;
+}
+
+unsigned int LIoUring::entries() const
+{
+    return m_entries;
+}
+
+bool LIoUring::registerBuffers(const std::vector<std::pair<void *, size_t>> &buffers)
+{
+#ifdef L_OS_LINUX
+
+    std::vector<iovec> iovecs;
+    for (const auto &buffer : buffers) iovecs.push_back({buffer.first, buffer.second});
+
+
+    return 0 == syscall(__NR_io_uring_register, m_fd, IORING_REGISTER_BUFFERS, iovecs.data(), static_cast<unsigned int>(iovecs.size()));
+
+#else
+
+    (void)buffers;
+
+
+    return false;
+
+#endif
+}
+
+void LIoUring::prepareRead(int fd, void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex)
+{
+#ifdef L_OS_LINUX
+
+    prepare(bufferIndex < 0 ? IORING_OP_READ : IORING_OP_READ_FIXED, fd, buffer, bytes, offset, userData, bufferIndex);
+
+#endif
+}
+
+void LIoUring::prepareWrite(int fd, const void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex)
+{
+#ifdef L_OS_LINUX
+
+    prepare(bufferIndex < 0 ? IORING_OP_WRITE : IORING_OP_WRITE_FIXED, fd, buffer, bytes, offset, userData, bufferIndex);
+
+#endif
+}
+
+void LIoUring::prepare(int opcode, int fd, const void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex)
+{
+#ifdef L_OS_LINUX
+
+    // 尾指针只由本进程写入，头指针由内核推进，需以 acquire 语义读取。
+    unsigned int tail = *m_sqTail;
+    unsigned int head = __atomic_load_n(m_sqHead, __ATOMIC_ACQUIRE);
+    if (tail - head >= m_entries) throw std::runtime_error("io_uring submission queue is full.");
+
+    unsigned int index = tail & *m_sqMask;
+    io_uring_sqe *sqe = static_cast<io_uring_sqe *>(m_sqes) + index;
+    std::memset(sqe, 0, sizeof(*sqe));
+    sqe->opcode = static_cast<__u8>(opcode);
+    sqe->fd = fd;
+    sqe->addr = reinterpret_cast<uint64_t>(buffer);
+    sqe->len = bytes;
+    sqe->off = offset;
+    sqe->user_data = userData;
+    if (bufferIndex >= 0) sqe->buf_index = static_cast<__u16>(bufferIndex);
+
+    m_sqArray[index] = index;
+
+    // release 语义保证内核看到新的尾指针时，提交队列项已经写好。
+    __atomic_store_n(m_sqTail, tail + 1, __ATOMIC_RELEASE);
+    ++m_toSubmit;
+
+#else
+
+    (void)opcode, (void)fd, (void)buffer, (void)bytes, (void)offset, (void)userData, (void)bufferIndex;
+
+#endif
+}
+
+void LIoUring::submit()
+{
+#ifdef L_OS_LINUX
+
+    while (m_toSubmit > 0)
+    {
+        int submitted = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, m_toSubmit, 0, 0, nullptr, 0));
+        if (submitted < 0)
+        {
+            if (EINTR == errno || EAGAIN == errno) continue;
+
+            throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        }
+
+        m_toSubmit -= std::min<unsigned int>(m_toSubmit, static_cast<unsigned int>(submitted));
+    }
+
+#endif
+}
+
+void LIoUring::waitCompletion(uint64_t &userData, int &result)
+{
+#ifdef L_OS_LINUX
+
+    // 完成队列头只由本进程写入，尾指针由内核推进。队列为空时通过 io_uring_enter 阻塞等待至少一个完成事件。
+    for (;;)
+    {
+        unsigned int head = *m_cqHead;
+        unsigned int tail = __atomic_load_n(m_cqTail, __ATOMIC_ACQUIRE);
+
+        if (head != tail)
+        {
+            const io_uring_cqe *cqe = static_cast<const io_uring_cqe *>(m_cqes) + (head & *m_cqMask);
+            userData = cqe->user_data;
+            result = cqe->res;
+            __atomic_store_n(m_cqHead, head + 1, __ATOMIC_RELEASE);
+
+            return;
+        }
+
+        // 顺带提交尚未提交的请求。
+        int submitted = static_cast<int>(syscall(__NR_io_uring_enter, m_fd, m_toSubmit, 1, IORING_ENTER_GETEVENTS, nullptr, 0));
+        if (submitted < 0 && EINTR != errno && EAGAIN != errno) throw std::runtime_error(std::string("io_uring_enter failed: ") + std::strerror(errno));
+        if (submitted > 0) m_toSubmit -= std::min<unsigned int>(m_toSubmit, static_cast<unsigned int>(submitted));
+    }
+
+#else
+
+    (void)userData, (void)result;
+
+    throw std::runtime_error("io_uring is only available on Linux.");
+
+#endif
+}
@@ -0,0 +1,134 @@
+/**
+ * @file liouring.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief io_uring 封装类头文件。
+ * @details LIoUring 直接通过 io_uring_setup / io_uring_enter / io_uring_register 系统调用使用 io_uring，不依赖 liburing。它只封装排序器需要的最小功能：提交读写请求（可选使用注册缓冲区的 READ_FIXED / WRITE_FIXED）并逐个收割完成事件。
+ * 一个 LIoUring 对象不是线程安全的，应由单个线程独占使用。非 Linux 平台或内核不支持（被 seccomp、io_uring_disabled 禁用）时构造函数抛出异常，调用者应先通过 available() 判断并退化到普通读写。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LIOURING_H_
+#define _LIOURING_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+
+/**
+ * @class LIoUring
+ * @brief 最小化的 io_uring 提交/完成队列封装。
+ *
+ * @note 使用方法
+ *   LIoUring ring(8);
+ *   ring.prepareRead(fd, buffer, size, offset, 0);
+ *   ring.submit();
+ *   uint64_t userData;
+ *   int result;
+ *   ring.waitCompletion(userData, result); // result 为读到的字节数或 -errno。
+ */
+class LIoUring
+{
+
+public:
+
+    /**
+     * @brief 构造函数，创建 io_uring 实例并映射提交队列与完成队列。
+     * @param entries 提交队列深度。
+     * @note 创建失败时抛出 std::runtime_error。
+     */
+    explicit LIoUring(unsigned int entries);
+
+    /**
+     * @brief 析构函数，解除映射并关闭 io_uring 文件描述符。
+     * @note 调用者应在析构前收割所有已提交请求的完成事件，否则内核可能仍在访问缓冲区。
+     */
+    virtual ~LIoUring();
+
+    LIoUring(const LIoUring &other) = delete;
+    LIoUring &operator=(const LIoUring &other) = delete;
+
+    /**
+     * @brief 当前系统是否可以使用 io_uring，且内核支持本类使用的全部读写操作码。
+     * @return 可用返回 true，结果在进程内缓存。
+     */
+    static bool available();
+
+    /**
+     * @brief 返回提交队列深度。
+     */
+    unsigned int entries() const;
+
+    /**
+     * @brief 注册固定缓冲区，之后可以通过缓冲区下标提交 READ_FIXED / WRITE_FIXED 请求，省去每次请求的页表锁定。
+     * @param buffers 缓冲区地址与字节数列表。
+     * @return 成功返回 true。超出 RLIMIT_MEMLOCK 等原因失败时返回 false，调用者应改用普通读写请求。
+     */
+    bool registerBuffers(const std::vector<std::pair<void *, size_t>> &buffers);
+
+    /**
+     * @brief 准备一个读请求。
+     * @param fd 文件描述符。
+     * @param buffer 目标缓冲区。
+     * @param bytes 字节数。
+     * @param offset 文件偏移。
+     * @param userData 完成事件中原样返回的用户数据。
+     * @param bufferIndex 注册缓冲区下标，小于 0 表示不使用注册缓冲区。buffer 必须位于该注册缓冲区内。
+     * @note 提交队列已满时抛出 std::runtime_error，调用者需控制在途请求数不超过 entries()。
+     */
+    void prepareRead(int fd, void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex = -1);
+
+    /**
+     * @brief 准备一个写请求，参数含义同 prepareRead()。
+     */
+    void prepareWrite(int fd, const void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex = -1);
+
+    /**
+     * @brief 将已准备的请求提交给内核。
+     */
+    void submit();
+
+    /**
+     * @brief 等待并取出一个完成事件。
+     * @param userData 请求的用户数据。
+     * @param result 请求结果，成功为传输的字节数，失败为 -errno。
+     */
+    void waitCompletion(uint64_t &userData, int &result);
+
+
+private:
+
+    /**
+     * @brief 准备一个读写请求的公共实现。
+     */
+    void prepare(int opcode, int fd, const void *buffer, unsigned int bytes, uint64_t offset, uint64_t userData, int bufferIndex);
+
+
+private:
+
+    int m_fd = -1;                       // io_uring 文件描述符。
+    unsigned int m_entries = 0;          // 提交队列深度。
+    unsigned int m_toSubmit = 0;         // 已准备尚未提交的请求数。
+
+    void *m_sqRing = nullptr;            // 提交队列环映射。
+    void *m_cqRing = nullptr;            // 完成队列环映射，单次映射时与 m_sqRing 相同。
+    void *m_sqes = nullptr;              // 提交队列项数组映射。
+    size_t m_sqRingSize = 0;
+    size_t m_cqRingSize = 0;
+    size_t m_sqesSize = 0;
+
+    unsigned int *m_sqHead = nullptr;    // 提交队列头，由内核推进。
+    unsigned int *m_sqTail = nullptr;    // 提交队列尾，由本进程推进。
+    unsigned int *m_sqMask = nullptr;
+    unsigned int *m_sqArray = nullptr;
+    unsigned int *m_cqHead = nullptr;    // 完成队列头，由本进程推进。
+    unsigned int *m_cqTail = nullptr;    // 完成队列尾，由内核推进。
+    unsigned int *m_cqMask = nullptr;
+    void *m_cqes = nullptr;              // 完成队列项数组。
+};
+
+
+#endif
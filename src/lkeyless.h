@@ -0,0 +1,86 @@
+/**
+ * @file lkeyless.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 按键比较的记录比较器头文件。
+ * @details 实际的数据文件多为定长记录：一个较短的键加上较长的负载，例如 8 字节的键与 56 到 248 字节的负载。直接排序记录时每次交换、
+ * 每次归并都要搬动整条记录。LKeyLess 以一个取键函数对象描述记录的键，排序器与归并器识别出它后改为只搬动键：
+ * 块排序时排序紧凑的（键，下标）标签，最后按标签一次性重排记录；归并时堆中只缓存各输入当前记录的键与地址，比较只读缓存的键。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LKEYLESS_H_
+#define _LKEYLESS_H_
+
+#include <cstdint>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @struct LKeyLess
+ * @brief 按 KeyOf 取出的键升序比较记录。
+ * @tparam KeyOf 取键函数对象，以 const 记录引用调用，返回可平凡复制、支持 operator< 的键。
+ *
+ * @note 使用方法
+ *   struct Record { uint64_t key; char payload[56]; };
+ *   struct RecordKey { uint64_t operator()(const Record &r) const { return r.key; } };
+ *   LBasicSorter<Record, LKeyLess<RecordKey>> sorter(&pool, options);
+ */
+template <typename KeyOf>
+struct LKeyLess
+{
+    /**
+     * @brief 取键函数对象。
+     */
+    KeyOf keyOf;
+
+    template <typename T>
+    bool operator()(const T &a, const T &b) const
+    {
+        return keyOf(a) < keyOf(b);
+    }
+};
+
+
+/**
+ * @brief 判断比较器是否为 LKeyLess。
+ */
+template <typename Compare>
+struct LIsKeyLess : std::false_type
+{
+};
+
+template <typename KeyOf>
+struct LIsKeyLess<LKeyLess<KeyOf>> : std::true_type
+{
+};
+
+
+/**
+ * @brief 记录 T 在比较器 LKeyLess<KeyOf> 下的键类型。
+ */
+template <typename T, typename KeyOf>
+using LKeyOf = std::decay_t<decltype(std::declval<const KeyOf &>()(std::declval<const T &>()))>;
+
+
+/**
+ * @struct LSortTag
+ * @brief 块排序使用的标签：记录的键与记录在块内的下标。
+ * @note 块大小为 unsigned int，块内记录数不超过 2^32，下标取 32 位。
+ */
+template <typename Key>
+struct LSortTag
+{
+    Key key;        // 记录的键。
+    uint32_t index; // 记录在块内的下标。
+
+    bool operator<(const LSortTag &other) const
+    {
+        return key < other.key;
+    }
+};
+
+
+#endif
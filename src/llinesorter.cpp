@@ -0,0 +1,392 @@
+/**
+ * @file llinesorter.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 文本行排序类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "llinesorter.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <deque>
+#include <filesystem>
+#include <future>
+#include <memory>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+
+/**
+ * @brief 行从 depth 起 8 个字节的大端前缀，不足 8 字节补 0。前缀按无符号整数比较的结果与按字节比较一致。
+ */
+static uint64_t linePrefix(const char *data, size_t length, size_t depth)
+{
+    unsigned char bytes[8] = {0};
+    if (length > depth) std::memcpy(bytes, data + depth, std::min<size_t>(8, length - depth));
+
+    uint64_t prefix = 0;
+    for (unsigned char byte : bytes) prefix = prefix << 8 | byte;
+
+
+    return prefix;
+}
+
+/**
+ * @brief 行的分隔符。
+ */
+static bool isNewline(char c)
+{
+    return '\n' == c;
+}
+
+/**
+ * @brief 比较前 depth 个字节相同、缓存了从 depth 起前缀的两行。
+ */
+template <typename L>
+static bool lineLess(const L &a, const L &b, size_t depth)
+{
+    // 前缀相同且较短的一行在前缀窗口内结束时，它是另一行的前缀，较短者在前。
+    if (a.prefix != b.prefix) return a.prefix < b.prefix;
+
+    size_t from = depth + 8;
+    size_t common = std::min(a.length, b.length);
+    if (common > from)
+    {
+        int result = std::memcmp(a.data + from, b.data + from, common - from);
+        if (0 != result) return result < 0;
+    }
+
+
+    return a.length < b.length;
+}
+
+
+/**
+ * @class LLineSorter::LineSource
+ * @brief 按行读取一个文本归并段。
+ */
+class LLineSorter::LineSource
+{
+public:
+
+    LineSource(const LRun &run, const LIoOptions &options) : m_reader(run, options) {}
+
+    /**
+     * @brief 读取下一行。
+     * @param data 输出参数，行的起始地址，在下一次调用 next() 前有效。
+     * @param length 输出参数，行的字节数，不含换行符。
+     * @return 归并段已读完返回 false。
+     * @note 行位于块内时直接指向块，跨块的行拼接到内部缓冲区中。
+     */
+    bool next(const char *&data, size_t &length)
+    {
+        m_carry.clear();
+        for (;;)
+        {
+            const char *newline = m_pos == m_end ? nullptr : static_cast<const char *>(std::memchr(m_pos, '\n', static_cast<size_t>(m_end - m_pos)));
+            if (newline)
+            {
+                if (m_carry.empty())
+                {
+                    data = m_pos;
+                    length = static_cast<size_t>(newline - m_pos);
+                }
+                else
+                {
+                    m_carry.insert(m_carry.end(), m_pos, newline);
+                    data = m_carry.data();
+                    length = m_carry.size();
+                }
+                m_pos = newline + 1;
+
+                return true;
+            }
+
+            m_carry.insert(m_carry.end(), m_pos, m_end);
+
+            const char *block;
+            size_t bytes = m_reader.next(block);
+            if (0 == bytes)
+            {
+                // 归并段中的每行都以换行符结尾，结尾没有换行符说明文件被截断。
+                if (!m_carry.empty()) throw std::runtime_error("Truncated line run.");
+
+                return false;
+            }
+            m_pos = block;
+            m_end = block + bytes;
+        }
+    }
+
+private:
+
+    LRunReader m_reader;         // 归并段读者。
+    const char *m_pos = nullptr; // 当前块中下一行的起始地址。
+    const char *m_end = nullptr; // 当前块的结束地址。
+    std::vector<char> m_carry;   // 跨块的行。
+};
+
+
+LLineSorter::LLineSorter(LThreadPool *pool, unsigned int chunkSize, unsigned int k) : LLineSorter(pool, sizeOptions(chunkSize, k))
+{
+}
+
+LLineSorter::LLineSorter(LThreadPool *pool, const LSorterOptions &options) : LSorterBase(pool, options, 1, false)
+{
+}
+
+void LLineSorter::run(const std::string &filePath, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 按偏移从输入文件顺序读取，使用输入文件的块读写选项，文件无法打开时抛出异常。
+    // 2. 排序结果经 LBlockWriter 写到 xxx.sorted，失败时删除不完整的结果文件。
+    token.throwIfCancelled();
+
+    StreamReader read = fileReader(filePath);
+
+    std::string finalFilePath = filePath + ".sorted";
+    std::unique_ptr<LBlockWriter> writer;
+    try
+    {
+        writer = std::make_unique<LBlockWriter>(finalFilePath, m_outputIo);
+        streamSort(read, [&writer](const char *data, size_t bytes) { writer->write(data, bytes); }, token);
+        writer->close();
+    }
+    catch (...)
+    {
+        writer.reset();
+        std::remove(finalFilePath.c_str());
+
+        throw;
+    }
+}
+
+void LLineSorter::sortStream(std::istream &input, std::ostream &output, const LCancellationToken &token)
+{
+    streamSort(streamReader(input), streamWriter(output), token);
+}
+
+void LLineSorter::sortStream(int inputFd, int outputFd, const LCancellationToken &token)
+{
+    streamSort(fdReader(inputFd), fdWriter(outputFd), token);
+}
+
+void LLineSorter::streamSort(const StreamReader &read, const StreamWriter &write, const LCancellationToken &token)
+{
+    std::vector<LRun> runs = lineRuns(read, token);
+
+    // 最后一轮归并直接写到输出，只在写出时标记阻塞。无论成功与否都丢弃归并段。
+    try
+    {
+        mergeLines(runs, [&write](const char *data, size_t bytes) {
+            LThreadPool::BlockingScope blocking;
+
+            write(data, bytes);
+        }, token);
+    }
+    catch (...)
+    {
+        for (LRun &run : runs) run.discard();
+
+        throw;
+    }
+    for (LRun &run : runs) run.discard();
+}
+
+std::vector<LRun> LLineSorter::lineRuns(const StreamReader &read, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 由 generateRuns() 驱动读取、块排序与中间归并，这里只提供读取一块与归并一组的方法。
+    // 2. 块的末尾截断到最后一个换行符，之后的半行留到下一块的开头；块内没有换行符时扩大该块直到读到换行符或输入结束。
+    // 3. 块任务排序该块，在内存预算内接管为内存归并段，否则写到临时文件。块内排序是单线程的，同时在途的块数取线程数加一。
+    std::vector<char> carry;
+    bool eof = false;
+    auto readChunk = [&](size_t, int node, const std::string &path) -> ChunkTask {
+        if (eof) return nullptr;
+
+        auto text = std::make_shared<TextBuffer>(LNumaAllocator<char>(node));
+        eof = readTextChunk(read, m_chunkSize, isNewline, carry, *text);
+        if (text->empty()) return nullptr;
+
+
+        return [text, path, &token, this]() {
+            TextBuffer sorted = sortLines(*text, token);
+            TextBuffer().swap(*text);
+
+            size_t bytes = sorted.size();
+            LRun run = m_runStore.adopt(sorted);
+            if (run.empty())
+            {
+                LThreadPool::BlockingScope blocking;
+
+                LBlockIo::writeFile(path, sorted.data(), sorted.size(), m_io);
+                run = LRun(path);
+            }
+
+
+            return SizedRun{run, bytes};
+        };
+    };
+
+    auto mergeGroup = [&token, this](std::vector<LRun> group, size_t bytes, const std::string &path) {
+        LRun output = m_runStore.reserve<char>(bytes, LThreadPool::currentNode());
+        if (output.empty()) output = LRun(path);
+
+
+        return mergeInto(std::move(group), std::move(output), m_io, [&](const std::vector<LRun> &runs, const StreamWriter &write) { mergeLines(runs, write, token); });
+    };
+
+
+    return generateRuns(readChunk, mergeGroup, m_pool->size() + 1, "lines_", ".txt", token);
+}
+
+LLineSorter::TextBuffer LLineSorter::sortLines(const TextBuffer &text, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 扫描换行符，为每行建立描述并载入从 0 起的前缀。
+    // 2. 多键快速排序行描述，只移动 24 字节的描述，不移动行的内容。
+    // 3. 按排好的顺序将每行复制一次到输出缓冲区，每行后补换行符。
+    token.throwIfCancelled();
+
+    std::vector<Line> lines;
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+    while (begin < end)
+    {
+        const char *newline = static_cast<const char *>(std::memchr(begin, '\n', static_cast<size_t>(end - begin)));
+        size_t length = static_cast<size_t>((newline ? newline : end) - begin);
+        lines.push_back({linePrefix(begin, length, 0), begin, length});
+        begin += length + 1;
+    }
+
+    multikeySort(lines.data(), lines.size(), 0);
+
+    token.throwIfCancelled();
+
+    TextBuffer sorted(text.get_allocator());
+    sorted.reserve(text.size() + 1);
+    for (const Line &line : lines)
+    {
+        sorted.insert(sorted.end(), line.data, line.data + line.length);
+        sorted.push_back('\n');
+    }
+
+
+    return sorted;
+}
+
+void LLineSorter::multikeySort(Line *lines, size_t count, size_t depth)
+{
+    // 函数执行逻辑：
+    // 1. 行数较少时按缓存的前缀与剩余字节直接插入排序。
+    // 2. 否则取三个前缀的中位数为枢轴，按前缀三路划分为小于、等于、大于三段，小于与大于两段在同一深度递归。
+    // 3. 等于段中在当前前缀窗口内结束的行彼此只差末尾补 0 的位置，按长度排在前面；其余的行前进 8 个字节，重新载入前缀后继续循环。
+
+    // 少于该行数时插入排序。
+    constexpr size_t insertionSize = 16;
+
+    while (count > 1)
+    {
+        if (count < insertionSize)
+        {
+            for (size_t i = 1; i < count; ++i)
+                for (size_t j = i; j > 0 && lineLess(lines[j], lines[j - 1], depth); --j) std::swap(lines[j], lines[j - 1]);
+
+            return;
+        }
+
+        uint64_t a = lines[0].prefix, b = lines[count / 2].prefix, c = lines[count - 1].prefix;
+        uint64_t pivot = std::max(std::min(a, b), std::min(std::max(a, b), c));
+
+        size_t lt = 0, i = 0, gt = count;
+        while (i < gt)
+        {
+            if (lines[i].prefix < pivot) std::swap(lines[lt++], lines[i++]);
+            else if (lines[i].prefix > pivot) std::swap(lines[i], lines[--gt]);
+            else ++i;
+        }
+
+        multikeySort(lines, lt, depth);
+        multikeySort(lines + gt, count - gt, depth);
+
+        Line *equal = lines + lt;
+        Line *equalEnd = lines + gt;
+        Line *rest = std::partition(equal, equalEnd, [depth](const Line &line) { return line.length <= depth + 8; });
+        std::sort(equal, rest, [](const Line &x, const Line &y) { return x.length < y.length; });
+
+        depth += 8;
+        for (Line *line = rest; line < equalEnd; ++line) line->prefix = linePrefix(line->data, line->length, depth);
+
+        lines = rest;
+        count = static_cast<size_t>(equalEnd - rest);
+    }
+}
+
+void LLineSorter::mergeLines(const std::vector<LRun> &inputs, const StreamWriter &emit, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 只有一个输入时直接按块输出。
+    // 2. 否则每个输入的当前行以（前缀，地址，长度）放入小根堆，前缀不同时不访问行的内容。
+    // 3. 取出堆顶行追加到批缓冲区，再读该输入的下一行压入堆；批缓冲区满 m_io.blockSize 字节时输出，并检查取消令牌。
+    if (1 == inputs.size())
+    {
+        LRunReader reader(inputs[0], m_io);
+        const char *block;
+        while (size_t bytes = reader.next(block))
+        {
+            token.throwIfCancelled();
+            emit(block, bytes);
+        }
+
+        return;
+    }
+
+    struct Node
+    {
+        uint64_t prefix;  // 从 0 起的前缀。
+        const char *data; // 行的起始地址。
+        size_t length;    // 行的字节数。
+        size_t index;     // 来源输入的下标。
+    };
+    auto greater = [](const Node &x, const Node &y) { return lineLess(y, x, 0); };
+    std::priority_queue<Node, std::vector<Node>, decltype(greater)> heap(greater);
+
+    std::vector<std::unique_ptr<LineSource>> sources;
+    for (size_t i = 0; i < inputs.size(); ++i)
+    {
+        sources.push_back(std::make_unique<LineSource>(inputs[i], m_io));
+
+        const char *data;
+        size_t length;
+        if (sources[i]->next(data, length)) heap.push({linePrefix(data, length, 0), data, length, i});
+    }
+
+    std::vector<char> batch;
+    batch.reserve(m_io.blockSize);
+    while (!heap.empty())
+    {
+        Node node = heap.top();
+        heap.pop();
+        batch.insert(batch.end(), node.data, node.data + node.length);
+        batch.push_back('\n');
+
+        // 行的地址在该输入下一次读取前有效，先复制再读取。
+        const char *data;
+        size_t length;
+        if (sources[node.index]->next(data, length)) heap.push({linePrefix(data, length, 0), data, length, node.index});
+
+        if (batch.size() >= m_io.blockSize)
+        {
+            token.throwIfCancelled();
+            emit(batch.data(), batch.size());
+            batch.clear();
+        }
+    }
+
+    if (!batch.empty()) emit(batch.data(), batch.size());
+}
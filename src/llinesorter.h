@@ -0,0 +1,150 @@
+/**
+ * @file llinesorter.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 文本行排序类头文件。
+ * @details LLineSorter 对以换行符分隔的文本（日志行、ID 列表等）按字节序排序，与 LC_ALL=C sort 的结果一致。
+ * 行是变长的，输入按字节数分块，块的末尾截断到最后一个换行符，剩余的半行并入下一块，比块还长的行使该块扩大到行尾为止。
+ * 每块原样保存在一段连续的字节区中，另建一个行描述数组：行的地址、长度与从当前深度起 8 个字节的大端前缀。
+ * 块内用多键快速排序（multikey quicksort）排序行描述：以 8 字节前缀为一个“字符”做三路划分，前缀相等的部分前进 8 个字节、重新载入前缀后继续，
+ * 绝大多数比较只比较缓存的 64 位整数，不访问字节区。排好序的行按顺序复制一次，作为以换行符结尾的文本归并段留在内存预算内或写到临时文件。
+ * 读取、分块排序与 k 路归并复用 LSorter 流式排序的流程：调用线程顺序读取，线程池并行排序各块，归并段多于 k 个时分轮并行归并，最后一轮直接写到输出。
+ * 归并堆同样缓存每个输入当前行的 8 字节前缀，前缀不同时不访问行的内容。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LLINESORTER_H_
+#define _LLINESORTER_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "lsorter.h"
+
+
+/**
+ * @class LLineSorter
+ * @brief 提供线程池并发的文本行排序功能。
+ * @note 每行以 '\n' 结尾，输入的最后一行没有换行符时输出补上；'\r' 等其他字节都属于行的内容，按无符号字节比较。
+ * 使用 LSorterOptions 的 chunkSize、k、io、directInput、directOutput、tempDirectories、tempPlacement 与 memoryBudget，
+ * compressRuns、mapInput 与 inputReaders 只适用于定长记录，这里忽略。
+ *
+ * @note 使用方法
+ *   LLineSorter sorter(&pool, options);
+ *   sorter.run("access.log"); // 生成 access.log.sorted。
+ */
+class LLineSorter : public LSorterBase
+{
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param pool 外部线程池指针，用于并行排序和归并任务。
+     * @param chunkSize 每块字节数，默认 16 MB。
+     * @param k k 路归并，每轮并行处理的文件数量，默认 8。
+     */
+    LLineSorter(LThreadPool *pool, unsigned int chunkSize = 16 * 1024 * 1024, unsigned int k = 8);
+
+    /**
+     * @brief 构造函数，按选项创建排序器。
+     * @param pool 外部线程池指针，用于并行排序和归并任务。
+     * @param options 排序器构造选项。
+     */
+    LLineSorter(LThreadPool *pool, const LSorterOptions &options);
+
+    /**
+     * @brief 排序文本文件，生成 xxx.sorted 文件。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌，默认永不取消。
+     * @note 文件无法打开或读写失败时抛出 std::runtime_error，取消时抛出 LCancelledError，失败时删除不完整的结果文件与所有临时文件。
+     */
+    void run(const std::string &filePath, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 流式排序：从输入流读取文本，排序后写入输出流。
+     * @param input 输入流，读到末尾为止。
+     * @param output 输出流。
+     * @param token 取消令牌，默认永不取消。
+     * @note 读写失败时抛出 std::runtime_error，取消时抛出 LCancelledError，返回前删除所有临时文件；已写到输出流的数据无法撤回。
+     */
+    void sortStream(std::istream &input, std::ostream &output, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 流式排序，从文件描述符读取、写入文件描述符。
+     * @param inputFd 输入文件描述符。
+     * @param outputFd 输出文件描述符。
+     * @param token 取消令牌，默认永不取消。
+     * @note 行为同上，文件描述符不会被关闭。仅 Linux 可用，其他平台抛出 std::runtime_error。
+     */
+    void sortStream(int inputFd, int outputFd, const LCancellationToken &token = LCancellationToken());
+
+private:
+
+    /**
+     * @brief 文本归并段的字节缓冲区类型。
+     */
+    using TextBuffer = LRunBufferT<char>;
+
+    /**
+     * @brief 块内一行的描述。
+     */
+    struct Line
+    {
+        uint64_t prefix;  // 从当前深度起 8 个字节的大端前缀，不足 8 字节补 0。
+        const char *data; // 行的起始地址，不含换行符。
+        size_t length;    // 行的字节数，不含换行符。
+    };
+
+    /**
+     * @brief 按行读取归并段。
+     */
+    class LineSource;
+
+    /**
+     * @brief 读取整个输入，生成有序的文本归并段并归并到不超过 m_k 个。
+     * @param read 输入函数。
+     * @param token 取消令牌。
+     * @return 不超过 m_k 个归并段，由调用者负责丢弃。失败时已丢弃所有归并段。
+     */
+    std::vector<LRun> lineRuns(const StreamReader &read, const LCancellationToken &token);
+
+    /**
+     * @brief 读取全部输入，排序后交给输出函数，run() 与两个 sortStream() 的共同实现。
+     * @param read 输入函数。
+     * @param write 输出函数。
+     * @param token 取消令牌。
+     */
+    void streamSort(const StreamReader &read, const StreamWriter &write, const LCancellationToken &token);
+
+    /**
+     * @brief 排序一块文本，返回以换行符分隔的有序文本。
+     * @param text 块的字节区，除最后一行外每行以换行符结尾。
+     * @param token 取消令牌。
+     * @return 有序文本，每行以换行符结尾，分配在与 text 相同的 NUMA 节点上。
+     */
+    static TextBuffer sortLines(const TextBuffer &text, const LCancellationToken &token);
+
+    /**
+     * @brief 多键快速排序。
+     * @param lines 行描述数组，前缀须为从 depth 起的前缀，且各行的前 depth 个字节相同。
+     * @param count 行数。
+     * @param depth 当前深度。
+     */
+    static void multikeySort(Line *lines, size_t count, size_t depth);
+
+    /**
+     * @brief 将若干文本归并段按行归并，按批输出。
+     * @param inputs 待归并的归并段列表，不会被丢弃。
+     * @param emit 输出函数，每批约 m_io.blockSize 字节，每批都由完整的行组成。
+     * @param token 取消令牌，每批检查一次。
+     */
+    void mergeLines(const std::vector<LRun> &inputs, const StreamWriter &emit, const LCancellationToken &token);
+};
+
+
+#endif
@@ -0,0 +1,90 @@
+/**
+ * @file lmappedfile.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 只读内存映射文件类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lmappedfile.h"
+
+#include "lglobalmacros.h"
+
+#include <algorithm>
+
+#ifdef L_OS_LINUX
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+
+LMappedFile::LMappedFile(const std::string &filePath, bool populate)
+{
+    // 函数执行逻辑：
+    // 1. 打开文件，只映射非空的普通文件。以 O_NONBLOCK 打开，没有写者的 FIFO 不会阻塞，对普通文件没有影响。
+    // 2. 以 MAP_PRIVATE 只读映射整个文件，映射建立后即可关闭文件描述符。
+    // 3. 未要求预读整个文件时提示内核按顺序访问，加大预读窗口。
+#ifdef L_OS_LINUX
+    int fd = ::open(filePath.c_str(), O_RDONLY | O_CLOEXEC | O_NONBLOCK);
+    if (fd < 0) return;
+
+    struct stat st;
+    if (0 == ::fstat(fd, &st) && S_ISREG(st.st_mode) && st.st_size > 0)
+    {
+        size_t size = static_cast<size_t>(st.st_size);
+        void *data = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+        if (MAP_FAILED != data)
+        {
+            m_data = data;
+            m_size = size;
+            if (!populate) ::madvise(m_data, m_size, MADV_SEQUENTIAL);
+        }
+    }
+
+    ::close(fd);
+#else
+    (void)filePath;
+    (void)populate;
+#endif
+}
+
+LMappedFile::~LMappedFile()
+{
+#ifdef L_OS_LINUX
+    if (m_data) ::munmap(m_data, m_size);
+#endif
+}
+
+bool LMappedFile::isMapped() const
+{
+    return nullptr != m_data;
+}
+
+const char *LMappedFile::data() const
+{
+    return static_cast<const char *>(m_data);
+}
+
+size_t LMappedFile::size() const
+{
+    return m_size;
+}
+
+void LMappedFile::prefetch(size_t offset, size_t bytes) const
+{
+#ifdef L_OS_LINUX
+    if (!m_data || offset >= m_size) return;
+
+    // madvise 要求起始地址按页对齐。
+    size_t page = static_cast<size_t>(::sysconf(_SC_PAGESIZE));
+    size_t begin = offset / page * page;
+    size_t end = std::min(m_size, offset + bytes);
+    ::madvise(static_cast<char *>(m_data) + begin, end - begin, MADV_WILLNEED);
+#else
+    (void)offset;
+    (void)bytes;
+#endif
+}
@@ -0,0 +1,82 @@
+/**
+ * @file lmappedfile.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 只读内存映射文件类头文件。
+ * @details LMappedFile 将整个文件只读映射到进程地址空间，多个线程可以按偏移并发地从映射中复制各自的区间，不需要共享一个顺序读取的文件流。
+ * 只有非空的普通文件才会被映射：管道、字符设备等不支持随机访问或映射，映射失败时对象处于未映射状态，调用者应退化为流式读取。仅 Linux 可用。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LMAPPEDFILE_H_
+#define _LMAPPEDFILE_H_
+
+#include <cstddef>
+#include <string>
+
+
+/**
+ * @class LMappedFile
+ * @brief 只读内存映射文件。
+ *
+ * @note 使用方法
+ *   LMappedFile file(path);
+ *   if (file.isMapped())
+ *   {
+ *       file.prefetch(offset, bytes);
+ *       std::memcpy(buffer, file.data() + offset, bytes);
+ *   }
+ */
+class LMappedFile
+{
+
+public:
+
+    /**
+     * @brief 构造函数，尝试映射文件。
+     * @param filePath 文件路径。
+     * @param populate 是否以 MAP_POPULATE 在映射时预读整个文件，默认 false 表示按 MADV_SEQUENTIAL 提示、访问时缺页读入。
+     * @note 文件无法打开、不是普通文件、为空或映射失败时不抛出异常，isMapped() 返回 false。
+     */
+    explicit LMappedFile(const std::string &filePath, bool populate = false);
+
+    /**
+     * @brief 析构函数，解除映射。
+     */
+    virtual ~LMappedFile();
+
+    LMappedFile(const LMappedFile &other) = delete;
+    LMappedFile &operator=(const LMappedFile &other) = delete;
+
+    /**
+     * @brief 是否映射成功。
+     */
+    bool isMapped() const;
+
+    /**
+     * @brief 返回映射的起始地址，未映射时返回 nullptr。
+     */
+    const char *data() const;
+
+    /**
+     * @brief 返回映射的字节数，即文件大小，未映射时返回 0。
+     */
+    size_t size() const;
+
+    /**
+     * @brief 以 MADV_WILLNEED 提示内核立即开始异步读入一段区间，随后的复制不再逐页缺页等待。
+     * @param offset 区间起始偏移。
+     * @param bytes 区间字节数。
+     */
+    void prefetch(size_t offset, size_t bytes) const;
+
+
+private:
+
+    void *m_data = nullptr; // 映射起始地址。
+    size_t m_size = 0;      // 映射字节数。
+};
+
+
+#endif
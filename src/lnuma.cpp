@@ -0,0 +1,145 @@
+/**
+ * @file lnuma.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief NUMA 内存放置类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lnuma.h"
+
+#include "lglobalmacros.h"
+#include "lcputopology.h"
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#ifdef L_OS_LINUX
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/mempolicy.h>
+#endif
+
+
+bool LNuma::available()
+{
+#ifdef L_OS_LINUX
+
+    // 查询当前线程的默认策略，内核未开启 NUMA 或被 seccomp 禁止时调用失败。
+    static const bool result = []() {
+        int mode = 0;
+        return 0 == syscall(SYS_get_mempolicy, &mode, nullptr, 0, nullptr, 0);
+    }();
+
+
+    return result;
+
+#endif
+
+
+    return false;
+}
+
+int LNuma::nodeCount()
+{
+#ifdef L_OS_LINUX
+
+    static const int result = []() {
+        std::ifstream ifs("/sys/devices/system/node/online");
+        std::string line;
+        if (!std::getline(ifs, line)) return 1;
+
+        std::vector<int> nodes = LCpuTopology::parseCpuList(line);
+        return nodes.empty() ? 1 : 1 + *std::max_element(nodes.begin(), nodes.end());
+    }();
+
+
+    return result;
+
+#endif
+
+
+    return 1;
+}
+
+void *LNuma::allocate(size_t bytes, int node)
+{
+#ifdef L_OS_LINUX
+
+    if (0 == bytes) bytes = 1;
+
+    void *ptr = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (MAP_FAILED == ptr) throw std::bad_alloc();
+
+    // 绑定失败（单节点或内核不支持）不影响使用，只是放置策略退化为默认的 first-touch。
+    if (node >= 0) bindMemory(ptr, bytes, node);
+
+
+    return ptr;
+
+#else
+
+    void *ptr = std::malloc(bytes ? bytes : 1);
+    if (!ptr) throw std::bad_alloc();
+
+
+    return ptr;
+
+#endif
+}
+
+void LNuma::deallocate(void *ptr, size_t bytes)
+{
+    if (!ptr) return;
+
+#ifdef L_OS_LINUX
+
+    munmap(ptr, bytes ? bytes : 1);
+
+#else
+
+    std::free(ptr);
+
+#endif
+}
+
+bool LNuma::bindMemory(void *ptr, size_t bytes, int node)
+{
+#ifdef L_OS_LINUX
+
+    if (node < 0 || node >= nodeCount() || !available()) return false;
+
+    // 节点掩码按 unsigned long 数组传入，maxnode 为掩码的位数。
+    constexpr size_t bitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> mask(1 + node / bitsPerWord, 0);
+    mask[node / bitsPerWord] |= 1UL << (node % bitsPerWord);
+
+
+    return 0 == syscall(SYS_mbind, ptr, bytes, MPOL_PREFERRED, mask.data(), mask.size() * bitsPerWord + 1, 0);
+
+#endif
+
+
+    return false;
+}
+
+int LNuma::nodeOfAddress(const void *ptr)
+{
+#ifdef L_OS_LINUX
+
+    int node = -1;
+    if (0 != syscall(SYS_get_mempolicy, &node, nullptr, 0, const_cast<void *>(ptr), MPOL_F_NODE | MPOL_F_ADDR)) return -1;
+
+
+    return node;
+
+#endif
+
+
+    return -1;
+}
@@ -0,0 +1,157 @@
+/**
+ * @file lnuma.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief NUMA 内存放置类头文件。
+ * @details LNuma 提供静态方法在指定 NUMA 节点上分配内存，以及查询内存页所在节点。实现直接调用 mbind / get_mempolicy 系统调用，不依赖 libnuma。单节点主机或不支持 NUMA 策略的内核上，所有操作退化为普通内存分配。
+ * LNumaAllocator 是对应的 STL 分配器，用于让 std::vector 等容器的缓冲区落在指定节点上。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LNUMA_H_
+#define _LNUMA_H_
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+
+/**
+ * @class LNuma
+ * @brief 提供静态方法进行 NUMA 感知的内存分配。
+ */
+class LNuma
+{
+
+public:
+
+    /**
+     * @brief 默认构造函数。
+     */
+    LNuma() = default;
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LNuma() = default;
+
+    /**
+     * @brief 当前内核是否支持 NUMA 内存策略系统调用。
+     * @return 支持返回 true。
+     */
+    static bool available();
+
+    /**
+     * @brief 返回系统的 NUMA 节点数量。
+     * @return 节点数量，至少为 1。
+     */
+    static int nodeCount();
+
+    /**
+     * @brief 在指定 NUMA 节点上分配内存。
+     * @param bytes 字节数。
+     * @param node 目标节点编号，小于 0 表示不指定节点。
+     * @return 页对齐的内存地址，失败抛出 std::bad_alloc。
+     * @note 使用匿名 mmap 分配后立即以 MPOL_PREFERRED 策略 mbind 到目标节点，此时页尚未被访问，无论之后由哪个线程首次写入（first-touch），物理页都会分配在目标节点上。
+     */
+    static void *allocate(size_t bytes, int node);
+
+    /**
+     * @brief 释放 allocate() 分配的内存。
+     * @param ptr 内存地址。
+     * @param bytes 分配时的字节数。
+     */
+    static void deallocate(void *ptr, size_t bytes);
+
+    /**
+     * @brief 将一段内存的放置策略绑定到指定节点。
+     * @param ptr 内存起始地址，需页对齐。
+     * @param bytes 字节数。
+     * @param node 目标节点编号。
+     * @return 成功返回 true。
+     */
+    static bool bindMemory(void *ptr, size_t bytes, int node);
+
+    /**
+     * @brief 返回地址所在页实际所在的 NUMA 节点。
+     * @param ptr 内存地址，所在页需已被访问过。
+     * @return 节点编号，查询失败返回 -1。
+     */
+    static int nodeOfAddress(const void *ptr);
+};
+
+
+/**
+ * @class LNumaAllocator
+ * @brief 在指定 NUMA 节点上分配内存的 STL 分配器。
+ * @tparam T 元素类型。
+ * @note 节点编号小于 0 时使用按 4 KiB 对齐的 operator new，与指定节点时 mmap 得到的页对齐内存一样满足 O_DIRECT 对缓冲区地址的要求。分配器随容器移动与交换一起传播，不同节点的容器之间可以安全 swap。
+ */
+template <class T>
+class LNumaAllocator
+{
+
+public:
+
+    using value_type = T;
+    using propagate_on_container_copy_assignment = std::true_type;
+    using propagate_on_container_move_assignment = std::true_type;
+    using propagate_on_container_swap = std::true_type;
+
+    /**
+     * @brief 不指定节点时内存地址的对齐字节数。
+     */
+    static constexpr size_t alignment = 4096;
+
+    /**
+     * @brief 构造函数。
+     * @param node 目标 NUMA 节点编号，默认 -1 表示不指定节点。
+     */
+    LNumaAllocator(int node = -1) noexcept : m_node(node) {}
+
+    template <class U>
+    LNumaAllocator(const LNumaAllocator<U> &other) noexcept : m_node(other.node()) {}
+
+    /**
+     * @brief 分配 n 个元素的内存。
+     */
+    T *allocate(size_t n)
+    {
+        if (m_node < 0) return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(alignment)));
+
+
+        return static_cast<T *>(LNuma::allocate(n * sizeof(T), m_node));
+    }
+
+    /**
+     * @brief 释放 n 个元素的内存。
+     */
+    void deallocate(T *ptr, size_t n) noexcept
+    {
+        if (m_node < 0) ::operator delete(ptr, std::align_val_t(alignment));
+        else LNuma::deallocate(ptr, n * sizeof(T));
+    }
+
+    /**
+     * @brief 返回目标 NUMA 节点编号。
+     */
+    int node() const noexcept { return m_node; }
+
+    template <class U>
+    bool operator==(const LNumaAllocator<U> &other) const noexcept { return m_node == other.node(); }
+
+    template <class U>
+    bool operator!=(const LNumaAllocator<U> &other) const noexcept { return m_node != other.node(); }
+
+
+private:
+
+    /**
+     * @brief 目标 NUMA 节点编号。
+     */
+    int m_node = -1;
+};
+
+
+#endif
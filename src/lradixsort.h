@@ -0,0 +1,96 @@
+/**
+ * @file lradixsort.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 无符号整数基数排序类头文件。
+ * @details LRadixSort 对无符号整数键做低位优先（LSD）的按字节基数排序：先一次遍历统计所有字节位的直方图，
+ * 再从最低字节起每个字节位做一次稳定的分配。所有键在某个字节位上都相同时跳过该位，取值集中的数据（例如同号、同量级的浮点数键）只需较少的轮次。
+ * 每轮只有顺序读与按桶的顺序写，没有比较与分支预测失败，元素多时明显快于比较排序。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LRADIXSORT_H_
+#define _LRADIXSORT_H_
+
+#include <array>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+
+
+/**
+ * @class LRadixSort
+ * @brief 无符号整数键的 LSD 基数排序。
+ *
+ * @note 使用方法
+ *   std::vector<uint64_t> keys = ..., scratch(keys.size());
+ *   uint64_t *sorted = LRadixSort::sort(keys.data(), scratch.data(), keys.size()); // 结果在 keys 或 scratch 中。
+ */
+class LRadixSort
+{
+
+public:
+
+    /**
+     * @brief 排序。
+     * @tparam Key 无符号整数类型。
+     * @param keys 待排序的键。
+     * @param scratch 与 keys 等长的辅助缓冲区。
+     * @param count 键的个数。
+     * @return 排好序的键所在的缓冲区，为 keys 或 scratch。
+     */
+    template <typename Key>
+    static Key *sort(Key *keys, Key *scratch, size_t count);
+
+
+private:
+
+    /**
+     * @brief 每轮的位数与桶数。
+     */
+    static constexpr unsigned int digitBits = 8;
+    static constexpr size_t buckets = size_t(1) << digitBits;
+};
+
+
+template <typename Key>
+inline Key *LRadixSort::sort(Key *keys, Key *scratch, size_t count)
+{
+    static_assert(std::is_unsigned<Key>::value, "LRadixSort requires an unsigned integer key.");
+
+    // 函数执行逻辑：
+    // 1. 一次遍历统计每个字节位的直方图。
+    // 2. 从最低字节起，跳过所有键都相同的字节位，其余每位按前缀和得到各桶的起始位置，稳定地分配到另一个缓冲区，两个缓冲区交替使用。
+    constexpr size_t passes = sizeof(Key);
+    std::array<std::array<size_t, buckets>, passes> histograms{};
+
+    for (size_t i = 0; i < count; ++i)
+        for (size_t pass = 0; pass < passes; ++pass) ++histograms[pass][(keys[i] >> (pass * digitBits)) & (buckets - 1)];
+
+    Key *source = keys;
+    Key *target = scratch;
+    for (size_t pass = 0; pass < passes && count > 0; ++pass)
+    {
+        std::array<size_t, buckets> &histogram = histograms[pass];
+        unsigned int shift = pass * digitBits;
+        if (histogram[(source[0] >> shift) & (buckets - 1)] == count) continue;
+
+        size_t offset = 0;
+        for (size_t &bucket : histogram)
+        {
+            size_t bucketCount = bucket;
+            bucket = offset;
+            offset += bucketCount;
+        }
+
+        for (size_t i = 0; i < count; ++i) target[histogram[(source[i] >> shift) & (buckets - 1)]++] = source[i];
+        std::swap(source, target);
+    }
+
+
+    return source;
+}
+
+
+#endif
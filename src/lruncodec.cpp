@@ -0,0 +1,167 @@
+/**
+ * @file lruncodec.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 有序归并段压缩编码类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lruncodec.h"
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+
+/**
+ * @brief n 个 width 位的值位打包后的字节数。
+ */
+static size_t packedBytes(size_t n, unsigned int width)
+{
+    return (n * width + 7) / 8;
+}
+
+/**
+ * @brief 表示 value 所需的位数。
+ */
+static unsigned int bitWidth(uint32_t value)
+{
+    unsigned int width = 0;
+    while (width < 32 && (value >> width) != 0) ++width;
+
+
+    return width;
+}
+
+/**
+ * @brief 从 [data, end) 中以字节偏移 offset 读取至多 8 个字节，超出 end 的部分视为 0。
+ */
+static uint64_t load64(const unsigned char *data, const unsigned char *end, size_t offset)
+{
+    uint64_t word = 0;
+    if (data + offset + sizeof(word) <= end) std::memcpy(&word, data + offset, sizeof(word));
+    else std::memcpy(&word, data + offset, static_cast<size_t>(end - data - offset));
+
+
+    return word;
+}
+
+
+void LRunCodec::encode(const int *values, size_t count, Bytes &out)
+{
+    // 函数执行逻辑：
+    // 1. 按 frameSize 个值切分为帧，帧头预留位置，最后回填帧的总字节数。
+    // 2. 计算相邻差值，每 groupSize 个差值取最大值的位数作为该组位宽。
+    // 3. 逐组按位宽将差值写入 64 位窗口：窗口起始于差值所在的字节，移位量不超过 7，位宽不超过 32，因此不会越出 64 位。
+    uint32_t delta[groupSize];
+
+    // 最坏情况每个差值 32 位，另加帧头、位宽数组与写入窗口的尾部空间。
+    size_t frames = (count + frameSize - 1) / frameSize;
+    out.reserve(out.size() + count * sizeof(int) + frames * (headerBytes + frameSize / groupSize) + sizeof(uint64_t));
+
+    for (size_t begin = 0; begin < count; begin += frameSize)
+    {
+        size_t frameCount = std::min(frameSize, count - begin);
+        const int *frame = values + begin;
+        size_t groups = (frameCount - 1 + groupSize - 1) / groupSize;
+
+        size_t frameBegin = out.size();
+        out.resize(frameBegin + headerBytes + groups);
+
+        uint32_t header[3] = {0, static_cast<uint32_t>(frameCount), static_cast<uint32_t>(frame[0])};
+
+        for (size_t g = 0; g < groups; ++g)
+        {
+            size_t first = 1 + g * groupSize;
+            size_t n = std::min(groupSize, frameCount - first);
+
+            uint32_t maxDelta = 0;
+            for (size_t i = 0; i < n; ++i)
+            {
+                delta[i] = static_cast<uint32_t>(frame[first + i]) - static_cast<uint32_t>(frame[first + i - 1]);
+                maxDelta |= delta[i];
+            }
+
+            unsigned int width = bitWidth(maxDelta);
+            out[frameBegin + headerBytes + g] = static_cast<char>(width);
+
+            size_t groupBegin = out.size();
+            out.resize(groupBegin + packedBytes(n, width) + sizeof(uint64_t));
+            unsigned char *packed = reinterpret_cast<unsigned char *>(out.data() + groupBegin);
+
+            for (size_t i = 0; i < n && width > 0; ++i)
+            {
+                size_t bit = i * width;
+                uint64_t word;
+                std::memcpy(&word, packed + bit / 8, sizeof(word));
+                word |= static_cast<uint64_t>(delta[i]) << (bit % 8);
+                std::memcpy(packed + bit / 8, &word, sizeof(word));
+            }
+
+            // 去掉写入窗口时预留的尾部空间。
+            out.resize(groupBegin + packedBytes(n, width));
+        }
+
+        header[0] = static_cast<uint32_t>(out.size() - frameBegin);
+        std::memcpy(out.data() + frameBegin, header, headerBytes);
+    }
+}
+
+size_t LRunCodec::frameBytes(const char *data, size_t available)
+{
+    if (available < headerBytes) return 0;
+
+    uint32_t header[3];
+    std::memcpy(header, data, headerBytes);
+
+    size_t count = header[1];
+    if (0 == count || count > frameSize || header[0] < headerBytes + (count - 1 + groupSize - 1) / groupSize) throw std::runtime_error("Corrupted compressed run frame.");
+
+
+    return header[0];
+}
+
+size_t LRunCodec::decodeFrame(const char *data, size_t bytes, int *out)
+{
+    // 函数执行逻辑：
+    // 1. 读取帧头与位宽数组，校验各组位宽与帧的总字节数一致。
+    // 2. 逐组解包：第 i 个差值位于第 i * width 位，读取其所在字节起的 64 位窗口，右移并按位宽取掩码，循环内没有数据相关的分支。
+    // 3. 解包的同时做前缀和，还原原值。
+    if (frameBytes(data, bytes) != bytes) throw std::runtime_error("Corrupted compressed run frame.");
+
+    uint32_t header[3];
+    std::memcpy(header, data, headerBytes);
+
+    size_t count = header[1];
+    size_t groups = (count - 1 + groupSize - 1) / groupSize;
+    const unsigned char *widths = reinterpret_cast<const unsigned char *>(data) + headerBytes;
+    const unsigned char *packed = widths + groups;
+    const unsigned char *end = reinterpret_cast<const unsigned char *>(data) + bytes;
+
+    uint32_t value = header[2];
+    out[0] = static_cast<int>(value);
+
+    for (size_t g = 0; g < groups; ++g)
+    {
+        size_t first = 1 + g * groupSize;
+        size_t n = std::min(groupSize, count - first);
+        unsigned int width = widths[g];
+        if (width > 32 || packed + packedBytes(n, width) > end) throw std::runtime_error("Corrupted compressed run frame.");
+
+        uint64_t mask = (uint64_t(1) << width) - 1;
+        for (size_t i = 0; i < n; ++i)
+        {
+            size_t bit = i * width;
+            value += static_cast<uint32_t>((load64(packed, end, bit / 8) >> (bit % 8)) & mask);
+            out[first + i] = static_cast<int>(value);
+        }
+
+        packed += packedBytes(n, width);
+    }
+
+    if (packed != end) throw std::runtime_error("Corrupted compressed run frame.");
+
+
+    return count;
+}
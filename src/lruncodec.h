@@ -0,0 +1,102 @@
+/**
+ * @file lruncodec.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 有序归并段压缩编码类头文件。
+ * @details 有序整数序列相邻元素的差值很小，LRunCodec 将其编码为一串帧，每帧最多 frameSize 个值：
+ * 1. 帧头 12 字节：帧的总字节数、值的个数、第一个值。
+ * 2. 位宽数组：之后的 count - 1 个差值每 groupSize 个一组，每组一个字节记录该组最大差值所需的位数（0 到 32）。
+ * 3. 位打包数据：每组差值按该组位宽紧密排列，组与组按字节对齐。
+ * 差值按 uint32_t 计算，有序序列的差值总是非负且不超过 2^32 - 1。解码时每个差值都按固定位宽、以字节偏移加移位的方式直接定位，
+ * 循环内没有数据相关的分支，再做一次前缀和即得到原值。帧头记录了帧的总字节数，读者可以从任意切分的字节流中逐帧取出并解码。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LRUNCODEC_H_
+#define _LRUNCODEC_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "lnuma.h"
+
+
+/**
+ * @class LRunCodec
+ * @brief 有序 int 序列的差分 + 位打包编解码。
+ *
+ * @note 使用方法
+ *   LRunCodec::Bytes encoded;
+ *   LRunCodec::encode(sorted.data(), sorted.size(), encoded);
+ *   size_t bytes = LRunCodec::frameBytes(encoded.data(), encoded.size()); // 第一帧的字节数。
+ *   std::vector<int> values(LRunCodec::frameSize);
+ *   size_t count = LRunCodec::decodeFrame(encoded.data(), bytes, values.data());
+ */
+class LRunCodec
+{
+
+public:
+
+    /**
+     * @brief 编码结果的字节缓冲区类型，按 4 KiB 对齐，可以直接以 O_DIRECT 写出。
+     */
+    using Bytes = std::vector<char, LNumaAllocator<char>>;
+
+    /**
+     * @brief 每帧最多的值个数。
+     */
+    static constexpr size_t frameSize = 16384;
+
+    /**
+     * @brief 共用一个位宽的差值个数。
+     */
+    static constexpr size_t groupSize = 128;
+
+    /**
+     * @brief 帧头字节数。
+     */
+    static constexpr size_t headerBytes = 12;
+
+    /**
+     * @brief 默认构造函数。
+     */
+    LRunCodec() = default;
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LRunCodec() = default;
+
+    /**
+     * @brief 将有序序列编码后追加到 out。
+     * @param values 非递减的值序列。
+     * @param count 值的个数。
+     * @param out 输出缓冲区，编码结果追加在末尾。
+     * @note 序列不是非递减时结果仍可正确解码，只是差值按 uint32_t 回绕，压缩率很差。
+     */
+    static void encode(const int *values, size_t count, Bytes &out);
+
+    /**
+     * @brief 返回数据开头那一帧的总字节数。
+     * @param data 帧数据。
+     * @param available 可用的字节数。
+     * @return 帧的字节数；不足一个帧头时返回 0。
+     * @note 帧头不合法时抛出 std::runtime_error。
+     */
+    static size_t frameBytes(const char *data, size_t available);
+
+    /**
+     * @brief 解码一帧。
+     * @param data 帧数据。
+     * @param bytes 帧的字节数，即 frameBytes() 的返回值。
+     * @param out 输出缓冲区，至少 frameSize 个元素。
+     * @return 解码出的值个数。
+     * @note 帧数据不完整或不一致时抛出 std::runtime_error。
+     */
+    static size_t decodeFrame(const char *data, size_t bytes, int *out);
+};
+
+
+#endif
@@ -0,0 +1,193 @@
+/**
+ * @file lrunstore.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 有序归并段存储类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lrunstore.h"
+
+#include "lruncodec.h"
+#include "lthreadpool.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+
+LRun::LRun(const std::string &filePath, bool compressed) : m_filePath(filePath), m_compressed(compressed)
+{
+}
+
+bool LRun::empty() const
+{
+    return !m_buffer && m_filePath.empty();
+}
+
+bool LRun::inMemory() const
+{
+    return static_cast<bool>(m_buffer);
+}
+
+const std::string &LRun::filePath() const
+{
+    return m_filePath;
+}
+
+bool LRun::compressed() const
+{
+    return m_compressed;
+}
+
+const char *LRun::memoryData() const
+{
+    return m_buffer->data();
+}
+
+size_t LRun::memoryBytes() const
+{
+    return m_buffer->bytes();
+}
+
+void LRun::appendMemory(const char *data, size_t bytes)
+{
+    m_buffer->append(data, bytes);
+}
+
+void LRun::discard()
+{
+    if (!m_filePath.empty()) std::remove(m_filePath.c_str());
+
+    m_filePath.clear();
+    m_compressed = false;
+    m_buffer.reset();
+}
+
+
+LRunStore::LRunStore(uint64_t memoryBudget) : m_state(std::make_shared<State>())
+{
+    m_state->budget = memoryBudget;
+}
+
+uint64_t LRunStore::memoryBudget() const
+{
+    return m_state->budget;
+}
+
+uint64_t LRunStore::memoryUsed() const
+{
+    return m_state->used.load(std::memory_order_relaxed);
+}
+
+bool LRunStore::tryAcquire(uint64_t bytes)
+{
+    // 多个作业的写出与归并节点并发取得预算，CAS 保证总占用不超过预算。
+    uint64_t used = m_state->used.load(std::memory_order_relaxed);
+    do
+    {
+        if (bytes > m_state->budget || used > m_state->budget - bytes) return false;
+    } while (!m_state->used.compare_exchange_weak(used, used + bytes, std::memory_order_relaxed));
+
+
+    return true;
+}
+
+void LRunStore::release(uint64_t bytes)
+{
+    m_state->used.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+LRun LRunStore::makeRun(std::unique_ptr<LRun::Buffer> buffer, uint64_t bytes)
+{
+    LRun run;
+    run.m_buffer = std::shared_ptr<LRun::Buffer>(buffer.release(), [state = m_state, bytes](LRun::Buffer *ptr) {
+        delete ptr;
+        state->used.fetch_sub(bytes, std::memory_order_relaxed);
+    });
+
+
+    return run;
+}
+
+
+LRunReader::LRunReader(const LRun &run, const LIoOptions &options) : m_run(run)
+{
+    if (!m_run.inMemory()) m_reader = std::make_unique<LBlockReader>(m_run.filePath(), options);
+}
+
+size_t LRunReader::next(const char *&data)
+{
+    if (m_reader && m_run.compressed())
+    {
+        size_t count = decodeNext();
+        data = count > 0 ? reinterpret_cast<const char *>(m_decoded.data()) : nullptr;
+
+
+        return count * sizeof(int);
+    }
+
+    if (m_reader)
+    {
+        // 只有读取磁盘归并段时标记阻塞，弹性线程池在此期间补充线程；内存归并段与归并本身是计算，不标记。
+        LThreadPool::BlockingScope blocking;
+
+
+        return m_reader->next(data);
+    }
+
+    data = nullptr;
+    if (m_done) return 0;
+    m_done = true;
+
+    data = m_run.memoryData();
+
+
+    return m_run.memoryBytes();
+}
+
+size_t LRunReader::decodeNext()
+{
+    // 函数执行逻辑：
+    // 1. 已读入的字节中有完整的一帧时直接解码。
+    // 2. 否则丢弃已解码的部分，从块读取器读入下一块追加到末尾，直到凑齐一帧。
+    // 3. 文件读完时若仍有不完整的帧，说明文件被截断。
+    m_decoded.resize(LRunCodec::frameSize);
+
+    for (;;)
+    {
+        size_t available = m_pending.size() - m_pendingBegin;
+        size_t bytes = LRunCodec::frameBytes(m_pending.data() + m_pendingBegin, available);
+        if (bytes > 0 && bytes <= available)
+        {
+            size_t count = LRunCodec::decodeFrame(m_pending.data() + m_pendingBegin, bytes, m_decoded.data());
+            m_pendingBegin += bytes;
+
+
+            return count;
+        }
+
+        const char *block;
+        size_t blockBytes;
+        {
+            LThreadPool::BlockingScope blocking;
+
+            blockBytes = m_reader->next(block);
+        }
+        if (0 == blockBytes)
+        {
+            if (available > 0) throw std::runtime_error("Truncated compressed run " + m_run.filePath() + ".");
+
+            return 0;
+        }
+
+        m_pending.erase(m_pending.begin(), m_pending.begin() + static_cast<std::ptrdiff_t>(m_pendingBegin));
+        m_pendingBegin = 0;
+        m_pending.insert(m_pending.end(), block, block + blockBytes);
+    }
+}
+
+
+template class LBasicRunMerger<int>;
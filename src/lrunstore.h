@@ -0,0 +1,569 @@
+/**
+ * @file lrunstore.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 有序归并段存储类头文件。
+ * @details 排序器产生的每个有序归并段（块排序结果或中间归并结果）由 LRun 表示，它要么驻留在内存中，要么是磁盘上的一个文件。
+ * LRunStore 维护一份内存预算：预算足够时归并段留在内存中，超出预算时由调用者溢写到磁盘。块排序完成后缓冲区本身就是一个有序归并段，
+ * 直接接管该缓冲区即可保存在内存中，不需要任何复制，因此这里使用普通的匿名内存而不是 memfd。磁盘归并段可以是原始的元素数组，
+ * 也可以是 LRunCodec 压缩编码的帧序列。LRunReader 以统一的方式按块读取这些归并段：内存归并段一次返回整个缓冲区，归并时零拷贝；压缩归并段逐帧解码。
+ * LBasicRunMerger 在多个 LRunReader 之上做 k 路堆归并，由调用者按批拉取归并结果。比较器为 LKeyLess 时堆中只缓存键与记录地址，不复制整条记录；
+ * 为 LFloatLess 时堆中缓存浮点数的整数键，比较只比较整数，出堆时再解码。
+ * 归并段本身与元素类型无关：磁盘归并段是定长元素的原始字节，内存归并段以类型擦除的方式持有 std::vector<T>，只有归并与访问缓冲区时才需要知道元素类型。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LRUNSTORE_H_
+#define _LRUNSTORE_H_
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <functional>
+#include <queue>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "lnuma.h"
+#include "lblockio.h"
+#include "lkeyless.h"
+#include "lfloatless.h"
+
+
+/**
+ * @brief 归并段缓冲区类型，与排序器的块缓冲区相同，可以直接接管块缓冲区。
+ */
+template <typename T>
+using LRunBufferT = std::vector<T, LNumaAllocator<T>>;
+
+/**
+ * @brief int 元素的归并段缓冲区类型。
+ */
+using LRunBuffer = LRunBufferT<int>;
+
+
+/**
+ * @class LRun
+ * @brief 一个有序归并段，驻留在内存中或保存为磁盘文件。
+ * @note LRun 的副本共享同一块内存，最后一个副本销毁时内存释放并归还预算。
+ */
+class LRun
+{
+
+public:
+
+    /**
+     * @brief 构造空的归并段。
+     */
+    LRun() = default;
+
+    /**
+     * @brief 构造磁盘归并段。
+     * @param filePath 文件路径。
+     * @param compressed 文件是否为 LRunCodec 压缩编码，默认 false。
+     */
+    explicit LRun(const std::string &filePath, bool compressed = false);
+
+    /**
+     * @brief 默认析构函数，不删除文件。
+     */
+    virtual ~LRun() = default;
+
+    /**
+     * @brief 是否为空。
+     */
+    bool empty() const;
+
+    /**
+     * @brief 是否驻留在内存中。
+     */
+    bool inMemory() const;
+
+    /**
+     * @brief 返回磁盘归并段的文件路径，内存归并段返回空字符串。
+     */
+    const std::string &filePath() const;
+
+    /**
+     * @brief 磁盘归并段是否为 LRunCodec 压缩编码。
+     */
+    bool compressed() const;
+
+    /**
+     * @brief 返回内存归并段的缓冲区，仅在 inMemory() 为 true 时可以调用。
+     * @note T 必须与创建该归并段时的元素类型一致。
+     */
+    template <typename T = int>
+    LRunBufferT<T> &buffer();
+    template <typename T = int>
+    const LRunBufferT<T> &buffer() const;
+
+    /**
+     * @brief 返回内存归并段数据的起始地址与字节数，与元素类型无关，仅在 inMemory() 为 true 时可以调用。
+     */
+    const char *memoryData() const;
+    size_t memoryBytes() const;
+
+    /**
+     * @brief 向内存归并段的末尾追加元素的原始字节，仅在 inMemory() 为 true 时可以调用。
+     * @param data 元素的起始地址。
+     * @param bytes 字节数，须为元素字节数的整数倍。
+     */
+    void appendMemory(const char *data, size_t bytes);
+
+    /**
+     * @brief 丢弃归并段：删除磁盘文件，或放弃本副本对内存的引用，然后置为空。
+     */
+    void discard();
+
+
+private:
+
+    friend class LRunStore;
+
+    /**
+     * @brief 类型擦除的内存归并段缓冲区。
+     */
+    struct Buffer
+    {
+        virtual ~Buffer() = default;
+        virtual const char *data() const = 0;
+        virtual size_t bytes() const = 0;
+        virtual void append(const char *data, size_t bytes) = 0;
+    };
+
+    /**
+     * @brief 持有 T 类型元素的内存归并段缓冲区。
+     */
+    template <typename T>
+    struct TypedBuffer : Buffer
+    {
+        explicit TypedBuffer(LRunBufferT<T> &&buffer) : values(std::move(buffer)) {}
+        const char *data() const override { return reinterpret_cast<const char *>(values.data()); }
+        size_t bytes() const override { return values.size() * sizeof(T); }
+        void append(const char *data, size_t bytes) override { values.insert(values.end(), reinterpret_cast<const T *>(data), reinterpret_cast<const T *>(data + bytes)); }
+
+        LRunBufferT<T> values;
+    };
+
+    std::string m_filePath;           // 磁盘归并段的文件路径。
+    bool m_compressed = false;        // 磁盘归并段是否压缩。
+    std::shared_ptr<Buffer> m_buffer; // 内存归并段的缓冲区，删除器归还预算。
+};
+
+
+/**
+ * @class LRunStore
+ * @brief 在内存预算内创建内存归并段。
+ *
+ * @note 使用方法
+ *   LRunStore store(256 << 20);
+ *   LRun run = store.adopt(sortedChunk);
+ *   if (run.empty()) run = LRun(writeToDisk(sortedChunk));
+ */
+class LRunStore
+{
+
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param memoryBudget 内存归并段总字节数的上限，0 表示所有归并段都写到磁盘。
+     */
+    explicit LRunStore(uint64_t memoryBudget);
+
+    /**
+     * @brief 默认析构函数。已创建的 LRun 可以比 LRunStore 存活更久。
+     */
+    virtual ~LRunStore() = default;
+
+    /**
+     * @brief 返回内存预算。
+     */
+    uint64_t memoryBudget() const;
+
+    /**
+     * @brief 返回当前内存归并段占用的字节数。
+     */
+    uint64_t memoryUsed() const;
+
+    /**
+     * @brief 预算足够时接管缓冲区，作为内存归并段返回。
+     * @param buffer 有序的缓冲区，成功时其内存被移走，buffer 变为空。
+     * @return 内存归并段；预算不足时返回空的 LRun，buffer 保持不变。
+     * @note 按缓冲区容量计入预算。
+     */
+    template <typename T>
+    LRun adopt(LRunBufferT<T> &buffer);
+
+    /**
+     * @brief 预算足够时创建一个已预留 count 个 T 类型元素容量的空内存归并段，用于写入归并结果。
+     * @param count 元素个数。
+     * @param node 缓冲区所在的 NUMA 节点，小于 0 表示不指定。
+     * @return 内存归并段；预算不足时返回空的 LRun。
+     */
+    template <typename T = int>
+    LRun reserve(size_t count, int node);
+
+
+private:
+
+    /**
+     * @brief 尝试从预算中取得 bytes 字节。
+     * @return 成功返回 true。
+     */
+    bool tryAcquire(uint64_t bytes);
+
+    /**
+     * @brief 归还 bytes 字节的预算。
+     */
+    void release(uint64_t bytes);
+
+    /**
+     * @brief 用预算已取得的缓冲区构造内存归并段，缓冲区销毁时归还 bytes 字节。
+     */
+    LRun makeRun(std::unique_ptr<LRun::Buffer> buffer, uint64_t bytes);
+
+
+private:
+
+    /**
+     * @brief 与所有内存归并段共享的预算状态。
+     */
+    struct State
+    {
+        uint64_t budget = 0;            // 内存预算。
+        std::atomic<uint64_t> used{0};  // 已占用的字节数。
+    };
+
+    /**
+     * @brief 预算状态。
+     */
+    std::shared_ptr<State> m_state;
+};
+
+
+/**
+ * @class LRunReader
+ * @brief 按块顺序读取归并段，接口与 LBlockReader 相同。
+ * @note 内存归并段第一次调用 next() 即返回整个缓冲区，不复制数据；磁盘归并段交给 LBlockReader 读取，压缩归并段每次返回解码后的一帧。
+ */
+class LRunReader
+{
+
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param run 归并段，读取期间其内存保持有效。
+     * @param options 读取磁盘归并段使用的块读写选项。
+     * @note 文件打开失败时抛出 std::runtime_error。
+     */
+    LRunReader(const LRun &run, const LIoOptions &options);
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LRunReader() = default;
+
+    LRunReader(const LRunReader &other) = delete;
+    LRunReader &operator=(const LRunReader &other) = delete;
+
+    /**
+     * @brief 返回下一块数据。
+     * @param data 输出参数，指向块数据，在下一次调用 next() 前有效。
+     * @return 块的字节数，读完返回 0。
+     * @note 压缩归并段数据损坏时抛出 std::runtime_error。
+     */
+    size_t next(const char *&data);
+
+
+private:
+
+    /**
+     * @brief 读取并解码压缩归并段的下一帧。
+     * @return 解码出的值个数，读完返回 0。
+     */
+    size_t decodeNext();
+
+
+private:
+
+    LRun m_run;                             // 被读取的归并段，持有内存归并段的引用。
+    bool m_done = false;                    // 内存归并段是否已经返回。
+    std::unique_ptr<LBlockReader> m_reader; // 磁盘归并段的块读取器。
+    std::vector<char> m_pending;            // 压缩归并段已读入、尚未解码的字节，帧可能跨越读取的块。
+    size_t m_pendingBegin = 0;              // m_pending 中下一帧的起始位置。
+    std::vector<int> m_decoded;             // 压缩归并段解码后的一帧。
+};
+
+
+/**
+ * @struct LMergeEntry
+ * @brief 归并堆中代表某个输入当前记录的条目，默认复制记录本身，比较时调用比较器。
+ */
+template <typename T, typename Compare>
+struct LMergeEntry
+{
+    T val; // 当前记录。
+
+    static LMergeEntry make(const T *record, const Compare &) { return {*record}; }
+    const T &record() const { return val; }
+    static bool less(const LMergeEntry &a, const LMergeEntry &b, const Compare &compare) { return compare(a.val, b.val); }
+};
+
+/**
+ * @brief 按键比较的记录只缓存键与记录在当前块中的地址。该输入的下一次读取发生在条目出堆、记录已复制到批缓冲区之后，地址在此之前有效。
+ */
+template <typename T, typename KeyOf>
+struct LMergeEntry<T, LKeyLess<KeyOf>>
+{
+    LKeyOf<T, KeyOf> key; // 当前记录的键。
+    const T *ptr;         // 当前记录的地址。
+
+    static LMergeEntry make(const T *record, const LKeyLess<KeyOf> &compare) { return {compare.keyOf(*record), record}; }
+    const T &record() const { return *ptr; }
+    static bool less(const LMergeEntry &a, const LMergeEntry &b, const LKeyLess<KeyOf> &) { return a.key < b.key; }
+};
+
+/**
+ * @brief 浮点数只缓存其整数键，键与浮点数一一对应，出堆时解码即得原值。
+ */
+template <typename F>
+struct LMergeEntry<F, LFloatLess<F>>
+{
+    typename LFloatKey<F>::Bits key; // 当前元素的键。
+
+    static LMergeEntry make(const F *record, const LFloatLess<F> &) { return {LFloatKey<F>::encode(*record)}; }
+    F record() const { return LFloatKey<F>::decode(key); }
+    static bool less(const LMergeEntry &a, const LMergeEntry &b, const LFloatLess<F> &) { return a.key < b.key; }
+};
+
+
+/**
+ * @class LBasicRunMerger
+ * @brief 对若干归并段做 k 路堆归并，由调用者按批拉取结果。
+ * @tparam T 定长元素类型，须可平凡复制。
+ * @tparam Compare 严格弱序比较器，归并段须按它有序。
+ *
+ * @note 使用方法
+ *   LRunMerger merger(runs, io, 1 << 16);
+ *   const int *data;
+ *   while (size_t count = merger.next(data)) consume(data, count);
+ */
+template <typename T, typename Compare = LDefaultLess<T>>
+class LBasicRunMerger
+{
+
+public:
+
+    /**
+     * @brief 构造函数，打开所有输入并读取各自的首元素。
+     * @param inputs 待归并的归并段，归并期间持有其引用，不会丢弃。
+     * @param options 读取磁盘归并段使用的块读写选项，blockSize 须为 sizeof(T) 的整数倍。
+     * @param batchSize 每批最多的元素个数。
+     * @param compare 比较器。
+     * @note 文件打开或读取失败时抛出 std::runtime_error。
+     */
+    LBasicRunMerger(const std::vector<LRun> &inputs, const LIoOptions &options, size_t batchSize, Compare compare = Compare());
+
+    /**
+     * @brief 默认析构函数。
+     */
+    virtual ~LBasicRunMerger() = default;
+
+    LBasicRunMerger(const LBasicRunMerger &other) = delete;
+    LBasicRunMerger &operator=(const LBasicRunMerger &other) = delete;
+
+    /**
+     * @brief 归并出下一批有序元素。
+     * @param data 输出参数，指向该批元素，在下一次调用 next() 前有效。
+     * @return 该批的元素个数，归并完毕返回 0。
+     * @note 只有一个输入时不做比较，直接返回该输入的各块，一批可能超过 batchSize。
+     */
+    size_t next(const T *&data);
+
+
+private:
+
+    /**
+     * @brief 取第 i 个输入的下一个元素，当前块耗尽时读取下一块。
+     * @return 元素在当前块中的地址，在下一次对该输入调用 pull() 前有效；该输入已读完返回 nullptr。
+     */
+    const T *pull(int i);
+
+
+private:
+
+    /**
+     * @brief 堆中的元素：当前记录的条目与其来源输入的下标。
+     */
+    struct Node
+    {
+        LMergeEntry<T, Compare> entry; // 当前记录的条目。
+        int index;                     // 元素来源归并段索引。
+    };
+
+    /**
+     * @brief 堆的比较器：值较大者优先级较低，堆顶为最小值。
+     */
+    struct Greater
+    {
+        Compare compare;
+        bool operator()(const Node &a, const Node &b) const { return LMergeEntry<T, Compare>::less(b.entry, a.entry, compare); }
+    };
+
+    /**
+     * @brief 每个输入当前块内的游标。
+     */
+    struct Cursor
+    {
+        const T *pos = nullptr;
+        const T *end = nullptr;
+    };
+
+    Compare m_compare;                                            // 比较器。
+    std::vector<std::unique_ptr<LRunReader>> m_readers;           // 每个输入的读者。
+    std::vector<Cursor> m_cursors;                                // 每个输入的游标。
+    std::priority_queue<Node, std::vector<Node>, Greater> m_heap; // 小根堆。
+    std::vector<T> m_batch;                                       // 当前批。
+    size_t m_batchSize = 0;                                       // 每批最多的元素个数。
+};
+
+/**
+ * @brief int 元素升序归并。
+ */
+using LRunMerger = LBasicRunMerger<int>;
+
+
+template <typename T>
+inline LRunBufferT<T> &LRun::buffer()
+{
+    return static_cast<TypedBuffer<T> &>(*m_buffer).values;
+}
+
+template <typename T>
+inline const LRunBufferT<T> &LRun::buffer() const
+{
+    return static_cast<const TypedBuffer<T> &>(*m_buffer).values;
+}
+
+template <typename T>
+inline LRun LRunStore::adopt(LRunBufferT<T> &buffer)
+{
+    uint64_t bytes = buffer.capacity() * sizeof(T);
+    if (!tryAcquire(bytes)) return LRun();
+
+    // 移动构造连同分配器一起移走内存，不复制元素。
+    auto adopted = std::make_unique<LRun::TypedBuffer<T>>(std::move(buffer));
+    LRunBufferT<T>(adopted->values.get_allocator()).swap(buffer);
+
+
+    return makeRun(std::move(adopted), bytes);
+}
+
+template <typename T>
+inline LRun LRunStore::reserve(size_t count, int node)
+{
+    uint64_t bytes = count * sizeof(T);
+    if (!tryAcquire(bytes)) return LRun();
+
+    std::unique_ptr<LRun::TypedBuffer<T>> buffer;
+    try
+    {
+        buffer = std::make_unique<LRun::TypedBuffer<T>>(LRunBufferT<T>(LNumaAllocator<T>(node)));
+        buffer->values.reserve(count);
+    }
+    catch (...)
+    {
+        release(bytes);
+
+        throw;
+    }
+
+
+    return makeRun(std::move(buffer), bytes);
+}
+
+template <typename T, typename Compare>
+inline LBasicRunMerger<T, Compare>::LBasicRunMerger(const std::vector<LRun> &inputs, const LIoOptions &options, size_t batchSize, Compare compare)
+    : m_compare(std::move(compare)), m_cursors(inputs.size()), m_heap(Greater{m_compare}), m_batchSize(std::max<size_t>(1, batchSize))
+{
+    for (const LRun &run : inputs) m_readers.push_back(std::make_unique<LRunReader>(run, options));
+
+    // 只有一个输入时逐块直接返回，不建堆。
+    if (m_readers.size() < 2) return;
+
+    // 初始化堆，将每个输入的首元素加入堆。
+    for (int i = 0; i < static_cast<int>(m_readers.size()); ++i)
+    {
+        if (const T *record = pull(i)) m_heap.push({LMergeEntry<T, Compare>::make(record, m_compare), i});
+    }
+
+    m_batch.reserve(m_batchSize);
+}
+
+template <typename T, typename Compare>
+inline size_t LBasicRunMerger<T, Compare>::next(const T *&data)
+{
+    // 函数执行逻辑：
+    // 1. 没有输入时返回 0；只有一个输入时直接返回该输入的下一块。
+    // 2. 迭代堆：取出堆顶最小元素追加到批缓冲区，再从该元素所在输入取下一个值压入堆，直到批满或堆空。
+    // 3. 返回本批元素。
+    data = nullptr;
+    if (m_readers.empty()) return 0;
+
+    if (1 == m_readers.size())
+    {
+        const char *block;
+        size_t bytes = m_readers[0]->next(block);
+        data = reinterpret_cast<const T *>(block);
+
+
+        return bytes / sizeof(T);
+    }
+
+    m_batch.clear();
+    while (!m_heap.empty() && m_batch.size() < m_batchSize)
+    {
+        Node node = m_heap.top();
+        m_heap.pop();
+        m_batch.push_back(node.entry.record());
+
+        if (const T *record = pull(node.index)) m_heap.push({LMergeEntry<T, Compare>::make(record, m_compare), node.index});
+    }
+
+    data = m_batch.data();
+
+
+    return m_batch.size();
+}
+
+template <typename T, typename Compare>
+inline const T *LBasicRunMerger<T, Compare>::pull(int i)
+{
+    Cursor &cursor = m_cursors[i];
+    if (cursor.pos == cursor.end)
+    {
+        const char *block;
+        size_t bytes = m_readers[i]->next(block);
+        if (0 == bytes) return nullptr;
+
+        cursor.pos = reinterpret_cast<const T *>(block);
+        cursor.end = cursor.pos + bytes / sizeof(T);
+    }
+
+
+    return cursor.pos++;
+}
+
+
+// int 元素的归并器在 lrunstore.cpp 中显式实例化。
+extern template class LBasicRunMerger<int>;
+
+
+#endif
@@ -0,0 +1,13 @@
+/**
+ * @file lsortcursor.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 排序结果游标类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "lsortcursor.h"
+
+
+template class LBasicSortCursor<int>;
@@ -0,0 +1,148 @@
+/**
+ * @file lsortcursor.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 排序结果游标类头文件。
+ * @details 许多调用者只需要顺序扫描一遍排序结果。LSortCursor 持有排序器归并到不超过 k 个的归并段，最后一轮 k 路归并不再写出结果文件，
+ * 而是在调用者每次 next() 时按批惰性地归并出下一批有序元素。这样省去结果文件的一次完整写出与读回，调用者也能在最后一轮归并开始时立即拿到第一批结果。
+ * 游标与排序器一样以元素类型和比较器为模板参数，LSortCursor 是 int 元素升序的实例。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LSORTCURSOR_H_
+#define _LSORTCURSOR_H_
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "lblockio.h"
+#include "lcancellationtoken.h"
+#include "lrunstore.h"
+#include "lthreadpool.h"
+
+
+/**
+ * @class LBasicSortCursor
+ * @brief 按批拉取排序结果的游标，由 LBasicSorter::openCursor() 创建。
+ * @tparam T 定长元素类型。
+ * @tparam Compare 严格弱序比较器。
+ *
+ * @note 使用方法
+ *   std::unique_ptr<LSortCursor> cursor = sorter.openCursor(filePath);
+ *   const int *data;
+ *   while (size_t count = cursor->next(data)) consume(data, count);
+ */
+template <typename T, typename Compare = LDefaultLess<T>>
+class LBasicSortCursor
+{
+
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param runs 待归并的归并段，游标接管它们，读完或析构时丢弃。
+     * @param options 读取磁盘归并段使用的块读写选项，每批最多 options.blockSize 字节。
+     * @param token 取消令牌，每次 next() 时检查。
+     * @param compare 比较器，归并段须按它有序。
+     * @note 打开归并段失败时丢弃所有归并段并抛出 std::runtime_error。
+     */
+    LBasicSortCursor(std::vector<LRun> runs, const LIoOptions &options, const LCancellationToken &token, Compare compare = Compare());
+
+    /**
+     * @brief 析构函数，丢弃尚未读完的归并段（删除临时文件、释放内存）。
+     */
+    virtual ~LBasicSortCursor();
+
+    LBasicSortCursor(const LBasicSortCursor &other) = delete;
+    LBasicSortCursor &operator=(const LBasicSortCursor &other) = delete;
+
+    /**
+     * @brief 返回下一批有序元素。
+     * @param data 输出参数，指向该批元素，在下一次调用 next() 或游标析构前有效。
+     * @return 该批的元素个数，全部读完返回 0，此时归并段已被丢弃。
+     * @note 令牌被取消时抛出 LCancelledError，读取失败时抛出 std::runtime_error。
+     */
+    size_t next(const T *&data);
+
+
+private:
+
+    /**
+     * @brief 丢弃所有归并段。
+     */
+    void discard();
+
+
+private:
+
+    std::vector<LRun> m_runs;                              // 待归并的归并段。
+    LCancellationToken m_token;                            // 取消令牌。
+    std::unique_ptr<LBasicRunMerger<T, Compare>> m_merger; // 最后一轮归并，读完后置空。
+};
+
+/**
+ * @brief int 元素升序的游标。
+ */
+using LSortCursor = LBasicSortCursor<int>;
+
+
+template <typename T, typename Compare>
+inline LBasicSortCursor<T, Compare>::LBasicSortCursor(std::vector<LRun> runs, const LIoOptions &options, const LCancellationToken &token, Compare compare)
+    : m_runs(std::move(runs)), m_token(token)
+{
+    // 构造函数抛出异常时析构函数不会执行，需要在这里丢弃归并段。
+    try
+    {
+        m_merger = std::make_unique<LBasicRunMerger<T, Compare>>(m_runs, options, options.blockSize / sizeof(T), std::move(compare));
+    }
+    catch (...)
+    {
+        discard();
+
+        throw;
+    }
+}
+
+template <typename T, typename Compare>
+inline LBasicSortCursor<T, Compare>::~LBasicSortCursor()
+{
+    discard();
+}
+
+template <typename T, typename Compare>
+inline size_t LBasicSortCursor<T, Compare>::next(const T *&data)
+{
+    data = nullptr;
+    if (!m_merger) return 0;
+
+    m_token.throwIfCancelled();
+
+    // 读取磁盘归并段时由 LRunReader 标记阻塞，归并本身不标记。
+    size_t count = m_merger->next(data);
+
+    // 读完后立即删除临时文件、释放内存，不必等到游标析构。
+    if (0 == count) discard();
+
+
+    return count;
+}
+
+template <typename T, typename Compare>
+inline void LBasicSortCursor<T, Compare>::discard()
+{
+    // 先关闭读者，再删除文件。
+    m_merger.reset();
+    for (LRun &run : m_runs) run.discard();
+    m_runs.clear();
+}
+
+
+// int 元素的游标在 lsortcursor.cpp 中显式实例化。
+extern template class LBasicSortCursor<int>;
+
+
+#endif
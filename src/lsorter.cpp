@@ -9,206 +9,384 @@
 
 #include "lsorter.h"
 
-#include "lutil.h"
+#include "lglobalmacros.h"
 
-#include <fstream>
-#include <iostream>
-#include <algorithm>
-#include <future>
+#include <atomic>
+#include <numeric>
+#include <cerrno>
+#include <cstring>
 
+#ifdef L_OS_LINUX
+#include <unistd.h>
+#endif
 
-LSorter::LSorter(LThreadPool *pool, unsigned int chunkSize, unsigned int k) : m_pool(pool), m_chunkSize(chunkSize), m_k(k)
+
+LSorterBase::LSorterBase(LThreadPool *pool, const LSorterOptions &options, size_t elementSize, bool compressible) : m_pool(pool), m_chunkSize(options.chunkSize), m_k(options.k), m_io(options.io), m_inputIo(options.io), m_outputIo(options.io), m_runStore(options.memoryBudget)
 {
     if (!pool) throw std::runtime_error("Pointer pool is a nullptr.");
+    // k 为 0 或 1 时每轮归并不会减少归并段数量，归并循环永不结束。
+    if (options.k < 2) throw std::runtime_error("Merge fan-in k must be at least 2.");
+
+    m_inputIo.direct = options.directInput;
+    m_outputIo.direct = options.directOutput;
+
+    // 临时文件按块读取、逐块归并，每块须由完整的元素组成。O_DIRECT 读取会把块大小向上取整为对齐单位的整数倍，两者取最小公倍数。
+    size_t unit = m_io.direct ? std::lcm(elementSize, LBlockIo::directAlignment) : elementSize;
+    m_io.blockSize = std::max<size_t>(1, (m_io.blockSize + unit - 1) / unit) * unit;
+
+    for (const std::string &directory : options.tempDirectories)
+    {
+        std::error_code error;
+        if (!std::filesystem::is_directory(directory, error)) throw std::runtime_error("Temp directory " + directory + " does not exist.");
+    }
+    m_tempDirectories = options.tempDirectories;
+    m_tempPlacement = options.tempPlacement;
+    m_compressRuns = options.compressRuns && compressible;
+    m_mapInput = options.mapInput;
+    m_inputReaders = std::max(1u, options.inputReaders);
+    m_inputFormat = options.inputFormat;
+    m_outputFormat = options.outputFormat;
 }
 
-LSorter::~LSorter()
+LSorterBase::~LSorterBase()
 {
     if (m_pool) m_pool = nullptr;
 }
 
-void LSorter::run(const std::string &filePath)
+LSorterOptions LSorterBase::sizeOptions(unsigned int chunkSize, unsigned int k)
 {
-    // 函数执行逻辑：
-    // 1. 打开待排序的二进制文件。
-    // 2.（可选）读取文件前 100 个元素并输出，用于原始数据调试。
-    // 3. 分块读取文件数据，每块大小为 m_chunkSize，将每块数据提交给线程池进行排序。每个任务完成后生成一个临时排序文件。
-    // 4. 等待所有分块排序任务完成，收集生成的临时文件路径。
-    // 5. 多轮 k 路归并：
-    //   - 每轮将临时文件分为若干组，每组最多 m_k 个文件。
-    //   - 对每组文件，若只有一个文件直接进入下一轮，否则提交归并任务到线程池。
-    //   - 每轮归并完成后生成新临时文件，旧文件被删除。
-    //   - 重复直到只剩下一个最终文件。
-    // 6. 将最终文件重命名为原文件名 + ".sorted"。
-    // 7. （可选）输出最终排序文件前 100 个元素，用于排序结果验证。
-
-    // 打开文件。
-    std::ifstream ifs(filePath, std::ios::binary);
-    if (!ifs) return;
-
-    // 存储分块排序任务的 future。
-    std::vector<std::future<std::string>> futures;
-    int index = 0;
-    std::vector<int> originalData;
-
-    // （可选）读取原始数据前 100 个元素。
-    int val;
-    while (ifs.read(reinterpret_cast<char *>(&val), sizeof(val)) && originalData.size() < 100) originalData.push_back(val);
-
-    std::cout << "Original data (first 100): ";
-    for (auto x : originalData) std::cout << x << " ";
-    std::cout << std::endl;
-
-    // 重置文件流以便重新读取。
-    ifs.clear();
-    ifs.seekg(0);
-
-    // 分块读取文件并提交排序任务。
-    while (!ifs.eof())
-    {
-        // 分配缓冲区。
-        std::vector<int> buffer;
-        buffer.reserve(m_chunkSize / sizeof(int));
+    LSorterOptions options;
+    options.chunkSize = chunkSize;
+    options.k = k;
 
-        while (buffer.size() < buffer.capacity() && ifs.read(reinterpret_cast<char *>(&val), sizeof(val))) buffer.push_back(val);
-        if (buffer.empty()) break;
 
-        // 提交排序任务到线程池。
-        futures.push_back(m_pool->enqueue([buffer = std::move(buffer), filePath, index, this]() mutable { // 排序内存块并写入临时文件。
-            std::sort(buffer.begin(), buffer.end());
-            return writeSortedChunk(filePath, index, buffer);
-        }));
+    return options;
+}
 
-        ++index;
-    }
+unsigned int LSorterBase::nextJob()
+{
+    static std::atomic<unsigned int> job(0);
 
-    // 获取所有排序块生成的临时文件路径。
-    std::vector<std::string> sortedinputFiles;
-    for (auto &f : futures) sortedinputFiles.push_back(f.get());
 
-    // 多轮 k 路归并。
-    int mergeRound = 0;
-    while (sortedinputFiles.size() > 1)
-    {
-        // 存储归并任务的 future。
-        std::vector<std::future<std::string>> mergeFutures;
-        // 下一轮归并文件列表。
-        std::vector<std::string> nextRoundFilePaths;
+    return job.fetch_add(1);
+}
+
+LSorterBase::StreamReader LSorterBase::streamReader(std::istream &input)
+{
+    return [&input](char *data, size_t bytes) {
+        input.read(data, static_cast<std::streamsize>(bytes));
+        if (input.bad()) throw std::runtime_error("Failed to read the input stream.");
+
+
+        return static_cast<size_t>(input.gcount());
+    };
+}
+
+LSorterBase::StreamWriter LSorterBase::streamWriter(std::ostream &output)
+{
+    return [&output](const char *data, size_t bytes) {
+        output.write(data, static_cast<std::streamsize>(bytes));
+        if (!output) throw std::runtime_error("Failed to write the output stream.");
+    };
+}
+
+LSorterBase::StreamReader LSorterBase::fdReader(int fd)
+{
+#ifdef L_OS_LINUX
+    return [fd](char *data, size_t bytes) {
+        ssize_t n;
+        do n = ::read(fd, data, bytes);
+        while (n < 0 && EINTR == errno);
+        if (n < 0) throw std::runtime_error(std::string("Failed to read the input descriptor: ") + std::strerror(errno) + ".");
+
+
+        return static_cast<size_t>(n);
+    };
+#else
+    (void)fd;
+
+    throw std::runtime_error("Sorting file descriptors is only available on Linux.");
+#endif
+}
 
-        for (int i = 0; i < sortedinputFiles.size(); i += m_k)
+LSorterBase::StreamWriter LSorterBase::fdWriter(int fd)
+{
+#ifdef L_OS_LINUX
+    return [fd](const char *data, size_t bytes) {
+        while (bytes > 0)
         {
-            std::vector<std::string> group;
-            for (int j = i; j < i + m_k && j < sortedinputFiles.size(); ++j) group.push_back(sortedinputFiles[j]);
+            ssize_t n = ::write(fd, data, bytes);
+            if (n < 0 && EINTR == errno) continue;
+            if (n <= 0) throw std::runtime_error(std::string("Failed to write the output descriptor: ") + std::strerror(errno) + ".");
 
-            if (1 == group.size())
-            {
-                // 单文件直接加入下一轮。
-                nextRoundFilePaths.push_back(group[0]);
-            }
-            else
+            data += n;
+            bytes -= static_cast<size_t>(n);
+        }
+    };
+#else
+    (void)fd;
+
+    throw std::runtime_error("Sorting file descriptors is only available on Linux.");
+#endif
+}
+
+bool LSorterBase::readTextChunk(const StreamReader &read, size_t chunkBytes, bool (*isSeparator)(char), std::vector<char> &carry, LRunBufferT<char> &text)
+{
+    // 函数执行逻辑：
+    // 1. 将上一块留下的记录放在块的开头，读满整块或读到输入末尾。
+    // 2. 未到输入末尾时从块尾向前找最后一个分隔符，块截断到它之后；整块都没有分隔符时将块扩大一倍继续读。
+    // 3. 截断之后的字节留到下一块。
+    text.resize(std::max(std::max<size_t>(1, chunkBytes), carry.size() + 1));
+    std::copy(carry.begin(), carry.end(), text.begin());
+    size_t filled = carry.size();
+    size_t end = 0;
+    bool eof = false;
+
+    // 读取流或管道时阻塞，标记阻塞以便弹性线程池补充线程。
+    LThreadPool::BlockingScope blocking;
+
+    for (;;)
+    {
+        while (filled < text.size())
+        {
+            size_t bytes = read(text.data() + filled, text.size() - filled);
+            if (0 == bytes)
             {
-                // 提交归并任务到线程池。
-                mergeFutures.push_back(m_pool->enqueue([group, mergeRound, i, this]() { //
-                    return mergeKFiles(group, mergeRound * 1000 + i);
-                }));
+                eof = true;
+
+                break;
             }
+            filled += bytes;
         }
 
-        // 获取归并任务结果。
-        for (auto &mf : mergeFutures) nextRoundFilePaths.push_back(mf.get());
+        if (eof)
+        {
+            end = filled;
+
+            break;
+        }
 
-        // 更新文件列表。
-        sortedinputFiles = std::move(nextRoundFilePaths);
+        auto last = std::find_if(std::make_reverse_iterator(text.begin() + filled), text.rend(), isSeparator);
+        if (last != text.rend())
+        {
+            end = static_cast<size_t>(last.base() - text.begin());
 
-        ++mergeRound;
+            break;
+        }
+        text.resize(text.size() * 2);
     }
 
-    // 重命名最终归并文件。
-    std::string finalFilePath = filePath + ".sorted";
-    std::rename(sortedinputFiles[0].c_str(), finalFilePath.c_str());
+    carry.assign(text.begin() + end, text.begin() + filled);
+    text.resize(end);
 
-    // （可选）输出最终排序前 100 个元素。
-    std::ifstream sortedFile(finalFilePath, std::ios::binary);
-    std::vector<int> sortedData;
-    while (sortedFile.read(reinterpret_cast<char *>(&val), sizeof(val)) && sortedData.size() < 100) sortedData.push_back(val);
 
-    std::cout << "Sorted data (first 100): ";
-    for (auto x : sortedData) std::cout << x << " ";
-    std::cout << std::endl;
+    return eof;
 }
 
-std::string LSorter::writeSortedChunk(const std::string &filePath, unsigned int index, const std::vector<int> &data)
+LSorterBase::StreamReader LSorterBase::fileReader(const std::string &filePath) const
 {
-    std::string outputFilePath = filePath + ".part" + std::to_string(index) + ".sorted";
+    std::error_code error;
+    uint64_t fileSize = std::filesystem::file_size(filePath, error);
+    if (error) throw std::runtime_error("Failed to open " + filePath + ".");
+
+    // 读取位置保存在共享的状态中，输入函数可以被复制。
+    auto offset = std::make_shared<uint64_t>(0);
+
 
-    std::ofstream ofs(outputFilePath, std::ios::binary);
-    ofs.write(reinterpret_cast<const char *>(data.data()), data.size() * sizeof(int));
+    return [filePath, fileSize, offset, io = m_inputIo](char *data, size_t bytes) {
+        size_t count = static_cast<size_t>(std::min<uint64_t>(bytes, fileSize - *offset));
+        if (count > 0) LBlockIo::readRange(filePath, data, count, *offset, io);
+        *offset += count;
 
 
-    return outputFilePath;
+        return count;
+    };
 }
 
-std::string LSorter::mergeKFiles(const std::vector<std::string> &filePaths, unsigned int index)
+std::vector<LRun> LSorterBase::generateRuns(const ChunkReader &readChunk, const GroupMerge &mergeGroup, size_t maxInFlight, const std::string &partPrefix, const std::string &extension, const LCancellationToken &token)
 {
     // 函数执行逻辑：
-    // 1. 如果输入文件列表为空，直接返回空字符串。
-    // 2. 如果输入文件列表只有一个文件，直接返回该文件路径。
-    // 3. 定义 Node 结构体，存储当前文件的元素值和对应文件索引，用于最小堆归并。
-    // 4. 打开所有输入文件的二进制流。
-    // 5. 使用 std::priority_queue 构建小根堆，将每个文件的首元素压入堆中。
-    // 6. 迭代堆：
-    //    - 取出堆顶最小元素，写入输出文件。
-    //    - 从该元素所在的文件读取下一个值，若存在则继续压入堆。
-    // 7. 所有元素处理完毕后关闭输入流，并删除原始临时文件。
-    // 8. 返回生成的归并临时文件路径。
+    // 1. 在调用线程上由 readChunk 逐块读取输入，每块的任务提交到线程池，在该块缓冲区所在的 NUMA 节点上执行。
+    //    同时在途的块任务不超过 maxInFlight 个，已读入而未生成归并段的块数因此有上限，内存占用不随输入长度增长。
+    // 2. 归并段多于 m_k 个时，按 m_k 个一组由 mergeGroup 并行归并到内存或临时文件，重复直到不超过 m_k 个。
+    // 3. 任何一步失败时等待在途任务结束，丢弃所有归并段（删除临时文件、释放内存）并重新抛出异常。
 
-    // 处理特殊情况。
-    if (filePaths.empty()) return std::string();
-    if (1 == filePaths.size()) return filePaths[0];
+    token.throwIfCancelled();
 
-    // 定义内部 Node 结构体用于堆归并。
-    struct Node
-    {
-        int val;       // 当前元素值。
-        int fileindex; // 元素来源文件索引。
-        bool operator>(const Node &other) const { return val > other.val; }
+    unsigned int job = nextJob();
+    std::vector<int> nodes = m_pool->numaNodes();
+
+    // 已完成的归并段（按生成顺序），以及在途的块任务或归并任务。
+    std::vector<SizedRun> runs;
+    std::vector<SizedRun> merged;
+    std::deque<std::future<SizedRun>> inFlight;
+
+    auto waitOldest = [&inFlight, this](std::vector<SizedRun> &done) {
+        std::future<SizedRun> oldest = std::move(inFlight.front());
+        inFlight.pop_front();
+        done.push_back(m_pool->wait(oldest));
     };
 
-    // 打开所有输入文件。
-    std::vector<std::ifstream> inputFiles(filePaths.size());
-    for (int i = 0; i < filePaths.size(); ++i) inputFiles[i].open(filePaths[i], std::ios::binary);
+    try
+    {
+        for (size_t i = 0;; ++i)
+        {
+            token.throwIfCancelled();
+
+            int node = nodes.empty() ? -1 : nodes[i % nodes.size()];
+            std::string path = tempFilePath(LUtil::executableDirectory(), partPrefix + std::to_string(job) + ".part" + std::to_string(i) + extension, i);
+            ChunkTask task = readChunk(i, node, path);
+            if (!task) break;
+
+            if (inFlight.size() >= maxInFlight) waitOldest(runs);
+            inFlight.push_back(m_pool->enqueueOnNode(node, LThreadPool::Priority::Normal, std::move(task)));
+        }
+
+        while (!inFlight.empty()) waitOldest(runs);
+
+        // 归并到不超过 m_k 个归并段。各组并行归并，成功的组立即释放其输入在 runs 中的引用；失败时 runs 中的副本用于清理。
+        // 归并输出按本作业内只增不减的序号命名，任意轮数、任意组数下文件名都不会冲突。
+        size_t mergeIndex = 0;
+        while (runs.size() > m_k)
+        {
+            for (size_t i = 0; i < runs.size(); i += m_k)
+            {
+                size_t end = std::min<size_t>(i + m_k, runs.size());
+                std::vector<LRun> group;
+                size_t size = 0;
+                for (size_t j = i; j < end; ++j)
+                {
+                    group.push_back(runs[j].run);
+                    size += runs[j].size;
+                }
+
+                std::string path = tempFilePath(LUtil::executableDirectory(), "tmp_merge_" + std::to_string(job) + "_" + std::to_string(mergeIndex++) + extension, i / m_k);
+                inFlight.push_back(m_pool->enqueue(LThreadPool::Priority::High, [group = std::move(group), &runs, &mergeGroup, i, end, size, path, &token]() mutable {
+                    token.throwIfCancelled();
+                    if (1 == group.size()) return SizedRun{group[0], size};
 
-    // 使用小根堆进行 k 路归并。
-    std::priority_queue<Node, std::vector<Node>, std::greater<Node>> pq;
+                    LRun run = mergeGroup(std::move(group), size, path);
+                    for (size_t j = i; j < end; ++j) runs[j].run = LRun();
 
-    // 初始化堆，将每个文件的首元素加入堆。
-    for (int i = 0; i < inputFiles.size(); ++i)
+
+                    return SizedRun{run, size};
+                }));
+            }
+
+            while (!inFlight.empty()) waitOldest(merged);
+
+            runs = std::move(merged);
+            merged.clear();
+        }
+    }
+    catch (...)
     {
-        int v;
-        if (inputFiles[i].read(reinterpret_cast<char *>(&v), sizeof(v))) pq.push({v, i});
+        // 在途任务引用着本帧的令牌与归并段列表，等待其全部结束后再清理。
+        for (std::future<SizedRun> &future : inFlight)
+        {
+            try
+            {
+                m_pool->wait(future).run.discard();
+            }
+            catch (...)
+            {
+            }
+        }
+        for (SizedRun &run : runs) run.run.discard();
+        for (SizedRun &run : merged) run.run.discard();
+
+        throw;
     }
 
-    // 输出文件路径。
-    std::string outputFilePath = LUtil::executableDirectory() + "tmp_merge_" + std::to_string(index) + ".bin";
-    std::ofstream outputFiles(outputFilePath, std::ios::binary);
+    std::vector<LRun> result;
+    for (SizedRun &run : runs) result.push_back(std::move(run.run));
+
+
+    return result;
+}
+
+LRun LSorterBase::mergeInto(std::vector<LRun> inputs, LRun output, const LIoOptions &outputIo, const std::function<void(const std::vector<LRun> &, const StreamWriter &)> &merge)
+{
+    // 函数执行逻辑：
+    // 1. 如果输入列表为空，直接返回空的归并段；只有一个归并段时直接返回该归并段。
+    // 2. 内存输出已预留全部容量，每批直接追加到输出缓冲区；磁盘输出创建 LBlockWriter，每批交给写者写出。
+    // 3. 调用 merge 完成堆归并，被取消或读写失败时丢弃不完整的输出并重新抛出异常。
+    // 4. 关闭输出文件，丢弃输入归并段，返回输出归并段。
+    // IoUring 后端下，写者在后台写回已满的块，归并循环很少等待磁盘。
+
+    // 处理特殊情况。
+    if (inputs.empty()) return LRun();
+    if (1 == inputs.size()) return inputs[0];
 
-    // 堆归并。
-    while (!pq.empty())
+    // 堆归并是计算，只有写者的调用可能阻塞于磁盘，只在这些调用期间标记阻塞，弹性线程池不会为归并本身补充线程。读取的阻塞由 LRunReader 标记。
+    std::unique_ptr<LBlockWriter> writer;
+
+    try
     {
-        Node node = pq.top();
-        pq.pop();
-        // 写入最小元素。
-        outputFiles.write(reinterpret_cast<char *>(&node.val), sizeof(node.val));
-
-        // 读取该文件下一个元素并加入堆。
-        int v;
-        if (inputFiles[node.fileindex].read(reinterpret_cast<char *>(&v), sizeof(v))) pq.push({v, node.fileindex});
+        if (!output.inMemory())
+        {
+            LThreadPool::BlockingScope blocking;
+
+            writer = std::make_unique<LBlockWriter>(output.filePath(), outputIo);
+        }
+
+        merge(inputs, [&](const char *data, size_t bytes) {
+            if (!writer) output.appendMemory(data, bytes);
+            else
+            {
+                LThreadPool::BlockingScope blocking;
+
+                writer->write(data, bytes);
+            }
+        });
+
+        if (writer)
+        {
+            LThreadPool::BlockingScope blocking;
+
+            writer->close();
+        }
     }
+    catch (...)
+    {
+        // 先销毁写者（等待在途写请求并关闭文件），再丢弃不完整的输出。
+        writer.reset();
+        output.discard();
 
-    // 关闭输入流并删除源文件。
-    for (auto &s : inputFiles) s.close();
-    for (const auto &f : filePaths) std::remove(f.c_str());
+        throw;
+    }
 
+    // 丢弃输入归并段。
+    for (LRun &run : inputs) run.discard();
 
-    return outputFilePath;
+
+    return output;
+}
+
+std::string LSorterBase::tempFilePath(const std::string &defaultDirectory, const std::string &name, size_t stripe) const
+{
+    // 函数执行逻辑：
+    // 1. 未配置临时目录时使用默认目录。
+    // 2. RoundRobin：按序号取模选择目录。
+    // 3. FreeSpace：查询各目录所在文件系统的可用空间，选择最多的目录，查询失败的目录视为没有可用空间。
+    if (m_tempDirectories.empty()) return (std::filesystem::path(defaultDirectory) / name).string();
+
+    size_t selected = stripe % m_tempDirectories.size();
+    if (LSorterOptions::TempPlacement::FreeSpace == m_tempPlacement)
+    {
+        std::uintmax_t mostAvailable = 0;
+        for (size_t i = 0; i < m_tempDirectories.size(); ++i)
+        {
+            std::error_code error;
+            std::filesystem::space_info space = std::filesystem::space(m_tempDirectories[i], error);
+            std::uintmax_t available = error ? 0 : space.available;
+            if (available > mostAvailable) mostAvailable = available, selected = i;
+        }
+    }
+
+
+    return (std::filesystem::path(m_tempDirectories[selected]) / name).string();
 }
+
+
+template class LBasicSorter<int>;
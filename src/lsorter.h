@@ -2,6 +2,12 @@
  * @file lsorter.h
  * @author DavidingPlus (davidingplus@qq.com)
  * @brief 线程池排序类头文件。
+ * @details 排序器以元素类型 T 和比较器 Compare 为模板参数，可以排序任意定长、可平凡复制的记录。实现全部在头文件中，
+ * 每个元素类型与比较器在编译期实例化出各自的排序与归并循环，比较器可以内联，不经过函数指针或虚函数。
+ * 与元素类型无关的部分（选项校验、临时文件放置、流式读写函数）放在非模板的基类 LSorterBase 中。
+ * 块排序的叶子通过 LSortKernel 完成，默认为 std::sort，可以为特定的元素类型与比较器特化，换用基数排序等专用算法。
+ * float 与 double 默认按 LFloatLess 的全序排序，叶子将元素编码为保序的整数键后做基数排序，再解码回原值。
+ * LSorter 是 int 元素升序的实例，在 lsorter.cpp 中显式实例化，使用它的翻译单元不必重复编译排序器。
  *
  * Copyright (c) 2025 电子科技大学 刘治学
  *
@@ -12,61 +18,403 @@
 
 #include <string>
 #include <vector>
+#include <functional>
+#include <istream>
+#include <ostream>
+#include <future>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <algorithm>
+#include <mutex>
+#include <memory>
+#include <filesystem>
+#include <deque>
+#include <type_traits>
+#include <charconv>
+#include <limits>
+#include <exception>
 
 #include "lthreadpool.h"
+#include "lnuma.h"
+#include "lcancellationtoken.h"
+#include "lblockio.h"
+#include "lrunstore.h"
+#include "lsortcursor.h"
+#include "ltaskgraph.h"
+#include "lruncodec.h"
+#include "lmappedfile.h"
+#include "lutil.h"
+#include "lkeyless.h"
+#include "lfloatless.h"
+#include "lradixsort.h"
 
 
 /**
- * @class LSorter
- * @brief 提供线程池并发的排序功能。
- * @details 当前算法的核心思想：
- * 1. 将大文件分块 chunk 加载到内存，使用线程池对每块进行排序并写入临时文件。
- * 2. 对排好序的临时文件进行 k 路归并，每轮可并行处理多组文件，最终生成排序结果。
+ * @struct LSortProgress
+ * @brief 排序作业的进度，由 LSorter::runAsync() 的进度回调上报。
+ */
+struct LSortProgress
+{
+    /**
+     * @brief 排序阶段。任务图中各阶段相互重叠，这里取尚未全部完成的最早阶段。
+     */
+    enum class Phase
+    {
+        Reading = 0, // 仍有块未读入。
+        Sorting,     // 所有块已读入，仍有块未排序写出。
+        Merging,     // 所有归并段已生成，正在归并。
+        Done         // 结果文件已生成。
+    };
+
+    /**
+     * @brief 当前阶段。
+     */
+    Phase phase = Phase::Reading;
+
+    /**
+     * @brief 已读入的字节数与文件总字节数。
+     */
+    uint64_t bytesRead = 0;
+    uint64_t totalBytes = 0;
+
+    /**
+     * @brief 已生成的有序归并段（块临时文件）数量与总数。
+     */
+    size_t runsProduced = 0;
+    size_t totalRuns = 0;
+
+    /**
+     * @brief 已完成的归并轮数与总轮数。
+     */
+    size_t mergeRoundsDone = 0;
+    size_t totalMergeRounds = 0;
+
+    /**
+     * @brief 作业开始至今的时间。
+     */
+    std::chrono::nanoseconds elapsed{0};
+
+    /**
+     * @brief 按已完成工作量线性外推的剩余时间，尚无进度时为 0。
+     */
+    std::chrono::nanoseconds estimatedRemaining{0};
+};
+
+
+/**
+ * @struct LSorterOptions
+ * @brief 排序器构造选项。
  */
-class LSorter
+struct LSorterOptions
+{
+    /**
+     * @brief 每块内存大小，默认 16 MB。
+     */
+    unsigned int chunkSize = 16 * 1024 * 1024;
+
+    /**
+     * @brief k 路归并，每轮并行处理的文件数量，默认 8，至少为 2，否则构造排序器时抛出 std::runtime_error。
+     */
+    unsigned int k = 8;
+
+    /**
+     * @brief 块读取、归并段写出与归并读写使用的块读写选项，默认使用文件流。
+     * @note 设置 io.backend = LIoBackend::IoUring 后，读取与写出整块时保持多个请求在途，归并时每个输入文件在后台预读、输出文件在后台写回。当前系统不支持 io_uring 时自动退化为文件流。
+     * io.direct 只作用于只写一次、读一次的 .partN.sorted 与 tmp_merge_*.bin 临时文件，使其绕过页缓存；输入文件与结果文件分别由 directInput 与 directOutput 控制。
+     * io.cacheHints 是比 O_DIRECT 更轻量的替代：输入文件与临时文件按顺序预读，归并时丢弃游标之后的临时文件页缓存，归并段与归并结果边写边发起写回。
+     */
+    LIoOptions io;
+
+    /**
+     * @brief 读取输入文件时是否使用 O_DIRECT，默认 false。
+     * @note 块缓冲区总是按 4 KiB 对齐，chunkSize 为 4 KiB 的整数倍时每块的文件偏移也对齐，否则该块退化为经过页缓存的读取。
+     */
+    bool directInput = false;
+
+    /**
+     * @brief 写出结果文件（归并树根节点的输出）时是否使用 O_DIRECT，默认 false。
+     */
+    bool directOutput = false;
+
+    /**
+     * @brief 临时文件在多个目录之间的放置策略。
+     */
+    enum class TempPlacement
+    {
+        RoundRobin = 0, // 按归并段与归并输出的序号轮流放置。
+        FreeSpace       // 放到创建时可用空间最多的目录。
+    };
+
+    /**
+     * @brief 存放 .partN.sorted 与 tmp_merge_*.bin 临时文件的目录列表，默认为空。
+     * @note 为空时归并段放在输入文件旁、归并输出放在可执行文件目录，与旧版本一致。配置多个位于不同磁盘的目录时，归并段按 tempPlacement 条带化分布，
+     * 同一组归并的输入来自不同磁盘，IoUring 后端下各输入的预读请求同时在多个设备上在途。目录不存在时构造函数抛出 std::runtime_error。
+     * 无论是否配置，最终成为结果文件的那个文件都写在结果文件所在的目录，保证最后的重命名不跨文件系统。
+     */
+    std::vector<std::string> tempDirectories;
+
+    /**
+     * @brief 临时目录的放置策略，默认轮流放置。
+     */
+    TempPlacement tempPlacement = TempPlacement::RoundRobin;
+
+    /**
+     * @brief 留在内存中的归并段总字节数上限，默认 0 表示所有归并段都写到磁盘。
+     * @note 预算足够时，排好序的块缓冲区直接作为内存归并段保留，中间归并结果也写入内存，归并时零拷贝读取；超出预算的归并段照常写到临时文件。
+     * 预算由同一个 LSorter 上并发执行的所有作业共享，不包括正在读入与排序的块缓冲区。
+     */
+    uint64_t memoryBudget = 0;
+
+    /**
+     * @brief 是否压缩写到磁盘的临时归并段，默认 false。
+     * @note 开启后 .partN.sorted 与 tmp_merge_*.bin 以 LRunCodec 的差分 + 位打包格式写出，归并时逐帧解码，读写的字节数随相邻差值的位数成比例减少，
+     * 适合磁盘带宽是瓶颈的场景。内存归并段与结果文件始终为原始的元素数组。差分编码只适用于 int 元素，其他元素类型忽略此项。
+     */
+    bool compressRuns = false;
+
+    /**
+     * @brief 是否以内存映射的方式读取输入文件，默认 false。
+     * @note 开启后输入文件被只读映射，各读取节点不再按顺序串联，而是由 I/O 通道的多个工作线程按块偏移并发地从映射中复制各自的块，
+     * 复制前以 MADV_WILLNEED 一次性发起该块的预读。只对非空的普通文件生效，管道等无法映射的输入以及开启 directInput 时仍按偏移顺序读取。
+     */
+    bool mapInput = false;
+
+    /**
+     * @brief 同时读取输入文件的读者数量，默认 1 表示所有块按顺序依次读取。
+     * @note 输入为定长记录，第 i 块的文件偏移可以直接算出。设为 N 时读取节点分为 N 条链，第 i 块在第 i - N 块读完后读取，
+     * 最多 N 个 I/O 通道工作线程同时以各自的偏移读取不同的块，适合条带化存储或 NVMe 等单线程同步读取跑不满带宽的设备。
+     * 实际并发度还受线程池 I/O 通道线程数的限制。输入文件已映射时各块本就并发复制，不受此项限制。设为 0 等同于 1。
+     */
+    unsigned int inputReaders = 1;
+
+    /**
+     * @brief 输入与结果的格式。
+     */
+    enum class Format
+    {
+        Binary = 0, // 元素的原始字节数组。
+        Text        // 十进制整数文本。
+    };
+
+    /**
+     * @brief 输入格式，默认 Binary。
+     * @note 设为 Text 时输入为以空白或逗号分隔的十进制整数，例如每行一个整数或 CSV 的一行，允许前导的 '+' 与 '-'，
+     * 出现其他字符或超出元素类型的取值范围时抛出 std::runtime_error。文本按 chunkSize 字节分块并截断到最后一个分隔符，跨块的数字留到下一块，
+     * 每块在线程池上切成多段并行解析后排序；块的边界只能顺序确定，因此文件输入也按流式排序的流程读取，inputReaders 与 mapInput 不起作用，
+     * 进度回调只在结束时调用一次。只适用于整数元素类型，其他类型的构造函数抛出 std::runtime_error。
+     */
+    Format inputFormat = Format::Binary;
+
+    /**
+     * @brief 结果格式，默认 Binary。
+     * @note 设为 Text 时结果文件或输出流为每行一个十进制整数，最后一轮归并的结果按批在线程池上并行格式化后按顺序写出。
+     * 游标始终返回元素本身，不受此项影响。只适用于整数元素类型，其他类型的构造函数抛出 std::runtime_error。
+     */
+    Format outputFormat = Format::Binary;
+};
+
+
+/**
+ * @struct LSortKernel
+ * @brief 块排序叶子使用的排序算法，默认为 std::sort。
+ * @tparam T 元素类型。
+ * @tparam Compare 比较器。
+ * @note 可以为特定的元素类型与比较器特化，sort() 须按 Compare 将 [first, last) 排为有序。
+ */
+template <typename T, typename Compare>
+struct LSortKernel
+{
+    static void sort(T *first, T *last, const Compare &compare)
+    {
+        std::sort(first, last, compare);
+    }
+};
+
+/**
+ * @brief 浮点数全序排序：编码为 LFloatKey 的整数键，基数排序后解码回原值。
+ * @note 键与元素等宽，叶子排序期间另需两倍于该段的辅助内存。元素较少时基数排序的直方图开销占优，仍使用 std::sort。
+ */
+template <typename F>
+struct LSortKernel<F, LFloatLess<F>>
+{
+    static void sort(F *first, F *last, const LFloatLess<F> &compare)
+    {
+        constexpr size_t minRadixCount = 1024;
+
+        size_t count = static_cast<size_t>(last - first);
+        if (count < minRadixCount)
+        {
+            std::sort(first, last, compare);
+
+            return;
+        }
+
+        using Bits = typename LFloatKey<F>::Bits;
+        std::vector<Bits> keys(count);
+        std::vector<Bits> scratch(count);
+        for (size_t i = 0; i < count; ++i) keys[i] = LFloatKey<F>::encode(first[i]);
+
+        const Bits *sorted = LRadixSort::sort(keys.data(), scratch.data(), count);
+        for (size_t i = 0; i < count; ++i) first[i] = LFloatKey<F>::decode(sorted[i]);
+    }
+};
+
+
+/**
+ * @class LSorterBase
+ * @brief 排序器中与元素类型无关的部分：选项、临时文件放置与流式读写函数。
+ */
+class LSorterBase
 {
 public:
 
+    /**
+     * @brief 进度回调类型。
+     * @note 回调在线程池工作线程上调用，同一作业的回调互斥执行，不会并发。回调抛出的异常会使作业失败。
+     */
+    using ProgressCallback = std::function<void(const LSortProgress &)>;
+
     /**
      * @brief 构造函数。
      * @param pool 外部线程池指针，用于并行排序和归并任务。
-     * @param chunkSize 每块内存大小，默认 16 MB。
-     * @param k k 路归并，每轮并行处理的文件数量，默认 8。
+     * @param options 排序器构造选项。
+     * @param elementSize 元素字节数，临时文件的块读写大小向上取整为它的整数倍，使每块都由完整的元素组成。
+     * @param compressible 元素类型是否支持 LRunCodec 压缩，不支持时忽略 options.compressRuns。
+     * @note pool 为空或临时目录不存在时抛出 std::runtime_error。
      */
-    LSorter(LThreadPool *pool, unsigned int chunkSize = 16 * 1024 * 1024, unsigned int k = 8);
+    LSorterBase(LThreadPool *pool, const LSorterOptions &options, size_t elementSize, bool compressible);
 
     /**
      * @brief 析构函数。
      */
-    virtual ~LSorter();
+    virtual ~LSorterBase();
+
+protected:
 
     /**
-     * @brief 执行整个排序算法，最终生成 xxx.sorted 文件。
-     * @param filePath 待排序文件路径。
+     * @brief 流式输入函数：向缓冲区读取至多 bytes 字节，返回读到的字节数，0 表示输入结束。
      */
-    void run(const std::string &filePath);
+    using StreamReader = std::function<size_t(char *, size_t)>;
 
-private:
+    /**
+     * @brief 流式输出函数：写出全部 bytes 字节。
+     */
+    using StreamWriter = std::function<void(const char *, size_t)>;
 
     /**
-     * @brief 将单个块排序后写入临时文件。
-     * @param filePath 原始文件名，用于生成临时文件名。
-     * @param index 块索引。
-     * @param data 排序后的数据。
-     * @return 返回生成的临时文件名。
+     * @brief 构造只指定块大小与归并路数、其余为默认值的配置，供按旧接口构造的委托构造函数使用。
      */
-    std::string writeSortedChunk(const std::string &filePath, unsigned int index, const std::vector<int> &data);
+    static LSorterOptions sizeOptions(unsigned int chunkSize, unsigned int k);
 
     /**
-     * @brief k 路归并算法。
-     * @param filePaths 待归并文件路径列表。
-     * @param index 当前归并轮次索引，用于生成临时文件名。
-     * @return 返回归并后的新文件路径。
+     * @brief 取得下一个作业编号，写入临时文件名，多个作业并发执行时临时文件互不冲突。
      */
-    std::string mergeKFiles(const std::vector<std::string> &filePaths, unsigned int index);
+    static unsigned int nextJob();
 
+    /**
+     * @brief 从输入流读取的流式输入函数，读到末尾返回 0，读取失败时抛出 std::runtime_error。
+     */
+    static StreamReader streamReader(std::istream &input);
+
+    /**
+     * @brief 写到输出流的流式输出函数，写出失败时抛出 std::runtime_error。
+     */
+    static StreamWriter streamWriter(std::ostream &output);
+
+    /**
+     * @brief 从文件描述符读取的流式输入函数，被信号中断时重试。仅 Linux 可用，其他平台抛出 std::runtime_error。
+     */
+    static StreamReader fdReader(int fd);
+
+    /**
+     * @brief 写到文件描述符的流式输出函数，被信号中断或部分写出时继续写。仅 Linux 可用，其他平台抛出 std::runtime_error。
+     */
+    static StreamWriter fdWriter(int fd);
+
+    /**
+     * @brief 读取一块文本，截断到最后一个分隔符之后，跨块的记录留到下一块。
+     * @param read 输入函数。
+     * @param chunkBytes 每块的字节数。块内没有分隔符时扩大该块，直到读到分隔符或输入结束。
+     * @param isSeparator 判断字节是否为分隔符。
+     * @param carry 上一块末尾未完成的记录，读取时放在块的开头，返回时换为本块末尾未完成的记录。
+     * @param text 输出参数，块的内容；为空表示输入已结束。
+     * @return 是否已读到输入末尾。
+     */
+    static bool readTextChunk(const StreamReader &read, size_t chunkBytes, bool (*isSeparator)(char), std::vector<char> &carry, LRunBufferT<char> &text);
+
+    /**
+     * @brief 从文件按偏移顺序读取的流式输入函数，使用 m_inputIo。文件无法打开时抛出 std::runtime_error。
+     */
+    StreamReader fileReader(const std::string &filePath) const;
+
+    /**
+     * @brief 判断字节是否为文本整数的分隔符：空白或逗号。
+     */
+    static bool isNumberSeparator(char c)
+    {
+        return ' ' == c || '\n' == c || ',' == c || '\t' == c || '\r' == c || '\v' == c || '\f' == c;
+    }
+
+    /**
+     * @brief 归并段与其大小（元素个数或字节数），大小用于为归并输出预留内存。
+     */
+    struct SizedRun
+    {
+        LRun run;    // 归并段。
+        size_t size; // 归并段的大小。
+    };
+
+    /**
+     * @brief 块任务：在线程池上排序一块，在内存预算内接管为内存归并段，否则写到临时文件。
+     */
+    using ChunkTask = std::function<SizedRun()>;
+
+    /**
+     * @brief 块读取函数：在调用线程上读取第 chunk 块，缓冲区分配在 node 上，返回排序该块的任务，该块需要写到磁盘时写到 path；输入已结束时返回空函数。
+     */
+    using ChunkReader = std::function<ChunkTask(size_t chunk, int node, const std::string &path)>;
+
+    /**
+     * @brief 组归并函数：将一组归并段归并为一个，总大小为 size，无法留在内存中时写到 path。成功时丢弃输入；失败时丢弃不完整的输出并重新抛出异常，输入保留。
+     */
+    using GroupMerge = std::function<LRun(std::vector<LRun> group, size_t size, const std::string &path)>;
+
+    /**
+     * @brief 读取整个输入，生成有序归并段并归并到不超过 m_k 个，LBasicSorter 与 LLineSorter 流式排序的共同实现。
+     * @param readChunk 块读取函数。
+     * @param mergeGroup 组归并函数。
+     * @param maxInFlight 同时在途的块任务数。
+     * @param partPrefix 块归并段临时文件名的前缀。
+     * @param extension 临时文件的扩展名。
+     * @param token 取消令牌。
+     * @return 不超过 m_k 个归并段，由调用者负责丢弃。失败时已丢弃所有归并段。
+     */
+    std::vector<LRun> generateRuns(const ChunkReader &readChunk, const GroupMerge &mergeGroup, size_t maxInFlight, const std::string &partPrefix, const std::string &extension, const LCancellationToken &token);
+
+    /**
+     * @brief 将若干归并段归并到输出归并段，LBasicSorter::mergeKFiles() 与 LLineSorter 归并的共同实现。
+     * @param inputs 待归并的归并段列表。
+     * @param output 输出归并段：已预留容量的内存归并段，或指定输出文件路径的磁盘归并段。
+     * @param outputIo 写出磁盘归并段使用的块读写选项。
+     * @param merge 堆归并函数，以输入列表与输出函数调用，按批输出原始字节（压缩输出由它先行编码）。
+     * @return 写好的输出归并段，只有一个输入时直接返回该输入。
+     * @note 成功时丢弃输入；失败时先关闭写者，再丢弃不完整的输出并重新抛出异常，输入保留，由调用者清理。
+     */
+    static LRun mergeInto(std::vector<LRun> inputs, LRun output, const LIoOptions &outputIo, const std::function<void(const std::vector<LRun> &, const StreamWriter &)> &merge);
+
+    /**
+     * @brief 为临时文件选择目录并生成完整路径。
+     * @param defaultDirectory 未配置临时目录时使用的目录，可以为空表示当前目录。
+     * @param name 文件名。
+     * @param stripe 轮流放置时的序号。
+     * @return 临时文件路径。
+     */
+    std::string tempFilePath(const std::string &defaultDirectory, const std::string &name, size_t stripe) const;
 
-private:
+
+protected:
 
     /**
      * @brief 外部线程池指针。
@@ -82,7 +430,1179 @@ private:
      * @brief k 路归并的文件数量。
      */
     unsigned int m_k = 0;
+
+    /**
+     * @brief 临时文件的块读写选项。
+     */
+    LIoOptions m_io;
+
+    /**
+     * @brief 读取输入文件与写出结果文件的块读写选项，除 direct 外与 m_io 相同。
+     */
+    LIoOptions m_inputIo;
+    LIoOptions m_outputIo;
+
+    /**
+     * @brief 临时文件目录列表与放置策略。
+     */
+    std::vector<std::string> m_tempDirectories;
+    LSorterOptions::TempPlacement m_tempPlacement = LSorterOptions::TempPlacement::RoundRobin;
+
+    /**
+     * @brief 内存归并段的预算，所有作业共享。
+     */
+    LRunStore m_runStore;
+
+    /**
+     * @brief 是否压缩写到磁盘的临时归并段。
+     */
+    bool m_compressRuns = false;
+
+    /**
+     * @brief 是否以内存映射的方式读取输入文件。
+     */
+    bool m_mapInput = false;
+
+    /**
+     * @brief 同时读取输入文件的读者数量。
+     */
+    unsigned int m_inputReaders = 1;
+
+    /**
+     * @brief 输入与结果的格式。
+     */
+    LSorterOptions::Format m_inputFormat = LSorterOptions::Format::Binary;
+    LSorterOptions::Format m_outputFormat = LSorterOptions::Format::Binary;
 };
 
 
+/**
+ * @class LBasicSorter
+ * @brief 提供线程池并发的排序功能。
+ * @tparam T 定长元素类型，须可平凡复制，输入文件与结果文件都是 T 的原始数组。
+ * @tparam Compare 严格弱序比较器，默认升序，float 与 double 默认为 LFloatLess 全序。
+ * @details 当前算法的核心思想：
+ * 1. 将大文件分块 chunk 加载到内存，使用线程池对每块进行排序，作为有序归并段留在内存预算内或写入临时文件。
+ * 2. 对有序归并段进行 k 路归并，每轮可并行处理多组归并段，最终生成排序结果。
+ * 整个过程（读取、块排序、归并树）表示为一张 LTaskGraph 任务图，归并节点在其所有输入完成后立即执行。
+ * runAsync() 将排序作为线程池任务异步执行并通过回调上报进度，多个排序作业可以在同一线程池上重叠执行。
+ * sortStream() 从管道等长度未知的输入流读取数据，边读边排序生成归并段，最后一轮归并直接写到输出流，不生成结果文件。
+ * openCursor() 在最后一轮归并之前停下，返回一个游标，由调用者按批拉取最后一轮归并的结果。
+ * 整数元素的输入与结果可以是十进制文本（LSorterOptions::inputFormat / outputFormat）：文本块在线程池上切段并行解析，结果按批并行格式化。
+ * 比较器为 LKeyLess 时进入记录模式：块排序只排序（键，下标）标签，再一次性重排记录；归并堆只缓存键与记录地址，每个元素只在写入批缓冲区时复制一次。
+ * 排序可以通过 LCancellationToken 协作式取消或设置截止时间：每个节点开始前、块排序拆分时以及归并循环中都会检查令牌，取消后尚未开始的节点不再执行，已生成的临时文件全部删除。
+ */
+template <typename T, typename Compare = LDefaultLess<T>>
+class LBasicSorter : public LSorterBase
+{
+    static_assert(std::is_trivially_copyable<T>::value, "LBasicSorter requires a trivially copyable element type.");
+
+public:
+
+    /**
+     * @brief 构造函数。
+     * @param pool 外部线程池指针，用于并行排序和归并任务。
+     * @param chunkSize 每块内存大小，默认 16 MB。
+     * @param k k 路归并，每轮并行处理的文件数量，默认 8。
+     */
+    LBasicSorter(LThreadPool *pool, unsigned int chunkSize = 16 * 1024 * 1024, unsigned int k = 8);
+
+    /**
+     * @brief 构造函数，按选项创建排序器。
+     * @param pool 外部线程池指针，用于并行排序和归并任务。
+     * @param options 排序器构造选项。
+     * @param compare 比较器。
+     */
+    LBasicSorter(LThreadPool *pool, const LSorterOptions &options, Compare compare = Compare());
+
+    /**
+     * @brief 执行整个排序算法，最终生成 xxx.sorted 文件。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌，默认永不取消。
+     * @note 只有 T 为算术类型时才输出前 100 个元素。令牌被取消或超过截止时间时抛出 LCancelledError；无论因取消还是其他异常失败，返回前都会删除所有 .partN.sorted 与 tmp_merge_*.bin 临时文件。正在执行的单次 std::sort 与文件写出无法中断，取消延迟最多为一个排序叶子或一次块写出的时间。
+     */
+    void run(const std::string &filePath, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 异步执行排序，立即返回。
+     * @param filePath 待排序文件路径。
+     * @param callback 进度回调，默认为空表示不上报进度。读入每块、生成每个归并段、完成每次归并以及结束时各调用一次。
+     * @param token 取消令牌，默认永不取消。
+     * @return std::future<void> 排序完成时就绪，失败或被取消时保存对应异常。
+     * @note 作业作为一个任务提交到线程池执行，宿主工作线程在等待任务图期间帮助执行队列中的任务，因此多个作业可以在同一线程池上重叠执行而不会各自占用一个阻塞线程。与 run() 不同，本函数不输出数据到 std::cout，文件无法打开时抛出 std::runtime_error。LSorter 对象需存活到 future 就绪。
+     */
+    std::future<void> runAsync(const std::string &filePath, ProgressCallback callback = nullptr, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 流式排序：从输入流读取长度未知的元素序列，排序后写入输出流。
+     * @param input 输入流，读到末尾为止，末尾不足一个元素的字节被忽略。
+     * @param output 输出流。
+     * @param token 取消令牌，默认永不取消。
+     * @note 输入按 chunkSize 分块，读入下一块的同时对已读入的块排序，生成的归并段在内存预算内留在内存中，否则写到临时目录（未配置时为可执行文件目录）。
+     * 归并段多于 k 个时先归并到不超过 k 个，最后一轮归并直接写到输出流，省去结果文件的一次完整写出、读回与重命名。
+     * 读写失败时抛出 std::runtime_error，取消时抛出 LCancelledError，返回前删除所有临时文件；已写到输出流的数据无法撤回。
+     */
+    void sortStream(std::istream &input, std::ostream &output, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 流式排序，从文件描述符读取、写入文件描述符，例如管道或 STDIN_FILENO / STDOUT_FILENO。
+     * @param inputFd 输入文件描述符。
+     * @param outputFd 输出文件描述符。
+     * @param token 取消令牌，默认永不取消。
+     * @note 行为同上，文件描述符不会被关闭。仅 Linux 可用，其他平台抛出 std::runtime_error。
+     */
+    void sortStream(int inputFd, int outputFd, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 排序文件，但不生成结果文件，返回按批拉取排序结果的游标。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌，默认永不取消，游标读取期间同样有效。
+     * @return 排序结果游标。
+     * @note 与 run() 相同地读取、排序并归并，归并到不超过 k 个归并段时返回，最后一轮归并在游标的 next() 中惰性进行，
+     * 结果不经过 tmp_merge_*.bin 到 .sorted 的写出与读回。只有一块时该块作为归并段交给游标。文件无法打开时抛出 std::runtime_error。
+     * 游标不依赖 LSorter 对象，可以比它存活更久。
+     */
+    std::unique_ptr<LBasicSortCursor<T, Compare>> openCursor(const std::string &filePath, const LCancellationToken &token = LCancellationToken());
+
+    /**
+     * @brief 对长度未知的输入流排序，返回按批拉取排序结果的游标。
+     * @param input 输入流，返回前读到末尾，末尾不足一个元素的字节被忽略。
+     * @param token 取消令牌，默认永不取消，游标读取期间同样有效。
+     * @return 排序结果游标。
+     * @note sortStream() 即按此游标逐批写到输出流。
+     */
+    std::unique_ptr<LBasicSortCursor<T, Compare>> openCursor(std::istream &input, const LCancellationToken &token = LCancellationToken());
+
+private:
+
+    /**
+     * @brief 块缓冲区类型，内存分配在处理该块的工作线程所在的 NUMA 节点上，排好序后可以直接作为内存归并段。
+     */
+    using ChunkBuffer = LRunBufferT<T>;
+
+    /**
+     * @brief 归并输出回调：接收一批有序的元素。
+     */
+    using BatchCallback = std::function<void(const T *, size_t)>;
+
+    /**
+     * @brief 排序文件并生成 xxx.sorted 文件，run() 与 runAsync() 的共同实现。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌。
+     * @param callback 进度回调，可以为空。
+     * @param finalRuns 为空时生成结果文件；否则不生成结果文件，归并到不超过 m_k 个归并段后将其存入 finalRuns，由调用者负责丢弃。
+     */
+    void sortFile(const std::string &filePath, const LCancellationToken &token, const ProgressCallback &callback, std::vector<LRun> *finalRuns = nullptr);
+
+    /**
+     * @brief 排序文本输入或生成文本结果的文件，生成 xxx.sorted 文件。输入或结果为文本时 run() 与 runAsync() 的实现。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌。
+     * @param callback 进度回调，可以为空，只在结束时以 Done 阶段调用一次。
+     * @note 失败时删除不完整的结果文件。
+     */
+    void sortTextFile(const std::string &filePath, const LCancellationToken &token, const ProgressCallback &callback);
+
+    /**
+     * @brief 按输入格式读取并排序文件，归并到不超过 m_k 个归并段。
+     * @param filePath 待排序文件路径。
+     * @param token 取消令牌。
+     * @return 不超过 m_k 个归并段，由调用者负责丢弃。
+     */
+    std::vector<LRun> fileRuns(const std::string &filePath, const LCancellationToken &token);
+
+    /**
+     * @brief 流式排序，两个 sortStream() 的共同实现。
+     * @param read 输入函数。
+     * @param write 输出函数。
+     * @param token 取消令牌。
+     */
+    void streamSort(const StreamReader &read, const StreamWriter &write, const LCancellationToken &token);
+
+    /**
+     * @brief 读取整个输入流，生成有序归并段并归并到不超过 m_k 个。
+     * @param read 输入函数。
+     * @param token 取消令牌。
+     * @return 不超过 m_k 个归并段，由调用者负责丢弃。失败时已丢弃所有归并段。
+     */
+    std::vector<LRun> streamRuns(const StreamReader &read, const LCancellationToken &token);
+
+    /**
+     * @brief 将游标拉取的最后一轮归并结果按结果格式写出。
+     * @param cursor 排序结果游标。
+     * @param write 输出函数。
+     * @param token 取消令牌，每批格式化前检查。
+     * @note 文本结果攒够约 formatBatchCount 个元素后切成多段，在线程池上并行格式化，再按顺序写出。
+     */
+    void writeResult(LBasicSortCursor<T, Compare> &cursor, const StreamWriter &write, const LCancellationToken &token);
+
+    /**
+     * @brief 并行解析一块文本。
+     * @param text 文本块，以分隔符结束或为输入的最后一块，数字不会跨块。
+     * @param token 取消令牌。
+     * @return 块内的整数，按出现的顺序，分配在与 text 相同的 NUMA 节点上。
+     * @note 块按字节数切成至多线程数段，切点后移到下一个分隔符，各段在线程池上并行解析后拼接。出现非法字符或超出取值范围时抛出 std::runtime_error。
+     */
+    ChunkBuffer parseText(const LRunBufferT<char> &text, const LCancellationToken &token);
+
+    /**
+     * @brief 解析一段文本中以分隔符分隔的十进制整数，追加到 values。
+     */
+    static void parseNumbers(const char *first, const char *last, std::vector<T> &values);
+
+    /**
+     * @brief 将元素格式化为每行一个的十进制整数，追加到 text。
+     */
+    static void formatNumbers(const T *first, const T *last, std::string &text);
+
+    /**
+     * @brief 并行处理 pieces 段：第 0 段在当前线程处理，其余各段作为同一 NUMA 节点上的线程池子任务。
+     * @param pieces 段数。
+     * @param work 以段号调用的处理函数。
+     * @param token 取消令牌，每段开始前检查。
+     * @note 等待所有段结束后重新抛出第一个异常。
+     */
+    template <typename F>
+    void forEachPiece(size_t pieces, const F &work, const LCancellationToken &token);
+
+    /**
+     * @brief 排序整个块。
+     * @param buffer 块缓冲区。
+     * @param token 取消令牌。
+     * @note 比较器为 LKeyLess 且记录大于（键，下标）标签时，只排序标签，再按标签将每条记录复制一次到同一 NUMA 节点上的新缓冲区，
+     * 替换原缓冲区。重排期间该块的内存占用短暂加倍。
+     */
+    void sortChunk(ChunkBuffer &buffer, const LCancellationToken &token);
+
+    /**
+     * @brief 对区间进行排序，必要时拆分为线程池子任务并行排序（嵌套并行）。
+     * @tparam E 元素类型：块内记录或排序标签。
+     * @tparam C 比较器。
+     * @param first 区间起始地址。
+     * @param last 区间结束地址。
+     * @param depth 当前拆分深度，顶层调用传 0。
+     * @param compare 比较器。
+     * @param token 取消令牌，每次拆分与排序前检查。
+     */
+    template <typename E, typename C>
+    void sortRange(E *first, E *last, unsigned int depth, const C &compare, const LCancellationToken &token);
+
+    /**
+     * @brief 将单个块排序后写入临时文件。
+     * @param outputFilePath 临时文件路径。
+     * @param data 排序后的数据。
+     * @param io 写出使用的块读写选项，该块即为最终结果时使用结果文件的选项。
+     * @param compress 是否以 LRunCodec 压缩格式写出，仅对 int 元素有效。
+     * @note 写出失败时删除不完整的临时文件并抛出 std::runtime_error。
+     */
+    void writeSortedChunk(const std::string &outputFilePath, const ChunkBuffer &data, const LIoOptions &io, bool compress);
+
+    /**
+     * @brief k 路归并算法。
+     * @param inputs 待归并的归并段列表，内存归并段零拷贝读取。
+     * @param output 输出归并段：已预留容量的内存归并段，或指定输出文件路径的磁盘归并段，磁盘归并段标记为压缩时以 LRunCodec 格式写出。
+     * @param outputIo 写出磁盘归并段使用的块读写选项，根节点使用结果文件的选项。
+     * @param token 取消令牌，归并循环中定期检查。
+     * @return 返回写好的输出归并段，只有一个输入时直接返回该输入。
+     * @note 成功时丢弃输入（删除输入文件，放弃本函数持有的内存引用）。被取消或读写失败时丢弃不完整的输出并重新抛出异常，输入保留，由调用者清理。
+     */
+    LRun mergeKFiles(std::vector<LRun> inputs, LRun output, const LIoOptions &outputIo, const LCancellationToken &token);
+
+    /**
+     * @brief 将若干归并段堆归并，按批输出。mergeKFiles() 与流式排序最后一轮归并的共同实现。
+     * @param inputs 待归并的归并段列表，不会被丢弃。
+     * @param emit 输出回调，每批最多 m_io.blockSize 字节。
+     * @param token 取消令牌，归并循环中定期检查。
+     */
+    void mergeRuns(const std::vector<LRun> &inputs, const BatchCallback &emit, const LCancellationToken &token);
+
+
+private:
+
+    /**
+     * @brief 比较器。
+     */
+    Compare m_compare;
+};
+
+/**
+ * @brief int 元素升序排序器。
+ */
+using LSorter = LBasicSorter<int>;
+
+
+template <typename T, typename Compare>
+inline LBasicSorter<T, Compare>::LBasicSorter(LThreadPool *pool, unsigned int chunkSize, unsigned int k) : LBasicSorter(pool, sizeOptions(chunkSize, k))
+{
+}
+
+template <typename T, typename Compare>
+inline LBasicSorter<T, Compare>::LBasicSorter(LThreadPool *pool, const LSorterOptions &options, Compare compare)
+    : LSorterBase(pool, options, sizeof(T), std::is_same<T, int>::value), m_compare(std::move(compare))
+{
+    if constexpr (!std::is_integral<T>::value || std::is_same<T, bool>::value)
+    {
+        if (LSorterOptions::Format::Text == m_inputFormat || LSorterOptions::Format::Text == m_outputFormat) throw std::runtime_error("Text input and output formats require an integer element type.");
+    }
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::run(const std::string &filePath, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 打开待排序的二进制文件，打不开时直接返回。
+    // 2.（可选）读取文件前 100 个元素并输出，用于原始数据调试。
+    // 3. 调用 sortFile() 执行排序，不上报进度；输入或结果为文本时调用 sortTextFile()。
+    // 4. （可选）输出最终排序文件前 100 个元素，用于排序结果验证。
+
+    token.throwIfCancelled();
+
+    // 打开文件。
+    std::ifstream ifs(filePath, std::ios::binary);
+    if (!ifs) return;
+
+    // 输入或结果为文本时不输出元素。
+    if (LSorterOptions::Format::Binary != m_inputFormat || LSorterOptions::Format::Binary != m_outputFormat)
+    {
+        ifs.close();
+        sortTextFile(filePath, token, nullptr);
+
+        return;
+    }
+
+    // （可选）读取原始数据前 100 个元素。只有算术类型可以直接输出。
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+        std::vector<T> originalData;
+        T val;
+        while (ifs.read(reinterpret_cast<char *>(&val), sizeof(val)) && originalData.size() < 100) originalData.push_back(val);
+
+        std::cout << "Original data (first 100): ";
+        for (auto x : originalData) std::cout << +x << " ";
+        std::cout << std::endl;
+    }
+
+    ifs.close();
+
+    sortFile(filePath, token, nullptr);
+
+    // （可选）输出最终排序前 100 个元素。
+    if constexpr (std::is_arithmetic<T>::value)
+    {
+        std::ifstream sortedFile(filePath + ".sorted", std::ios::binary);
+        std::vector<T> sortedData;
+        T val;
+        while (sortedFile.read(reinterpret_cast<char *>(&val), sizeof(val)) && sortedData.size() < 100) sortedData.push_back(val);
+
+        std::cout << "Sorted data (first 100): ";
+        for (auto x : sortedData) std::cout << +x << " ";
+        std::cout << std::endl;
+    }
+}
+
+template <typename T, typename Compare>
+inline std::future<void> LBasicSorter<T, Compare>::runAsync(const std::string &filePath, ProgressCallback callback, const LCancellationToken &token)
+{
+    // 排序作为一个线程池任务执行。任务内部的 graph.run() 通过线程池感知的 wait() 等待，
+    // 等待期间宿主工作线程会帮助执行队列中的任务（包括其他排序作业的节点），不会有线程专门阻塞在某个作业上。
+
+
+    return m_pool->enqueue([this, filePath, callback = std::move(callback), token]() {
+        if (LSorterOptions::Format::Binary == m_inputFormat && LSorterOptions::Format::Binary == m_outputFormat) sortFile(filePath, token, callback);
+        else sortTextFile(filePath, token, callback);
+    });
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::sortFile(const std::string &filePath, const LCancellationToken &token, const ProgressCallback &callback, std::vector<LRun> *finalRuns)
+{
+    // 函数执行逻辑：
+    // 1. 打开待排序的二进制文件，由文件大小计算出块数。
+    // 2. 将整个排序过程表示为一张任务图（DAG）：
+    //   - 读取节点 read[i]（I/O 通道）：按偏移读取第 i 块。读取节点分为 m_inputReaders 条链，read[i] 依赖 read[i - m_inputReaders]，
+    //     同时最多 m_inputReaders 个读取在途，默认一条链即按顺序读取整个文件。输入文件已映射时各读取节点互不依赖，并发地从映射中复制。
+    //   - 排序节点 sort[i]（计算通道）：依赖 read[i]，排序第 i 块。
+    //   - 写出节点 write[i]（I/O 通道，高优先级）：依赖 sort[i]，内存预算足够时块缓冲区直接作为内存归并段，否则写入临时文件并释放内存。
+    //   - 归并节点（计算通道，高优先级）：按 k 路归并树分组，每组最多 m_k 个归并段，依赖组内所有子节点，单个归并段直接进入上一层。
+    //     非根节点的输出在内存预算内写入内存，否则写入临时文件；根节点总是写入结果文件所在目录。
+    // 3. 执行任务图。每个节点在其依赖全部完成的瞬间即被调度，某棵子树的块排序完成后即可开始归并，轮次之间没有屏障等待。
+    //   每个节点开始前检查取消令牌，某个节点因取消或错误抛出异常后，任务图不再执行其余节点的任务体。
+    //   读取、写出与归并节点完成后更新进度并回调。
+    // 4. 若任务图失败，丢弃所有已生成的归并段（删除临时文件、释放内存）并重新抛出异常。
+    // 5. 将归并树根节点的文件重命名为原文件名 + ".sorted"，回调 Done 阶段。
+    // 指定 finalRuns 时归并树只建到不超过 m_k 个归并段，没有根节点，任务图执行完后将这些归并段交给调用者，不生成结果文件。
+
+    token.throwIfCancelled();
+
+    // 打开文件。
+    std::ifstream ifs(filePath, std::ios::binary);
+    if (!ifs) throw std::runtime_error("Failed to open " + filePath + ".");
+
+    // 计算元素总数与块数。
+    ifs.seekg(0, std::ios::end);
+    size_t totalCount = static_cast<size_t>(ifs.tellg()) / sizeof(T);
+    ifs.close();
+
+    size_t chunkCount = std::max<size_t>(1, m_chunkSize / sizeof(T));
+    size_t chunks = (totalCount + chunkCount - 1) / chunkCount;
+
+    std::string finalFilePath = filePath + ".sorted";
+
+    // 输入文件所在目录与文件名。结果文件与输入文件同目录，最终成为结果文件的那个文件也写在这里，重命名不跨文件系统。
+    std::filesystem::path inputPath(filePath);
+    std::string inputDirectory = inputPath.parent_path().string();
+    std::string inputName = inputPath.filename().string();
+
+    // 进度。各节点在不同线程上完成，更新与回调都在 progressMutex 内进行，回调无需自己保证线程安全。
+    // 剩余时间按工作量线性外推：读取与生成归并段各计一遍数据量，每个归并节点计其输出的数据量。
+    std::mutex progressMutex;
+    LSortProgress progress;
+    progress.totalBytes = totalCount * sizeof(T);
+    progress.totalRuns = chunks;
+
+    uint64_t totalWork = 2 * progress.totalBytes;
+    uint64_t doneWork = 0;
+    std::vector<size_t> roundRemaining; // 每轮尚未完成的归并节点数量。
+    auto start = std::chrono::steady_clock::now();
+
+    auto report = [&](uint64_t work, const std::function<void(LSortProgress &)> &update) {
+        if (!callback) return;
+
+        std::unique_lock<std::mutex> lock(progressMutex);
+        update(progress);
+        doneWork += work;
+
+        if (progress.bytesRead < progress.totalBytes) progress.phase = LSortProgress::Phase::Reading;
+        else if (progress.runsProduced < progress.totalRuns) progress.phase = LSortProgress::Phase::Sorting;
+        else progress.phase = LSortProgress::Phase::Merging;
+
+        progress.elapsed = std::chrono::steady_clock::now() - start;
+        progress.estimatedRemaining = std::chrono::nanoseconds(0);
+        if (doneWork > 0 && totalWork > doneWork)
+            progress.estimatedRemaining = std::chrono::nanoseconds(static_cast<int64_t>(static_cast<double>(progress.elapsed.count()) * (totalWork - doneWork) / doneWork));
+
+        callback(progress);
+    };
+
+    auto reportDone = [&]() {
+        if (!callback) return;
+
+        std::unique_lock<std::mutex> lock(progressMutex);
+        progress.phase = LSortProgress::Phase::Done;
+        progress.elapsed = std::chrono::steady_clock::now() - start;
+        progress.estimatedRemaining = std::chrono::nanoseconds(0);
+
+        callback(progress);
+    };
+
+    // 空文件直接生成空的结果文件。
+    if (0 == chunks)
+    {
+        if (!finalRuns) std::ofstream(finalFilePath, std::ios::binary).close();
+        reportDone();
+
+        return;
+    }
+
+    LTaskGraph graph(m_pool);
+
+    unsigned int job = nextJob();
+
+    // 只有一块且需要生成结果文件时，该块的文件直接成为结果文件。
+    bool singleResult = !finalRuns && 1 == chunks;
+
+    // 临时文件路径。归并段按块序号、归并输出按其在 nodeRuns 中的下标分布到各临时目录，相邻的归并段落在不同目录，同组归并的输入来自不同磁盘。
+    auto partFilePath = [&](size_t i) {
+        std::string name = inputName + ".part" + std::to_string(i) + ".sorted";
+
+
+        return singleResult ? (std::filesystem::path(inputDirectory) / name).string() : tempFilePath(inputDirectory, name, i);
+    };
+    // 归并输出以其在 nodeRuns 中的下标命名，下标在整张任务图中唯一，各轮之间没有屏障时文件名也不会冲突。
+    auto mergeFilePath = [&](size_t output, bool root) {
+        std::string name = "tmp_merge_" + std::to_string(job) + "_" + std::to_string(output) + ".bin";
+
+
+        return root ? (std::filesystem::path(inputDirectory) / name).string() : tempFilePath(LUtil::executableDirectory(), name, output);
+    };
+
+    // 映射输入文件。无法映射（管道、空文件等）或映射后文件已变短时退化为按偏移读取；O_DIRECT 读取与映射互斥，directInput 优先。
+    std::unique_ptr<LMappedFile> mapped;
+    if (m_mapInput && !m_inputIo.direct)
+    {
+        mapped = std::make_unique<LMappedFile>(filePath);
+        if (mapped->size() < totalCount * sizeof(T)) mapped.reset();
+    }
+
+    // 线程池已按 NUMA 节点绑定工作线程时，将块轮流分配到各节点：块缓冲区直接分配在该节点上（无论由哪个 I/O 线程读入，物理页都落在该节点），
+    // 该块的排序与写出任务也偏好由该节点的工作线程执行，避免跨节点访问内存。
+    std::vector<int> nodes = m_pool->numaNodes();
+    auto chunkNode = [&nodes](size_t i) { return nodes.empty() ? -1 : nodes[i % nodes.size()]; };
+
+    // 每块的内存缓冲区，排序写出后立即释放。
+    std::vector<ChunkBuffer> buffers;
+    buffers.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i) buffers.emplace_back(LNumaAllocator<T>(chunkNode(i)));
+    // 归并树中每个节点产出的归并段，前 chunks 项为块排序结果。
+    std::vector<LRun> nodeRuns(chunks);
+    // 归并树中每个节点产出的数据字节数，用于估算进度。
+    std::vector<uint64_t> nodeBytes(chunks);
+
+    // 当前层的节点：first 为任务图节点编号，second 为 nodeRuns 中的下标。
+    std::vector<std::pair<LTaskGraph::NodeId, size_t>> level;
+
+    std::vector<LTaskGraph::NodeId> reads;
+    reads.reserve(chunks);
+    for (size_t i = 0; i < chunks; ++i)
+    {
+        size_t count = std::min(chunkCount, totalCount - i * chunkCount);
+        nodeBytes[i] = count * sizeof(T);
+
+        // 读取节点：阻塞的磁盘读取放到 I/O 通道。
+        LTaskGraph::NodeId read = graph.addNode(
+            [&filePath, &buffers, &mapped, &token, &report, i, count, chunkCount, this]() {
+                token.throwIfCancelled();
+
+                {
+                    LThreadPool::BlockingScope blocking;
+
+                    size_t offset = i * chunkCount * sizeof(T);
+                    if (mapped)
+                    {
+                        // 映射的页在复制时缺页读入，复制前先对整块发起预读。直接从映射区间构造，省去 resize() 的清零。
+                        mapped->prefetch(offset, count * sizeof(T));
+                        const T *slice = reinterpret_cast<const T *>(mapped->data() + offset);
+                        buffers[i].assign(slice, slice + count);
+                    }
+                    else
+                    {
+                        buffers[i].resize(count);
+                        LBlockIo::readRange(filePath, buffers[i].data(), count * sizeof(T), offset, m_inputIo);
+                    }
+                }
+
+                report(count * sizeof(T), [count](LSortProgress &p) { p.bytesRead += count * sizeof(T); });
+            },
+            LThreadPool::Priority::Normal, LThreadPool::Lane::Io);
+        if (!mapped && i >= m_inputReaders) graph.addEdge(reads[i - m_inputReaders], read);
+        reads.push_back(read);
+
+        // 排序节点：在计算通道排序内存块。
+        LTaskGraph::NodeId sort = graph.addNode(
+            [&buffers, &token, i, this]() { //
+                sortChunk(buffers[i], token);
+            },
+            LThreadPool::Priority::Normal, LThreadPool::Lane::Cpu, chunkNode(i));
+        graph.addEdge(read, sort);
+
+        // 写出节点：写入临时文件并释放内存块。写出完成才能释放内存，因此以高优先级插队执行。
+        LTaskGraph::NodeId write = graph.addNode(
+            [&buffers, &nodeRuns, &partFilePath, &token, &report, i, count, singleResult, this]() {
+                token.throwIfCancelled();
+
+                // 内存预算足够时直接接管块缓冲区，不写磁盘。只有一块时该块的文件直接成为结果文件，总是写出。
+                // 写出失败时 writeSortedChunk() 已删除不完整的文件，不记录归并段。
+                LRun run = singleResult ? LRun() : m_runStore.adopt(buffers[i]);
+                if (run.empty())
+                {
+                    std::string path = partFilePath(i);
+                    bool compress = m_compressRuns && !singleResult;
+                    writeSortedChunk(path, buffers[i], singleResult ? m_outputIo : m_io, compress);
+                    run = LRun(path, compress);
+                }
+                nodeRuns[i] = run;
+                ChunkBuffer(buffers[i].get_allocator()).swap(buffers[i]);
+
+                report(count * sizeof(T), [](LSortProgress &p) { ++p.runsProduced; });
+            },
+            LThreadPool::Priority::High, LThreadPool::Lane::Io);
+        graph.addEdge(sort, write);
+
+        level.emplace_back(write, i);
+    }
+
+    // 构建 k 路归并树。
+    unsigned int mergeRound = 0;
+    while (level.size() > (finalRuns ? m_k : 1))
+    {
+        // 上一层节点列表。
+        std::vector<std::pair<LTaskGraph::NodeId, size_t>> nextLevel;
+        roundRemaining.push_back(0);
+
+        for (size_t i = 0; i < level.size(); i += m_k)
+        {
+            size_t groupEnd = std::min<size_t>(i + m_k, level.size());
+
+            if (1 == groupEnd - i)
+            {
+                // 单文件直接加入上一层。
+                nextLevel.push_back(level[i]);
+
+                continue;
+            }
+
+            std::vector<size_t> group;
+            for (size_t j = i; j < groupEnd; ++j) group.push_back(level[j].second);
+
+            size_t output = nodeRuns.size();
+            nodeRuns.emplace_back();
+            nodeBytes.push_back(0);
+            for (size_t g : group) nodeBytes[output] += nodeBytes[g];
+            totalWork += nodeBytes[output];
+            ++roundRemaining[mergeRound];
+
+            // 归并完成后即可删除输入文件、释放磁盘空间，且位于关键路径上，因此以高优先级插队执行。
+            LTaskGraph::NodeId merge = graph.addNode(
+                [&nodeRuns, &mergeFilePath, &token, &report, &roundRemaining, bytes = nodeBytes[output], round = mergeRound, group, output, finalRuns, this]() {
+                    token.throwIfCancelled();
+
+                    std::vector<LRun> groupRuns;
+                    for (size_t g : group) groupRuns.push_back(nodeRuns[g]);
+
+                    // 任务图执行前归并树已构建完毕，最后创建的归并节点即为根节点，其输出重命名为结果文件。
+                    // 非根节点的输出在内存预算内写入内存，缓冲区分配在当前线程所在的 NUMA 节点上。
+                    bool root = !finalRuns && output + 1 == nodeRuns.size();
+                    LRun outputRun = root ? LRun() : m_runStore.reserve<T>(bytes / sizeof(T), LThreadPool::currentNode());
+                    if (outputRun.empty()) outputRun = LRun(mergeFilePath(output, root), m_compressRuns && !root);
+
+                    nodeRuns[output] = mergeKFiles(std::move(groupRuns), std::move(outputRun), root ? m_outputIo : m_io, token);
+                    for (size_t g : group) nodeRuns[g] = LRun();
+
+                    // 已完成的归并轮数为从第 0 轮起连续全部完成的轮数。单文件可以跨轮直接进入上层，各轮不一定按顺序完成。
+                    report(bytes, [&roundRemaining, round](LSortProgress &p) {
+                        --roundRemaining[round];
+                        while (p.mergeRoundsDone < roundRemaining.size() && 0 == roundRemaining[p.mergeRoundsDone]) ++p.mergeRoundsDone;
+                    });
+                },
+                LThreadPool::Priority::High);
+            for (size_t j = i; j < groupEnd; ++j) graph.addEdge(level[j].first, merge);
+
+            nextLevel.emplace_back(merge, output);
+        }
+
+        level = std::move(nextLevel);
+
+        ++mergeRound;
+    }
+
+    progress.totalMergeRounds = mergeRound;
+
+    // 执行任务图。graph.run() 内部使用线程池感知的 wait()，若本函数运行在线程池任务中也不会死锁。
+    // graph.run() 在所有节点结束后才返回，此时不会再有节点创建新文件，可以安全地清理。
+    try
+    {
+        graph.run();
+    }
+    catch (...)
+    {
+        for (LRun &run : nodeRuns) run.discard();
+
+        throw;
+    }
+
+    if (finalRuns)
+    {
+        for (const auto &node : level) finalRuns->push_back(nodeRuns[node.second]);
+        reportDone();
+
+        return;
+    }
+
+    // 重命名最终归并文件，它与结果文件位于同一目录。
+    const std::string &rootFilePath = nodeRuns[level[0].second].filePath();
+    if (0 != std::rename(rootFilePath.c_str(), finalFilePath.c_str()))
+    {
+        std::remove(rootFilePath.c_str());
+
+        throw std::runtime_error("Failed to rename " + rootFilePath + " to " + finalFilePath + ".");
+    }
+
+    reportDone();
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::sortTextFile(const std::string &filePath, const LCancellationToken &token, const ProgressCallback &callback)
+{
+    // 函数执行逻辑：
+    // 1. 由 fileRuns() 按输入格式读取、排序并归并到不超过 m_k 个归并段。
+    // 2. 最后一轮归并经游标按结果格式写到 xxx.sorted，失败时删除不完整的结果文件。
+    // 3. 回调一次 Done 阶段。
+    auto start = std::chrono::steady_clock::now();
+
+    LBasicSortCursor<T, Compare> cursor(fileRuns(filePath, token), m_io, token, m_compare);
+
+    std::string finalFilePath = filePath + ".sorted";
+    std::unique_ptr<LBlockWriter> writer;
+    try
+    {
+        writer = std::make_unique<LBlockWriter>(finalFilePath, m_outputIo);
+        writeResult(cursor, [&writer](const char *data, size_t bytes) { writer->write(data, bytes); }, token);
+        writer->close();
+    }
+    catch (...)
+    {
+        writer.reset();
+        std::remove(finalFilePath.c_str());
+
+        throw;
+    }
+
+    if (callback)
+    {
+        std::error_code error;
+        LSortProgress progress;
+        progress.phase = LSortProgress::Phase::Done;
+        progress.totalBytes = progress.bytesRead = std::filesystem::file_size(filePath, error);
+        progress.elapsed = std::chrono::steady_clock::now() - start;
+
+        callback(progress);
+    }
+}
+
+template <typename T, typename Compare>
+inline std::vector<LRun> LBasicSorter<T, Compare>::fileRuns(const std::string &filePath, const LCancellationToken &token)
+{
+    // 文本输入的块边界只能顺序确定，按流式排序的流程读取；二进制输入走任务图，在最后一轮归并之前停下。
+    if (LSorterOptions::Format::Text == m_inputFormat) return streamRuns(fileReader(filePath), token);
+
+    std::vector<LRun> runs;
+    sortFile(filePath, token, nullptr, &runs);
+
+
+    return runs;
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::sortStream(std::istream &input, std::ostream &output, const LCancellationToken &token)
+{
+    streamSort(streamReader(input), streamWriter(output), token);
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::sortStream(int inputFd, int outputFd, const LCancellationToken &token)
+{
+    streamSort(fdReader(inputFd), fdWriter(outputFd), token);
+}
+
+template <typename T, typename Compare>
+inline std::unique_ptr<LBasicSortCursor<T, Compare>> LBasicSorter<T, Compare>::openCursor(const std::string &filePath, const LCancellationToken &token)
+{
+    return std::make_unique<LBasicSortCursor<T, Compare>>(fileRuns(filePath, token), m_io, token, m_compare);
+}
+
+template <typename T, typename Compare>
+inline std::unique_ptr<LBasicSortCursor<T, Compare>> LBasicSorter<T, Compare>::openCursor(std::istream &input, const LCancellationToken &token)
+{
+    std::vector<LRun> runs = streamRuns(streamReader(input), token);
+
+
+    return std::make_unique<LBasicSortCursor<T, Compare>>(std::move(runs), m_io, token, m_compare);
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::streamSort(const StreamReader &read, const StreamWriter &write, const LCancellationToken &token)
+{
+    // 最后一轮归并由游标按批拉取，直接写到输出，不生成结果文件。游标析构时丢弃剩余的归并段。
+    LBasicSortCursor<T, Compare> cursor(streamRuns(read, token), m_io, token, m_compare);
+
+    writeResult(cursor, write, token);
+}
+
+template <typename T, typename Compare>
+inline std::vector<LRun> LBasicSorter<T, Compare>::streamRuns(const StreamReader &read, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 由 generateRuns() 驱动读取、块排序与中间归并，这里只提供读取一块与归并一组的方法。
+    // 2. 二进制输入每次读满一块；文本输入的块截断到最后一个分隔符，块任务先并行解析该块，块的元素个数在任务中才确定。
+    // 3. 块任务排序该块，在内存预算内接管为内存归并段，否则写到临时文件。
+    size_t chunkCount = std::max<size_t>(1, m_chunkSize / sizeof(T));
+
+    std::vector<char> carry;
+    bool eof = false;
+    auto readChunk = [&](size_t, int node, const std::string &path) -> ChunkTask {
+        if (eof) return nullptr;
+
+        auto buffer = std::make_shared<ChunkBuffer>(LNumaAllocator<T>(node));
+        auto text = std::make_shared<LRunBufferT<char>>(LNumaAllocator<char>(node));
+        if (LSorterOptions::Format::Text == m_inputFormat)
+        {
+            eof = readTextChunk(read, m_chunkSize, isNumberSeparator, carry, *text);
+            if (text->empty()) return nullptr;
+        }
+        else
+        {
+            // 读满一块。管道每次返回的字节数任意，按字节填充，只有输入末尾不足一个元素的字节被丢弃。
+            buffer->resize(chunkCount);
+            char *data = reinterpret_cast<char *>(buffer->data());
+            size_t capacity = chunkCount * sizeof(T);
+            size_t filled = 0;
+            {
+                LThreadPool::BlockingScope blocking;
+
+                while (filled < capacity)
+                {
+                    size_t bytes = read(data + filled, capacity - filled);
+                    if (0 == bytes)
+                    {
+                        eof = true;
+
+                        break;
+                    }
+                    filled += bytes;
+                }
+            }
+            buffer->resize(filled / sizeof(T));
+            if (buffer->empty()) return nullptr;
+        }
+
+
+        return [buffer, text, path, &token, this]() {
+            if (!text->empty())
+            {
+                ChunkBuffer values = parseText(*text, token);
+                LRunBufferT<char>().swap(*text);
+                buffer->swap(values);
+            }
+
+            sortChunk(*buffer, token);
+
+            size_t count = buffer->size();
+            LRun run = m_runStore.adopt(*buffer);
+            if (run.empty())
+            {
+                writeSortedChunk(path, *buffer, m_io, m_compressRuns);
+                run = LRun(path, m_compressRuns);
+            }
+
+
+            return SizedRun{run, count};
+        };
+    };
+
+    auto mergeGroup = [&token, this](std::vector<LRun> group, size_t count, const std::string &path) {
+        LRun output = m_runStore.reserve<T>(count, LThreadPool::currentNode());
+        if (output.empty()) output = LRun(path, m_compressRuns);
+
+
+        return mergeKFiles(std::move(group), std::move(output), m_io, token);
+    };
+
+    // 同时在途的块任务数：一块正在读入时，前面的块在排序与写出。块内排序本身会拆分到所有工作线程，少量在途块即可跑满计算线程。
+    constexpr size_t maxInFlight = 2;
+
+
+    return generateRuns(readChunk, mergeGroup, maxInFlight, "stream_", ".bin", token);
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::writeResult(LBasicSortCursor<T, Compare> &cursor, const StreamWriter &write, const LCancellationToken &token)
+{
+    const T *data;
+    if (LSorterOptions::Format::Binary == m_outputFormat)
+    {
+        while (size_t count = cursor.next(data))
+        {
+            LThreadPool::BlockingScope blocking;
+
+            write(reinterpret_cast<const char *>(data), count * sizeof(T));
+        }
+
+        return;
+    }
+
+    // 文本结果。每批切成至多线程数段，每段不少于 minPieceCount 个元素，各段格式化到自己的字符串，按顺序写出。
+    constexpr size_t formatBatchCount = 1 << 20;
+    constexpr size_t minPieceCount = 16 * 1024;
+
+    std::vector<T> batch;
+    std::vector<std::string> pieces;
+    for (bool done = false; !done;)
+    {
+        size_t count = cursor.next(data);
+        batch.insert(batch.end(), data, data + count);
+        done = 0 == count;
+        if (batch.empty() || (!done && batch.size() < formatBatchCount)) continue;
+
+        size_t pieceCount = std::max<size_t>(1, std::min<size_t>(m_pool->size(), batch.size() / minPieceCount));
+        pieces.resize(pieceCount);
+        forEachPiece(
+            pieceCount,
+            [&](size_t i) {
+                pieces[i].clear();
+                formatNumbers(batch.data() + batch.size() * i / pieceCount, batch.data() + batch.size() * (i + 1) / pieceCount, pieces[i]);
+            },
+            token);
+
+        LThreadPool::BlockingScope blocking;
+
+        for (const std::string &piece : pieces) write(piece.data(), piece.size());
+        batch.clear();
+    }
+}
+
+template <typename T, typename Compare>
+inline typename LBasicSorter<T, Compare>::ChunkBuffer LBasicSorter<T, Compare>::parseText(const LRunBufferT<char> &text, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 将块按字节数切成至多线程数段，每段不少于 minPieceBytes 字节，切点后移到下一个分隔符，数字不会被切开。
+    // 2. 各段并行解析到各自的数组。
+    // 3. 按顺序拼接到与 text 同一 NUMA 节点上的块缓冲区。
+    constexpr size_t minPieceBytes = 64 * 1024;
+
+    const char *begin = text.data();
+    const char *end = begin + text.size();
+    size_t pieceCount = std::max<size_t>(1, std::min<size_t>(m_pool->size(), text.size() / minPieceBytes));
+
+    std::vector<const char *> bounds{begin};
+    for (size_t i = 1; i < pieceCount; ++i) bounds.push_back(std::find_if(std::max(bounds.back(), begin + text.size() * i / pieceCount), end, isNumberSeparator));
+    bounds.push_back(end);
+
+    std::vector<std::vector<T>> pieces(pieceCount);
+    forEachPiece(pieceCount, [&](size_t i) { parseNumbers(bounds[i], bounds[i + 1], pieces[i]); }, token);
+
+    size_t count = 0;
+    for (const std::vector<T> &piece : pieces) count += piece.size();
+
+    ChunkBuffer values{LNumaAllocator<T>(text.get_allocator())};
+    values.reserve(count);
+    for (const std::vector<T> &piece : pieces) values.insert(values.end(), piece.begin(), piece.end());
+
+
+    return values;
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::parseNumbers(const char *first, const char *last, std::vector<T> &values)
+{
+    if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+    {
+        for (;;)
+        {
+            while (first != last && isNumberSeparator(*first)) ++first;
+            if (first == last) break;
+
+            // std::from_chars 不接受前导 '+'，跳过它后仍须以数字开头。
+            const char *number = first;
+            if ('+' == *first && last - first > 1 && '-' != first[1]) ++first;
+
+            T value;
+            auto [next, error] = std::from_chars(first, last, value);
+            if (std::errc() != error || (next != last && !isNumberSeparator(*next)))
+            {
+                std::string field(number, std::min<const char *>(std::find_if(number, last, isNumberSeparator), number + 32));
+                if (std::errc::result_out_of_range == error) throw std::runtime_error("Integer out of range in text input: " + field + ".");
+
+                throw std::runtime_error("Invalid integer in text input: " + field + ".");
+            }
+
+            values.push_back(value);
+            first = next;
+        }
+    }
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::formatNumbers(const T *first, const T *last, std::string &text)
+{
+    if constexpr (std::is_integral<T>::value && !std::is_same<T, bool>::value)
+    {
+        // 每个元素最多 digits10 + 1 位数字，加符号与换行符。
+        constexpr size_t maxBytes = std::numeric_limits<T>::digits10 + 3;
+
+        size_t size = text.size();
+        text.resize(size + (last - first) * maxBytes);
+        char *out = text.data() + size;
+        char *end = text.data() + text.size();
+        for (; first != last; ++first)
+        {
+            out = std::to_chars(out, end, *first).ptr;
+            *out++ = '\n';
+        }
+        text.resize(out - text.data());
+    }
+}
+
+template <typename T, typename Compare>
+template <typename F>
+inline void LBasicSorter<T, Compare>::forEachPiece(size_t pieces, const F &work, const LCancellationToken &token)
+{
+    // 子任务引用着本帧的 work，任何一段失败都要等待其余各段结束后再重新抛出。
+    std::vector<std::future<void>> futures;
+    std::exception_ptr error;
+    try
+    {
+        for (size_t i = 1; i < pieces; ++i)
+        {
+            futures.push_back(m_pool->enqueueOnNode(LThreadPool::currentNode(), LThreadPool::Priority::Normal, [i, &work, &token]() {
+                token.throwIfCancelled();
+                work(i);
+            }));
+        }
+
+        token.throwIfCancelled();
+        work(0);
+    }
+    catch (...)
+    {
+        error = std::current_exception();
+    }
+
+    for (std::future<void> &future : futures)
+    {
+        try
+        {
+            m_pool->wait(future);
+        }
+        catch (...)
+        {
+            if (!error) error = std::current_exception();
+        }
+    }
+
+    if (error) std::rethrow_exception(error);
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::sortChunk(ChunkBuffer &buffer, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 比较器为 LKeyLess 且记录大于标签时，为每条记录生成（键，下标）标签，并行排序标签，只搬动键而不搬动负载。
+    //    再按标签顺序将记录复制到新缓冲区，每条记录只搬动一次，新缓冲区替换原缓冲区。
+    // 2. 否则直接并行排序记录本身。
+    if constexpr (LIsKeyLess<Compare>::value)
+    {
+        using Tag = LSortTag<LKeyOf<T, decltype(m_compare.keyOf)>>;
+        if constexpr (sizeof(T) > sizeof(Tag))
+        {
+            std::vector<Tag, LNumaAllocator<Tag>> tags(LNumaAllocator<Tag>(buffer.get_allocator()));
+            tags.reserve(buffer.size());
+            for (size_t i = 0; i < buffer.size(); ++i) tags.push_back({m_compare.keyOf(buffer[i]), static_cast<uint32_t>(i)});
+
+            sortRange(tags.data(), tags.data() + tags.size(), 0, std::less<Tag>(), token);
+
+            ChunkBuffer sorted(buffer.get_allocator());
+            sorted.reserve(buffer.size());
+            for (const Tag &tag : tags) sorted.push_back(buffer[tag.index]);
+            buffer.swap(sorted);
+
+            return;
+        }
+    }
+
+    sortRange(buffer.data(), buffer.data() + buffer.size(), 0, m_compare, token);
+}
+
+template <typename T, typename Compare>
+template <typename E, typename C>
+inline void LBasicSorter<T, Compare>::sortRange(E *first, E *last, unsigned int depth, const C &compare, const LCancellationToken &token)
+{
+    // 函数执行逻辑：
+    // 1. 区间较小或拆分深度已足够覆盖所有工作线程时，直接 std::sort。
+    // 2. 否则将区间一分为二，左半部分作为子任务提交到线程池，当前线程递归排序右半部分。
+    // 3. 通过 m_pool->wait() 等待左半部分完成，等待期间当前工作线程会帮助执行队列中的任务，不会死锁。
+    // 4. 使用 std::inplace_merge 合并两个有序的半区间。
+    // 当块数少于线程数（例如小文件只有一两个块）时，单个块的排序也能利用所有核心。
+    // 每次拆分与排序前检查取消令牌，已取消时不再排序剩余的子区间。
+
+    // 小于该元素个数的区间不再拆分，避免任务调度开销超过排序收益。
+    constexpr std::ptrdiff_t minSplitSize = 1 << 16;
+
+    token.throwIfCancelled();
+
+    if (last - first < 2 * minSplitSize || (1u << depth) >= m_pool->size())
+    {
+        LSortKernel<E, C>::sort(first, last, compare);
+
+        return;
+    }
+
+    auto middle = first + (last - first) / 2;
+
+    // 子任务偏好当前线程所在的 NUMA 节点，与块缓冲区所在节点一致。
+    auto left = m_pool->enqueueOnNode(LThreadPool::currentNode(), LThreadPool::Priority::Normal, [first, middle, depth, &compare, &token, this]() { sortRange(first, middle, depth + 1, compare, token); });
+
+    // 右半部分抛出异常时仍需等待左半部分结束，子任务引用着本帧的区间、比较器与令牌。
+    try
+    {
+        sortRange(middle, last, depth + 1, compare, token);
+    }
+    catch (...)
+    {
+        try
+        {
+            m_pool->wait(left);
+        }
+        catch (...)
+        {
+        }
+
+        throw;
+    }
+    m_pool->wait(left);
+
+    std::inplace_merge(first, middle, last, compare);
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::writeSortedChunk(const std::string &outputFilePath, const ChunkBuffer &data, const LIoOptions &io, bool compress)
+{
+    // 压缩在调用线程上完成，编码缓冲区按 4 KiB 对齐，可以直接以 O_DIRECT 写出。其他元素类型不会开启压缩。
+    LRunCodec::Bytes encoded;
+    if constexpr (std::is_same<T, int>::value)
+    {
+        if (compress) LRunCodec::encode(data.data(), data.size(), encoded);
+    }
+
+    // 未开启 I/O 通道时写出在计算线程上执行，标记阻塞以便弹性线程池补充线程。
+    LThreadPool::BlockingScope blocking;
+
+    // 写出失败时 writeFile() 删除不完整的文件并抛出异常。
+    if (compress) LBlockIo::writeFile(outputFilePath, encoded.data(), encoded.size(), io);
+    else LBlockIo::writeFile(outputFilePath, data.data(), data.size() * sizeof(T), io);
+}
+
+template <typename T, typename Compare>
+inline LRun LBasicSorter<T, Compare>::mergeKFiles(std::vector<LRun> inputs, LRun output, const LIoOptions &outputIo, const LCancellationToken &token)
+{
+    // 输出归并段的创建、写出与失败清理由 mergeInto() 完成，这里只做堆归并；压缩的磁盘输出每批先编码为若干帧。
+    bool compress = output.compressed();
+    LRunCodec::Bytes encoded;
+
+
+    return mergeInto(std::move(inputs), std::move(output), outputIo, [&](const std::vector<LRun> &runs, const StreamWriter &write) {
+        mergeRuns(runs, [&](const T *values, size_t count) {
+            if (compress)
+            {
+                if constexpr (std::is_same<T, int>::value)
+                {
+                    encoded.clear();
+                    LRunCodec::encode(values, count, encoded);
+                    write(encoded.data(), encoded.size());
+                }
+            }
+            else write(reinterpret_cast<const char *>(values), count * sizeof(T));
+        }, token);
+    });
+}
+
+template <typename T, typename Compare>
+inline void LBasicSorter<T, Compare>::mergeRuns(const std::vector<LRun> &inputs, const BatchCallback &emit, const LCancellationToken &token)
+{
+    // 每批检查一次取消令牌，截止时间需要读取时钟，不宜逐个元素检查。
+    // IoUring 后端下，读者在调用者消费当前块时已在后台预读后续的块。
+    LBasicRunMerger<T, Compare> merger(inputs, m_io, m_io.blockSize / sizeof(T), m_compare);
+
+    const T *data;
+    while (size_t count = merger.next(data))
+    {
+        token.throwIfCancelled();
+        emit(data, count);
+    }
+}
+
+
+// int 元素升序排序器在 lsorter.cpp 中显式实例化。
+extern template class LBasicSorter<int>;
+
+
 #endif
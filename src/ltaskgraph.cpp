@@ -0,0 +1,157 @@
+/**
+ * @file ltaskgraph.cpp
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 任务依赖图类源文件。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#include "ltaskgraph.h"
+
+#include <stdexcept>
+
+
+LTaskGraph::LTaskGraph(LThreadPool *pool) : m_pool(pool)
+{
+    if (!pool) throw std::runtime_error("Pointer pool is a nullptr.");
+}
+
+LTaskGraph::~LTaskGraph()
+{
+    if (m_pool) m_pool = nullptr;
+}
+
+LTaskGraph::NodeId LTaskGraph::addNode(std::function<void()> task, LThreadPool::Priority priority, LThreadPool::Lane lane, int node)
+{
+    m_nodes.push_back(std::make_unique<Node>());
+    m_nodes.back()->task = std::move(task);
+    m_nodes.back()->priority = priority;
+    m_nodes.back()->lane = lane;
+    m_nodes.back()->node = node;
+
+
+    return m_nodes.size() - 1;
+}
+
+void LTaskGraph::addEdge(NodeId from, NodeId to)
+{
+    if (from >= m_nodes.size() || to >= m_nodes.size()) throw std::out_of_range("Task graph node id out of range.");
+    if (from == to) throw std::invalid_argument("Task graph node can not depend on itself.");
+
+    m_nodes[from]->successors.push_back(to);
+    ++m_nodes[to]->dependencies;
+}
+
+void LTaskGraph::run()
+{
+    // 函数执行逻辑：
+    // 1. 重置每个节点的剩余前驱计数与全局剩余节点计数。
+    // 2. 将所有无前驱的节点提交到线程池。
+    // 3. 每个节点完成后将其后继的剩余前驱计数减一，减到 0 的后继立即提交（见 execute()）。
+    // 4. 最后一个节点完成时兑现 promise，run() 通过线程池感知的 wait() 等待。
+    // 5. 若执行过程中有节点抛出异常，重新抛出第一个异常。
+
+    if (m_nodes.empty()) return;
+
+    for (auto &node : m_nodes) node->pending = node->dependencies;
+    m_remaining = m_nodes.size();
+    m_failed = false;
+    m_error = nullptr;
+    m_done = std::make_shared<std::promise<void>>();
+
+    std::future<void> done = m_done->get_future();
+
+    // 先收集根节点再提交，避免提交过程中其他线程修改计数造成重复调度。
+    std::vector<NodeId> roots;
+    for (NodeId id = 0; id < m_nodes.size(); ++id)
+        if (0 == m_nodes[id]->dependencies) roots.push_back(id);
+
+    if (!isAcyclic(roots)) throw std::logic_error("Task graph has a cycle.");
+
+    for (NodeId id : roots) schedule(id);
+
+    m_pool->wait(done);
+
+    if (m_error) std::rethrow_exception(m_error);
+}
+
+size_t LTaskGraph::size() const
+{
+    return m_nodes.size();
+}
+
+void LTaskGraph::schedule(NodeId id)
+{
+    // 返回的 future 不需要保存，完成情况通过计数与 promise 汇总。
+    // 提交失败（如线程池已停止）时记录异常，并在当前线程完成该节点的计数：已失败时任务体被跳过，其后继同样无法提交，
+    // 于是整棵子树的计数都在这里推进，run() 得以返回并重新抛出异常，而不是永远等待。
+    const Node &node = *m_nodes[id];
+    try
+    {
+        if (LThreadPool::Lane::Io == node.lane) m_pool->enqueueIo(node.priority, [this, id]() { execute(id); });
+        else m_pool->enqueueOnNode(node.node, node.priority, [this, id]() { execute(id); });
+    }
+    catch (...)
+    {
+        fail(std::current_exception());
+        execute(id);
+    }
+}
+
+void LTaskGraph::execute(NodeId id)
+{
+    Node &node = *m_nodes[id];
+
+    // 已有节点失败时跳过任务体，但仍然推进计数，保证 run() 能够返回。
+    if (!m_failed)
+    {
+        try
+        {
+            if (node.task) node.task();
+        }
+        catch (...)
+        {
+            fail(std::current_exception());
+        }
+    }
+
+    for (NodeId successor : node.successors)
+        if (1 == m_nodes[successor]->pending.fetch_sub(1)) schedule(successor);
+
+    if (1 == m_remaining.fetch_sub(1))
+    {
+        // set_value() 后 run() 可能立即返回并销毁本对象，因此先持有 promise 的副本。
+        std::shared_ptr<std::promise<void>> done = m_done;
+        done->set_value();
+    }
+}
+
+void LTaskGraph::fail(std::exception_ptr error)
+{
+    std::unique_lock<std::mutex> lock(m_errorMutex);
+    if (!m_error) m_error = error;
+    m_failed = true;
+}
+
+bool LTaskGraph::isAcyclic(const std::vector<NodeId> &roots) const
+{
+    // Kahn 拓扑排序：能被依次消去的节点数等于总节点数时图中无环。
+    std::vector<size_t> pending(m_nodes.size());
+    for (NodeId id = 0; id < m_nodes.size(); ++id) pending[id] = m_nodes[id]->dependencies;
+
+    std::vector<NodeId> ready = roots;
+    size_t visited = 0;
+    while (!ready.empty())
+    {
+        NodeId id = ready.back();
+        ready.pop_back();
+        ++visited;
+
+        for (NodeId successor : m_nodes[id]->successors)
+            if (0 == --pending[successor]) ready.push_back(successor);
+    }
+
+
+    return m_nodes.size() == visited;
+}
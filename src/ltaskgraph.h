@@ -0,0 +1,171 @@
+/**
+ * @file ltaskgraph.h
+ * @author DavidingPlus (davidingplus@qq.com)
+ * @brief 任务依赖图类头文件。
+ * @details LTaskGraph 用有向无环图（DAG）描述一组任务及其依赖关系：节点是任务，边 from -> to 表示 to 必须在 from 完成后才能执行。执行时每个节点在其全部前驱完成的瞬间即被提交到线程池，不存在按轮次屏障等待造成的空闲间隙。
+ *
+ * Copyright (c) 2025 电子科技大学 刘治学
+ *
+ */
+
+#ifndef _LTASKGRAPH_H_
+#define _LTASKGRAPH_H_
+
+#include "lglobalmacros.h"
+
+#include <vector>
+#include <memory>
+#include <atomic>
+#include <mutex>
+#include <future>
+#include <functional>
+#include <exception>
+
+#include "lthreadpool.h"
+
+
+/**
+ * @class LTaskGraph
+ * @brief 在 LThreadPool 上执行的任务依赖图。
+ *
+ * @note 使用方法
+ *   LTaskGraph graph(&pool);
+ *   auto a = graph.addNode(taskA);
+ *   auto b = graph.addNode(taskB);
+ *   graph.addEdge(a, b); // b 依赖 a。
+ *   graph.run();         // 阻塞直到所有节点完成。
+ */
+class LTaskGraph
+{
+    L_CLASS_NONCOPYABLE(LTaskGraph)
+
+public:
+
+    /**
+     * @brief 节点编号类型。
+     */
+    using NodeId = size_t;
+
+    /**
+     * @brief 构造函数。
+     * @param pool 外部线程池指针，用于执行图中的任务。
+     */
+    LTaskGraph(LThreadPool *pool);
+
+    /**
+     * @brief 析构函数。
+     */
+    virtual ~LTaskGraph();
+
+    /**
+     * @brief 添加一个任务节点。
+     * @param task 节点任务。
+     * @param priority 节点就绪后提交到线程池时使用的优先级，默认 Normal。
+     * @param lane 节点提交到的线程池通道，默认计算通道。阻塞的磁盘操作应使用 I/O 通道。
+     * @param node 计算通道节点偏好的 NUMA 节点，默认 -1 表示无偏好，见 LThreadPool::enqueueOnNode()。
+     * @return NodeId 新节点编号。
+     */
+    NodeId addNode(std::function<void()> task, LThreadPool::Priority priority = LThreadPool::Priority::Normal, LThreadPool::Lane lane = LThreadPool::Lane::Cpu, int node = -1);
+
+    /**
+     * @brief 添加一条依赖边，to 节点在 from 节点完成后才会执行。
+     * @param from 前驱节点编号。
+     * @param to 后继节点编号。
+     */
+    void addEdge(NodeId from, NodeId to);
+
+    /**
+     * @brief 执行整张图，阻塞直到所有节点完成。
+     * @note 等待通过 LThreadPool::wait() 进行，因此可以在线程池任务内部调用。若某个节点抛出异常或无法提交到线程池（如线程池已停止），其余尚未开始的节点不再执行任务体，run() 在全部节点结束后重新抛出第一个异常。
+     */
+    void run();
+
+    /**
+     * @brief 返回节点数量。
+     * @return 节点数量。
+     */
+    size_t size() const;
+
+
+private:
+
+    /**
+     * @brief 图节点。
+     */
+    struct Node
+    {
+        std::function<void()> task;                                 // 节点任务。
+        LThreadPool::Priority priority = LThreadPool::Priority::Normal; // 调度优先级。
+        LThreadPool::Lane lane = LThreadPool::Lane::Cpu;              // 调度通道。
+        int node = -1;                                              // 偏好的 NUMA 节点。
+        std::vector<NodeId> successors;                             // 后继节点列表。
+        size_t dependencies = 0;                                    // 前驱节点数量。
+        std::atomic<size_t> pending = {0};                          // 执行期间尚未完成的前驱数量。
+    };
+
+    /**
+     * @brief 将节点提交到线程池。
+     * @param id 节点编号。
+     */
+    void schedule(NodeId id);
+
+    /**
+     * @brief 在工作线程中执行节点，并调度依赖已满足的后继节点。
+     * @param id 节点编号。
+     */
+    void execute(NodeId id);
+
+    /**
+     * @brief 记录第一个异常并标记任务图已失败。
+     * @param error 节点抛出的异常或提交失败的异常。
+     */
+    void fail(std::exception_ptr error);
+
+    /**
+     * @brief 检查图中是否无环。
+     * @param roots 所有无前驱的节点。
+     * @return 无环返回 true。
+     */
+    bool isAcyclic(const std::vector<NodeId> &roots) const;
+
+
+private:
+
+    /**
+     * @brief 外部线程池指针。
+     */
+    LThreadPool *m_pool = nullptr;
+
+    /**
+     * @brief 所有节点，使用指针保存以便节点内的原子变量地址稳定。
+     */
+    std::vector<std::unique_ptr<Node>> m_nodes;
+
+    /**
+     * @brief 执行期间尚未完成的节点数量。
+     */
+    std::atomic<size_t> m_remaining = {0};
+
+    /**
+     * @brief 所有节点完成时兑现的 promise。
+     */
+    std::shared_ptr<std::promise<void>> m_done;
+
+    /**
+     * @brief 是否已有节点失败。
+     */
+    std::atomic<bool> m_failed = {false};
+
+    /**
+     * @brief 第一个节点抛出的异常。
+     */
+    std::exception_ptr m_error;
+
+    /**
+     * @brief 保护 m_error 的互斥锁。
+     */
+    std::mutex m_errorMutex;
+};
+
+
+#endif
@@ -9,57 +9,432 @@
 
 #include "lthreadpool.h"
 
+#include <algorithm>
 
-LThreadPool::LThreadPool(size_t threads) : stop(false)
+
+double LThreadPoolStats::utilization() const
+{
+    if (workerBusy.empty() || uptime.count() <= 0) return 0;
+
+    std::chrono::nanoseconds busy{0};
+    for (const auto &value : workerBusy) busy += value;
+
+
+    return std::min(1.0, static_cast<double>(busy.count()) / (static_cast<double>(uptime.count()) * workerBusy.size()));
+}
+
+double LThreadPoolStats::ioUtilization() const
+{
+    if (ioWorkerBusy.empty() || uptime.count() <= 0) return 0;
+
+    std::chrono::nanoseconds busy{0};
+    for (const auto &value : ioWorkerBusy) busy += value;
+
+
+    return std::min(1.0, static_cast<double>(busy.count()) / (static_cast<double>(uptime.count()) * ioWorkerBusy.size()));
+}
+
+
+thread_local int LThreadPool::workerNode = -1;
+thread_local LThreadPool *LThreadPool::workerPool = nullptr;
+
+
+LThreadPool::BlockingScope::BlockingScope() : m_pool(workerPool)
+{
+    if (!m_pool) return;
+
+    std::unique_lock<std::mutex> lock(m_pool->queue_mutex);
+    ++m_pool->blockedWorkers;
+
+    // 当前线程即将阻塞，若队列中还有任务且没有空闲线程，补充一个线程。
+    m_pool->growIfNeeded();
+}
+
+LThreadPool::BlockingScope::~BlockingScope()
+{
+    if (!m_pool) return;
+
+    std::unique_lock<std::mutex> lock(m_pool->queue_mutex);
+    --m_pool->blockedWorkers;
+
+    m_pool = nullptr;
+}
+
+
+LThreadPool::LThreadPool(size_t threads, size_t ioThreads) : LThreadPool(fixedOptions(ioThreads), threads)
+{
+}
+
+LThreadPool::LThreadPool(const LThreadPoolOptions &options) : LThreadPool(options, 0 == options.threads ? LCpuTopology::recommendedThreadCount() : options.threads)
+{
+}
+
+LThreadPool::LThreadPool(const LThreadPoolOptions &options, size_t threads)
+    : waiters(0), stop(false), startTime(std::chrono::steady_clock::now()), enqueuedCount(0), completedCount(0), peakQueueDepth(0)
+{
+    // 初始化 stop 标志为 false，并启动计算工作线程与 I/O 工作线程。
+    // 计算线程数由公有构造函数确定：选项未指定时取可用 CPU 集合与 cgroup 配额的较小值，旧接口按参数原样创建。需要绑定时，按拓扑顺序为每个槽位分配 CPU，线程启动后先绑定自身再进入主循环。
+    // maxThreads 大于初始线程数时开启弹性模式，线程数在 [minWorkers, maxWorkers] 之间变化。
+    // 每个线程的主循环见 workerLoop()。
+    minWorkers = 0 == options.minThreads ? threads : std::min(options.minThreads, threads);
+    maxWorkers = std::max(threads, options.maxThreads);
+    idleTimeout = options.idleTimeout;
+    liveWorkers = 0;
+    idleWorkers = 0;
+    blockedWorkers = 0;
+
+    if (options.pinWorkers) cpuOrder = LCpuTopology::topology();
+
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        for (size_t i = 0; i < threads; ++i) spawnWorker();
+    }
+
+    for (size_t i = 0; i < options.ioThreads; ++i) ioWorkerBusy.emplace_back(0);
+    for (size_t i = 0; i < options.ioThreads; ++i) ioWorkers.emplace_back([this, i] { workerLoop(Lane::Io, i); });
+}
+
+LThreadPoolOptions LThreadPool::fixedOptions(size_t ioThreads)
+{
+    LThreadPoolOptions options;
+    options.ioThreads = ioThreads;
+
+
+    return options;
+}
+
+LThreadPool::~LThreadPool()
+{
+    // 析构时设置 stop 标志，通知所有线程退出等待。然后 join 每个工作线程，保证线程安全退出。
+    shutdown();
+
+    // 等待所有工作线程退出。stop 之后不会再有新线程启动，此时访问槽位无需加锁。
+    for (std::thread &worker : workers)
+        if (worker.joinable()) worker.join();
+    for (std::thread &worker : ioWorkers) worker.join();
+}
+
+void LThreadPool::shutdown()
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+    stop = true;
+
+    // 唤醒所有等待线程，确保它们能检查 stop 并退出。
+    condition.notify_all();
+    ioCondition.notify_all();
+}
+
+size_t LThreadPool::size() const
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+
+    return liveWorkers;
+}
+
+size_t LThreadPool::ioSize() const
+{
+    return ioWorkers.size();
+}
+
+LThreadPool::ScheduleAwaiter LThreadPool::schedule(Priority priority, int node)
+{
+    return {this, priority, node};
+}
+
+int LThreadPool::workerCpu(size_t index) const
+{
+    std::unique_lock<std::mutex> lock(queue_mutex);
+
+
+    return index < workerCpus.size() ? workerCpus[index] : -1;
+}
+
+std::vector<int> LThreadPool::numaNodes() const
+{
+    // 弹性模式下节点集合按线程数上限计算，新增线程的槽位同样按拓扑顺序绑定。
+    std::vector<int> nodes;
+    for (size_t i = 0; i < maxWorkers && !cpuOrder.empty(); ++i) nodes.push_back(cpuOrder[i % cpuOrder.size()].numaNode);
+
+    std::sort(nodes.begin(), nodes.end());
+    nodes.erase(std::unique(nodes.begin(), nodes.end()), nodes.end());
+
+
+    return nodes;
+}
+
+int LThreadPool::currentNode()
+{
+    return workerNode;
+}
+
+LThreadPoolStats LThreadPool::stats() const
+{
+    LThreadPoolStats result;
+
+    result.uptime = std::chrono::steady_clock::now() - startTime;
+    result.enqueued = enqueuedCount.load(std::memory_order_relaxed);
+    result.completed = completedCount.load(std::memory_order_relaxed);
+
+    // 队列与线程计数、槽位列表受 queue_mutex 保护；忙碌时间是原子计数器，在锁内读取只是为了与槽位列表保持一致。
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        result.queueDepth = tasks.size();
+        result.ioQueueDepth = ioTasks.size();
+        result.peakQueueDepth = peakQueueDepth;
+        result.liveThreads = liveWorkers;
+        result.idleThreads = idleWorkers;
+        result.blockedThreads = blockedWorkers;
+
+        for (const auto &value : workerBusy) result.workerBusy.emplace_back(value.load(std::memory_order_relaxed));
+        for (const auto &value : ioWorkerBusy) result.ioWorkerBusy.emplace_back(value.load(std::memory_order_relaxed));
+    }
+
+    result.queueWait = queueWaitHistogram.snapshot();
+    result.runTime = runTimeHistogram.snapshot();
+
+
+    return result;
+}
+
+bool LThreadPool::TaskQueue::empty() const
+{
+    for (const auto &level : levels)
+        if (!level.empty()) return false;
+
+
+    return true;
+}
+
+size_t LThreadPool::TaskQueue::size() const
+{
+    size_t result = 0;
+    for (const auto &level : levels) result += level.size();
+
+
+    return result;
+}
+
+LThreadPool::TaskQueue::Task LThreadPool::TaskQueue::pop(int node)
+{
+    // 同节点任务只在队列前部的有限窗口内查找，避免队列很长时每次出队都线性扫描。
+    constexpr size_t nodeScanLimit = 32;
+
+    // 从高优先级到低优先级查找第一个非空队列。
+    for (int i = 2; i >= 0; --i)
+    {
+        std::deque<Task> &level = levels[i];
+        if (level.empty()) continue;
+
+        auto it = level.begin();
+        if (node >= 0)
+        {
+            auto end = level.begin() + std::min(nodeScanLimit, level.size());
+            auto local = std::find_if(level.begin(), end, [node](const Task &task) { return node == task.node; });
+            if (end != local) it = local;
+        }
+
+        Task task = std::move(*it);
+        level.erase(it);
+
+
+        return task;
+    }
+
+
+    return {};
+}
+
+void LThreadPool::push(std::function<void()> task, Priority priority, Lane lane, int node)
+{
+    // 未开启 I/O 线程时，I/O 任务退化为计算通道任务。
+    if (Lane::Io == lane && ioWorkers.empty()) lane = Lane::Cpu;
+
+    // 在加锁之前读取时钟，不延长临界区。
+    TaskQueue::Task entry{std::move(task), node, std::chrono::steady_clock::now()};
+
+    // 这对大括号的作用是限定 std::unique_lock 的生命周期！确保互斥锁只在操作任务队列（检查 stop、加入任务、通知线程）期间持有。离开这个作用域时，lock 自动释放锁，从而允许被唤醒的线程顺利获取锁执行任务，避免长时间持锁导致线程池卡住或死锁。其余几处括号的作用同理。
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+
+        // 不允许在线程池停止后加入任务。
+        if (stop) throw std::runtime_error("Enqueue to a stopped thread pool");
+
+        // 放入对应通道、对应优先级的队列，并通知一个等待线程有新任务。
+        if (Lane::Io == lane)
+        {
+            ioTasks.levels[static_cast<int>(priority)].push_back(std::move(entry));
+            ioCondition.notify_one();
+        }
+        else
+        {
+            tasks.levels[static_cast<int>(priority)].push_back(std::move(entry));
+            condition.notify_one();
+
+            peakQueueDepth = std::max(peakQueueDepth, tasks.size());
+
+            // 弹性模式下，若所有线程都在忙且有线程阻塞，补充线程。
+            growIfNeeded();
+        }
+
+        enqueuedCount.fetch_add(1, std::memory_order_relaxed);
+
+        // 正在 wait() 的线程也可以执行新任务。
+        if (waiters.load() > 0) completion.notify_all();
+    }
+}
+
+void LThreadPool::spawnWorker()
+{
+    // 优先复用已退出线程的槽位。已退出的线程在释放锁后只剩函数返回，这里 join 不会长时间阻塞。
+    size_t slot = 0;
+    while (slot < workers.size() && workerAlive[slot]) ++slot;
+
+    if (slot == workers.size())
+    {
+        workers.emplace_back();
+        workerAlive.push_back(false);
+        workerBusy.emplace_back(0);
+        workerCpus.push_back(cpuOrder.empty() ? -1 : cpuOrder[slot % cpuOrder.size()].cpu);
+        workerNodes.push_back(cpuOrder.empty() ? -1 : cpuOrder[slot % cpuOrder.size()].numaNode);
+    }
+    else if (workers[slot].joinable())
+    {
+        workers[slot].join();
+    }
+
+    workerAlive[slot] = true;
+    ++liveWorkers;
+
+    workers[slot] = std::thread([this, slot, cpu = workerCpus[slot]] {
+        if (cpu >= 0) LCpuTopology::pinCurrentThread(cpu);
+        workerLoop(Lane::Cpu, slot);
+    });
+}
+
+void LThreadPool::growIfNeeded()
+{
+    if (stop || liveWorkers >= maxWorkers) return;
+
+    // 有空闲线程时交给空闲线程处理；没有线程阻塞时说明所有线程都在做计算，增加线程也无济于事。
+    if (0 == idleWorkers && blockedWorkers > 0 && !tasks.empty()) spawnWorker();
+}
+
+void LThreadPool::workerLoop(Lane lane, size_t slot)
 {
-    // 初始化 stop 标志为 false，并启动 threads 个工作线程。
     // 每个线程不断轮询等待任务：
     // 1. 锁住任务队列 mutex；
-    // 2. 使用 condition_variable 等待新任务或 stop 信号；
+    // 2. 使用 condition_variable 等待本通道的新任务或 stop 信号；
     // 3. 若 stop 且任务队列为空，则退出线程循环；
-    // 4. 否则取出队列首任务并解锁 mutex；
-    // 5. 执行任务。
-    for (size_t i = 0; i < threads; ++i)
-        workers.emplace_back(
-            [this]
+    // 4. 弹性模式下，计算线程空闲超时且线程数多于下限时退出；
+    // 5. 否则取出优先级最高的任务（同优先级下优先挑选偏好本节点的任务）并解锁 mutex；
+    // 6. 执行任务，并记录排队时间、执行时间与本线程的忙碌时间。
+    bool isCpu = Lane::Cpu == lane;
+    bool elastic = isCpu && maxWorkers > minWorkers;
+
+    int node = -1;
+    std::atomic<uint64_t> *busy = nullptr;
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        node = isCpu ? workerNodes[slot] : -1;
+        busy = isCpu ? &workerBusy[slot] : &ioWorkerBusy[slot];
+    }
+
+    workerNode = node;
+    workerPool = isCpu ? this : nullptr;
+
+    TaskQueue &queue = isCpu ? tasks : ioTasks;
+    std::condition_variable &cv = isCpu ? condition : ioCondition;
+
+    for (;;)
+    {
+        TaskQueue::Task task;
+
+        {
+            std::unique_lock<std::mutex> lock(queue_mutex);
+
+            // 等待任务到来或线程池停止。
+            auto ready = [this, &queue] { return stop || !queue.empty(); };
+
+            if (isCpu) ++idleWorkers;
+            while (!ready())
             {
-                for (;;)
+                if (!elastic)
                 {
-                    std::function<void()> task;
+                    cv.wait(lock);
+                    continue;
+                }
 
-                    {
-                        std::unique_lock<std::mutex> lock(this->queue_mutex);
+                if (std::cv_status::timeout == cv.wait_for(lock, idleTimeout) && !ready() && liveWorkers > minWorkers)
+                {
+                    // 空闲超时，退出线程并释放槽位，线程对象由后续 spawnWorker() 或析构函数 join。
+                    --idleWorkers;
+                    --liveWorkers;
+                    workerAlive[slot] = false;
 
-                        // 等待任务到来或线程池停止。
-                        this->condition.wait(lock, [this] { //
-                            return this->stop || !this->tasks.empty();
-                        });
+                    return;
+                }
+            }
+            if (isCpu) --idleWorkers;
 
-                        // 如果线程池停止且任务队列为空，退出线程。
-                        if (this->stop && this->tasks.empty()) return;
+            // 如果线程池停止且任务队列为空，退出线程。
+            if (stop && queue.empty()) return;
 
-                        // 取出队列首任务并从队列移除。
-                        task = std::move(this->tasks.front());
-                        this->tasks.pop();
-                    }
+            // 取出任务并从队列移除。
+            task = queue.pop(node);
+        }
 
-                    // 执行任务（解锁后执行）。
-                    task();
-                }
-            });
+        // 执行任务（解锁后执行），完成后通知 wait() 中的等待者。
+        execute(task, busy);
+    }
 }
 
-LThreadPool::~LThreadPool()
+bool LThreadPool::runPendingTask()
 {
+    TaskQueue::Task task;
+
     {
-        // 析构时设置 stop 标志，通知所有线程退出等待。然后 join 每个工作线程，保证线程安全退出。
         std::unique_lock<std::mutex> lock(queue_mutex);
-        stop = true;
 
-        // 唤醒所有等待线程，确保它们能检查 stop 并退出。
-        condition.notify_all();
+        if (!tasks.empty()) task = tasks.pop(workerNode);
+        else if (!ioTasks.empty()) task = ioTasks.pop();
+        else return false;
+    }
+
+    // 调用线程的忙碌时间已计入正在 wait() 的外层任务，这里不再累计。
+    execute(task, nullptr);
+
+
+    return true;
+}
+
+void LThreadPool::execute(TaskQueue::Task &task, std::atomic<uint64_t> *busy)
+{
+    auto start = std::chrono::steady_clock::now();
+    task.function();
+    auto end = std::chrono::steady_clock::now();
+
+    uint64_t waited = std::chrono::duration_cast<std::chrono::nanoseconds>(start - task.enqueued).count();
+    uint64_t ran = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count();
+
+    queueWaitHistogram.record(waited);
+    runTimeHistogram.record(ran);
+    if (busy) busy->fetch_add(ran, std::memory_order_relaxed);
+    completedCount.fetch_add(1, std::memory_order_relaxed);
+
+    // 通知 wait() 中的等待者有任务完成。
+    notifyCompletion();
+}
+
+void LThreadPool::notifyCompletion()
+{
+    if (0 == waiters.load()) return;
+
+    // 先获取一次锁，保证等待者要么在检查条件前看到任务完成，要么已进入等待并能收到通知。
+    {
+        std::unique_lock<std::mutex> lock(queue_mutex);
     }
 
-    // 等待所有工作线程退出。
-    for (std::thread &worker : workers) worker.join();
+    completion.notify_all();
 }
@@ -3,7 +3,12 @@
  * @author DavidingPlus (davidingplus@qq.com)
  * @brief 线程池类头文件。
  * @note 本线程池参考实现：https://github.com/progschj/ThreadPool
- * @details LThreadPool 是一个固定大小的线程池，实现了任务队列和线程管理。支持将任意可调用对象异步提交到线程池，返回 std::future 获取结果。内部通过 std::mutex 和 std::condition_variable 管理任务队列同步。当线程池销毁时，所有线程会安全退出。
+ * @details LThreadPool 是一个线程池，实现了任务队列和线程管理，默认为固定大小，设置 maxThreads 后为弹性大小（见下文）。支持将任意可调用对象异步提交到线程池，返回 std::future 获取结果。内部通过 std::mutex 和 std::condition_variable 管理任务队列同步。当线程池销毁时，所有线程会安全退出。
+ * 任务分为高、中、低三个优先级，工作线程总是先执行高优先级任务。此外可以开启一条独立的 I/O 通道：I/O 任务由专门的少量 I/O 线程执行，阻塞的磁盘操作不会占用计算线程。
+ * 通过 LThreadPoolOptions 可以按进程可用 CPU 集合与 cgroup 配额确定线程数，并将计算线程按 NUMA 节点、共享 L3 分组的顺序绑定到 CPU，避免内核随意迁移线程造成缓存失效。
+ * 设置 maxThreads 后线程池为弹性大小：任务在 BlockingScope 中阻塞于磁盘 I/O 等操作时，若队列中仍有任务而没有空闲线程，线程池会临时增加线程补足 CPU 算力；空闲超时的多余线程自动退出。
+ * 绑定后的计算线程知道自己所在的 NUMA 节点，任务可以通过 enqueueOnNode() 标记偏好节点，同节点的工作线程会优先取走这些任务，使任务尽量访问本地内存。
+ * 线程池持续统计提交与完成的任务数、每个工作线程的忙碌时间，以及任务排队等待时间与执行时间的直方图，通过 stats() 获取快照，用于判断负载是受限于计算、I/O 还是任务供给不足。
  *
  * Copyright (c) 2025 电子科技大学 刘治学
  *
@@ -13,7 +18,7 @@
 #define _LTHREADPOOL_H_
 
 #include <vector>
-#include <queue>
+#include <deque>
 #include <memory>
 #include <thread>
 #include <mutex>
@@ -21,35 +26,242 @@
 #include <future>
 #include <functional>
 #include <stdexcept>
+#include <atomic>
+#include <chrono>
+#include <type_traits>
+
+#include "lcputopology.h"
+#include "lhistogram.h"
+
+
+/**
+ * @struct LThreadPoolOptions
+ * @brief 线程池构造选项。
+ */
+struct LThreadPoolOptions
+{
+    /**
+     * @brief 计算工作线程数量，0 表示使用 LCpuTopology::recommendedThreadCount()。
+     */
+    size_t threads = 0;
+
+    /**
+     * @brief I/O 工作线程数量，0 表示不开启独立 I/O 通道。
+     */
+    size_t ioThreads = 0;
+
+    /**
+     * @brief 是否将计算工作线程绑定到 CPU。
+     * @note 第 i 个计算线程绑定到 LCpuTopology::topology() 中的第 i 个 CPU（线程多于 CPU 时循环使用），因此相邻编号的线程共享同一 L3 缓存与 NUMA 节点。
+     */
+    bool pinWorkers = false;
+
+    /**
+     * @brief 弹性模式下计算工作线程数量的下限，0 表示等于初始线程数。
+     * @note 空闲超过 idleTimeout 的线程会退出，直到线程数降到下限。
+     */
+    size_t minThreads = 0;
+
+    /**
+     * @brief 弹性模式下计算工作线程数量的上限，不大于初始线程数时线程池为固定大小。
+     * @note 有工作线程阻塞（见 LThreadPool::BlockingScope）、没有空闲线程且队列非空时，线程池会临时增加线程，直到达到上限。
+     */
+    size_t maxThreads = 0;
+
+    /**
+     * @brief 弹性模式下空闲线程的退出超时时间。
+     */
+    std::chrono::milliseconds idleTimeout = std::chrono::milliseconds(5000);
+};
+
+
+/**
+ * @struct LThreadPoolStats
+ * @brief 线程池运行统计的快照，由 LThreadPool::stats() 返回。
+ * @note 时间单位均为纳秒。计数自线程池构造起单调递增，两次快照相减即得到区间内的增量。
+ */
+struct LThreadPoolStats
+{
+    /**
+     * @brief 线程池构造至今的时间。
+     */
+    std::chrono::nanoseconds uptime{0};
+
+    /**
+     * @brief 已提交的任务数量，包括两个通道。
+     */
+    uint64_t enqueued = 0;
+
+    /**
+     * @brief 已执行完毕的任务数量，包括 wait() 中帮助执行的任务。
+     */
+    uint64_t completed = 0;
+
+    /**
+     * @brief 计算通道当前排队的任务数量。
+     */
+    size_t queueDepth = 0;
+
+    /**
+     * @brief I/O 通道当前排队的任务数量。
+     */
+    size_t ioQueueDepth = 0;
+
+    /**
+     * @brief 计算通道排队任务数量的历史峰值。
+     */
+    size_t peakQueueDepth = 0;
+
+    /**
+     * @brief 当前存活、空闲与处于 BlockingScope 中的计算工作线程数量。
+     */
+    size_t liveThreads = 0;
+    size_t idleThreads = 0;
+    size_t blockedThreads = 0;
+
+    /**
+     * @brief 每个计算工作线程槽位累计执行任务的时间，下标与 LThreadPool::workerCpu() 一致。
+     */
+    std::vector<std::chrono::nanoseconds> workerBusy;
+
+    /**
+     * @brief 每个 I/O 工作线程累计执行任务的时间。
+     */
+    std::vector<std::chrono::nanoseconds> ioWorkerBusy;
+
+    /**
+     * @brief 任务从提交到开始执行的排队时间分布。
+     */
+    LHistogramSnapshot queueWait;
+
+    /**
+     * @brief 任务执行时间分布。
+     * @note 在任务内部调用 wait() 时，帮助执行的其他任务的时间也计入外层任务。
+     */
+    LHistogramSnapshot runTime;
+
+    /**
+     * @brief 返回计算工作线程的平均利用率。
+     * @return 忙碌时间之和除以 uptime 与槽位数量之积，取值 [0, 1]。
+     */
+    double utilization() const;
+
+    /**
+     * @brief 返回 I/O 工作线程的平均利用率。
+     * @return 忙碌时间之和除以 uptime 与线程数量之积，未开启 I/O 通道时为 0。
+     */
+    double ioUtilization() const;
+};
 
 
 /**
  * @class LThreadPool
- * @brief 一个简单的固定线程数线程池。
+ * @brief 一个简单的线程池，默认固定线程数，可选弹性伸缩。
  *
  * @note 使用方法
  *   LThreadPool pool(num_threads);
  *   auto f = pool.enqueue(func, args...);
  *   result = f.get();
+ *
+ *   在线程池任务内部等待其他任务时，应使用 pool.wait(f) 代替 f.get()，等待期间当前线程会帮助执行队列中的任务，避免嵌套提交导致死锁。
+ *
+ *   LThreadPoolOptions options;
+ *   options.pinWorkers = true; // 线程数取自可用 CPU 集合，并按拓扑绑定。
+ *   LThreadPool pool(options);
+ *
+ *   LThreadPool pool(num_threads, num_io_threads);
+ *   pool.enqueue(LThreadPool::Priority::High, func, args...); // 高优先级任务插队执行。
+ *   pool.enqueueIo(LThreadPool::Priority::Normal, func, args...); // 阻塞的磁盘操作交给 I/O 线程。
  */
 class LThreadPool
 {
 
 public:
 
+    /**
+     * @brief 任务优先级。
+     * @note 同一通道内严格按优先级调度，同一优先级内先进先出。
+     */
+    enum class Priority
+    {
+        Low = 0,
+        Normal,
+        High
+    };
+
+    /**
+     * @brief 任务通道：计算通道由计算线程执行，I/O 通道由 I/O 线程执行。
+     */
+    enum class Lane
+    {
+        Cpu = 0,
+        Io
+    };
+
+    /**
+     * @class BlockingScope
+     * @brief 标记当前任务即将阻塞的 RAII 对象。
+     * @details 在计算工作线程上构造时，线程池将该线程计为阻塞状态；若此时队列非空且没有空闲线程，弹性线程池会增加一个工作线程。析构时恢复计数。在非工作线程或固定大小的线程池上没有任何效果。
+     *
+     * @note 使用方法
+     *   {
+     *       LThreadPool::BlockingScope blocking;
+     *       file.read(...); // 阻塞的磁盘操作。
+     *   }
+     */
+    class BlockingScope
+    {
+
+    public:
+
+        /**
+         * @brief 构造函数，标记调用线程进入阻塞区域。
+         */
+        BlockingScope();
+
+        /**
+         * @brief 析构函数，标记调用线程离开阻塞区域。
+         */
+        virtual ~BlockingScope();
+
+        BlockingScope(const BlockingScope &other) = delete;
+        BlockingScope &operator=(const BlockingScope &other) = delete;
+
+
+    private:
+
+        /**
+         * @brief 调用线程所属的线程池，非计算工作线程为 nullptr。
+         */
+        LThreadPool *m_pool = nullptr;
+    };
+
     /**
      * @brief 构造函数，创建指定数量的工作线程。
-     * @param threads 工作线程数量。
-     * @note 构造时启动所有线程，并等待任务队列中的任务执行。
+     * @param threads 计算工作线程数量，0 表示不创建计算线程，任务只在 wait() 中由等待者执行。
+     * @param ioThreads I/O 工作线程数量，默认 0，表示不开启独立 I/O 通道，I/O 任务由计算线程执行。
+     * @note 构造时启动所有线程，并等待任务队列中的任务执行。按 CPU 拓扑决定线程数量请使用 LThreadPoolOptions。
      */
-    LThreadPool(size_t threads);
+    LThreadPool(size_t threads, size_t ioThreads = 0);
+
+    /**
+     * @brief 构造函数，按选项创建工作线程。
+     * @param options 线程池构造选项。
+     */
+    LThreadPool(const LThreadPoolOptions &options);
 
     /**
      * @brief 析构函数。
-     * @note 先设置 stop 标志，通知所有线程退出，然后 join 所有线程。
+     * @note 先调用 shutdown() 设置 stop 标志，通知所有线程退出，然后 join 所有线程。
      */
     virtual ~LThreadPool();
 
+    /**
+     * @brief 停止接收新任务，之后提交任务抛出 std::runtime_error。
+     * @note 已在队列中的任务仍会执行完毕，工作线程在队列清空后退出。不等待线程退出，析构函数负责 join，重复调用无副作用。
+     */
+    void shutdown();
+
     /**
      * @brief 向线程池提交一个可调用对象（函数、lambda 等）。
      * @tparam F 可调用对象类型。
@@ -57,70 +269,448 @@ public:
      * @param f 可调用对象。。
      * @param args 可调用对象的参数。
      * @return std::future<return_type> 返回未来对象，可获取函数返回值。
-     * @note 如果线程池已停止，将抛出 std::runtime_error。同时使用 std::packaged_task 封装任务，保证返回值可通过 std::future 获取。
+     * @note 如果线程池已停止，将抛出 std::runtime_error。同时使用 std::packaged_task 封装任务，保证返回值可通过 std::future 获取。任务以 Priority::Normal 优先级提交到计算通道。
+     */
+    template <class F, class... Args>
+    auto enqueue(F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * @brief 以指定优先级向计算通道提交一个可调用对象。
+     * @param priority 任务优先级。
+     * @param f 可调用对象。
+     * @param args 可调用对象的参数。
+     * @return std::future<return_type> 返回未来对象，可获取函数返回值。
+     */
+    template <class F, class... Args>
+    auto enqueue(Priority priority, F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * @brief 以指定优先级向计算通道提交一个偏好在指定 NUMA 节点执行的可调用对象。
+     * @param node 偏好的 NUMA 节点编号，小于 0 表示无偏好。
+     * @param priority 任务优先级。
+     * @param f 可调用对象。
+     * @param args 可调用对象的参数。
+     * @return std::future<return_type> 返回未来对象，可获取函数返回值。
+     * @note 偏好不是强制约束：同节点的工作线程会在同优先级的队列前部优先挑选该任务，若其他节点的线程空闲，仍会按先进先出取走它。
+     */
+    template <class F, class... Args>
+    auto enqueueOnNode(int node, Priority priority, F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * @brief 以指定优先级向 I/O 通道提交一个可调用对象。
+     * @param priority 任务优先级。
+     * @param f 可调用对象。
+     * @param args 可调用对象的参数。
+     * @return std::future<return_type> 返回未来对象，可获取函数返回值。
+     * @note 若构造时未开启 I/O 线程，任务会以相同优先级提交到计算通道。
+     */
+    template <class F, class... Args>
+    auto enqueueIo(Priority priority, F &&f, Args &&...args) -> std::future<std::invoke_result_t<F, Args...>>;
+
+    /**
+     * @brief 将协程调度到线程池计算通道上继续执行的 awaiter。
+     * @note await_suspend 以模板形式接收协程句柄，因此本头文件在 C++17 下同样可以编译，只有 C++20 协程代码才会实例化它。
+     */
+    struct ScheduleAwaiter
+    {
+        LThreadPool *pool;
+        Priority priority;
+        int node;
+
+        bool await_ready() const noexcept { return false; }
+
+        template <class Handle>
+        void await_suspend(Handle handle) const
+        {
+            pool->push([handle]() mutable { handle.resume(); }, priority, Lane::Cpu, node);
+        }
+
+        void await_resume() const noexcept {}
+    };
+
+    /**
+     * @brief 返回将当前协程切换到线程池工作线程执行的 awaiter，用法为 co_await pool.schedule()。
+     * @param priority 恢复协程的任务优先级，默认 Normal。
+     * @param node 恢复协程偏好的 NUMA 节点，默认 -1 表示无偏好。
+     * @return ScheduleAwaiter 可被 co_await 的对象。
+     */
+    ScheduleAwaiter schedule(Priority priority = Priority::Normal, int node = -1);
+
+    /**
+     * @brief 感知线程池的等待，获取 future 的结果。
+     * @tparam T 结果类型。
+     * @param future 待等待的 future 对象，通常来自 enqueue()。
+     * @return T future 的结果，等价于 future.get()。
+     * @note 在结果就绪之前，调用线程会不断从任务队列中取出任务执行（help-while-waiting）。因此工作线程内的任务可以安全地提交子任务并等待其完成，而不会因所有工作线程都阻塞在 get() 上导致死锁。若队列为空，则阻塞等待直到有任务完成或有新任务加入。
+     */
+    template <class T>
+    T wait(std::future<T> &future);
+
+    /**
+     * @brief 返回计算工作线程数量。
+     * @return 当前存活的计算工作线程数量，弹性模式下随负载变化。
+     */
+    size_t size() const;
+
+    /**
+     * @brief 返回 I/O 工作线程数量。
+     * @return I/O 工作线程数量。
+     */
+    size_t ioSize() const;
+
+    /**
+     * @brief 返回计算工作线程绑定的 CPU 编号。
+     * @param index 计算工作线程槽位下标。
+     * @return CPU 编号，未绑定或槽位不存在时返回 -1。
+     */
+    int workerCpu(size_t index) const;
+
+    /**
+     * @brief 返回已绑定的计算工作线程所覆盖的 NUMA 节点列表。
+     * @return 升序且不重复的节点编号，未绑定工作线程时为空。
+     */
+    std::vector<int> numaNodes() const;
+
+    /**
+     * @brief 返回调用线程所在的 NUMA 节点。
+     * @return 调用线程是某个线程池中已绑定 CPU 的计算工作线程时返回其节点编号，否则返回 -1。
+     */
+    static int currentNode();
+
+    /**
+     * @brief 返回线程池运行统计的快照。
+     * @return LThreadPoolStats 统计快照。
+     * @note 统计始终开启，热路径上每个任务只增加三次时钟读取与若干次 relaxed 原子操作。
+     */
+    LThreadPoolStats stats() const;
+
+
+private:
+
+    /**
+     * @brief 构造函数，两个公有构造函数的共同实现。
+     * @param options 线程池构造选项，其中的 threads 被忽略。
+     * @param threads 已确定的计算工作线程数量。
+     */
+    LThreadPool(const LThreadPoolOptions &options, size_t threads);
+
+    /**
+     * @brief 按旧接口的参数构造选项，只指定 I/O 线程数量，其余为默认值。
+     */
+    static LThreadPoolOptions fixedOptions(size_t ioThreads);
+
+    /**
+     * @brief 按优先级分级的任务队列。
+     */
+    struct TaskQueue
+    {
+        /**
+         * @brief 队列中的任务。
+         */
+        struct Task
+        {
+            std::function<void()> function;                // 封装好的任务。
+            int node = -1;                                 // 偏好的 NUMA 节点，-1 表示无偏好。
+            std::chrono::steady_clock::time_point enqueued; // 提交时间，用于统计排队时间。
+        };
+
+        /**
+         * @brief 每个优先级一个先进先出队列，下标即 Priority 的值。
+         */
+        std::deque<Task> levels[3];
+
+        /**
+         * @brief 队列是否为空。
+         * @return 所有优先级均无任务时返回 true。
+         */
+        bool empty() const;
+
+        /**
+         * @brief 返回队列中的任务数量。
+         * @return 所有优先级的任务数量之和。
+         */
+        size_t size() const;
+
+        /**
+         * @brief 取出优先级最高的任务，调用前需保证队列非空。
+         * @param node 调用线程所在的 NUMA 节点，不小于 0 时在最高优先级队列的前部优先挑选偏好该节点的任务。
+         * @return 取出的任务。
+         */
+        Task pop(int node = -1);
+    };
+
+    /**
+     * @brief 将任务加入指定通道的队列并唤醒工作线程。
+     * @param task 封装好的任务。
+     * @param priority 任务优先级。
+     * @param lane 任务通道。
+     * @param node 偏好的 NUMA 节点，-1 表示无偏好。
+     */
+    void push(std::function<void()> task, Priority priority, Lane lane, int node = -1);
+
+    /**
+     * @brief 工作线程主循环。
+     * @param lane 工作线程所属通道。
+     * @param slot 计算工作线程的槽位下标，I/O 工作线程忽略。
+     */
+    void workerLoop(Lane lane, size_t slot);
+
+    /**
+     * @brief 启动一个计算工作线程，优先复用已退出线程的槽位。调用前需持有 queue_mutex。
+     */
+    void spawnWorker();
+
+    /**
+     * @brief 弹性模式下判断是否需要增加计算工作线程，需要则启动。调用前需持有 queue_mutex。
+     */
+    void growIfNeeded();
+
+    /**
+     * @brief 尝试从任务队列中取出一个任务并在当前线程执行。
+     * @return 若执行了任务返回 true，队列为空返回 false。
+     * @note 先尝试计算通道，再尝试 I/O 通道，保证等待 I/O 任务时同样不会死锁。
+     */
+    bool runPendingTask();
+
+    /**
+     * @brief 执行取出的任务，记录统计数据并通知 wait() 中的等待者。
+     * @param task 取出的任务。
+     * @param busy 累计忙碌时间的计数器，为 nullptr 时不累计（如 wait() 中帮助执行的任务已计入外层任务）。
+     */
+    void execute(TaskQueue::Task &task, std::atomic<uint64_t> *busy);
+
+    /**
+     * @brief 任务执行完毕后通知 wait() 中的等待者。
+     */
+    void notifyCompletion();
+
+    /**
+     * @brief 将任务封装为 packaged_task，返回其 future 与 void() 形式的任务。
      */
     template <class F, class... Args>
-    auto enqueue(F &&f, Args &&...args) -> std::future<typename std::result_of<F(Args...)>::type>;
+    static auto package(F &&f, Args &&...args)
+        -> std::pair<std::future<std::invoke_result_t<F, Args...>>, std::function<void()>>;
 
 
 private:
 
     /**
-     * @brief 线程池中所有工作线程。
+     * @brief 线程池中所有计算工作线程的槽位，弹性模式下已退出线程的槽位会被复用。
      */
     std::vector<std::thread> workers;
 
     /**
-     * @brief 任务队列，存放待执行的函数对象。
+     * @brief 每个槽位的线程是否存活。
      */
-    std::queue<std::function<void()>> tasks;
+    std::vector<bool> workerAlive;
 
     /**
-     * @brief 队列同步互斥锁。
+     * @brief 线程池中所有 I/O 工作线程。
      */
-    std::mutex queue_mutex;
+    std::vector<std::thread> ioWorkers;
 
     /**
-     * @brief 条件变量，通知线程有新任务。
+     * @brief 每个槽位绑定的 CPU 编号，未绑定为 -1。
+     */
+    std::vector<int> workerCpus;
+
+    /**
+     * @brief 每个槽位所在的 NUMA 节点，未绑定为 -1。
+     */
+    std::vector<int> workerNodes;
+
+    /**
+     * @brief 绑定 CPU 时按拓扑顺序排列的 CPU 列表，新槽位依次循环取用；不绑定时为空。
+     */
+    std::vector<LCpuInfo> cpuOrder;
+
+    /**
+     * @brief 弹性模式下计算工作线程数量的下限。
+     */
+    size_t minWorkers;
+
+    /**
+     * @brief 计算工作线程数量的上限，等于下限时为固定大小。
+     */
+    size_t maxWorkers;
+
+    /**
+     * @brief 弹性模式下空闲线程的退出超时时间。
+     */
+    std::chrono::milliseconds idleTimeout;
+
+    /**
+     * @brief 当前存活的计算工作线程数量。
+     */
+    size_t liveWorkers;
+
+    /**
+     * @brief 正在等待任务的空闲计算工作线程数量。
+     */
+    size_t idleWorkers;
+
+    /**
+     * @brief 处于 BlockingScope 中的计算工作线程数量。
+     */
+    size_t blockedWorkers;
+
+    /**
+     * @brief 调用线程所在的 NUMA 节点，由计算工作线程启动时设置。
+     */
+    thread_local static int workerNode;
+
+    /**
+     * @brief 调用线程所属的线程池，由计算工作线程启动时设置，供 BlockingScope 使用。
+     */
+    thread_local static LThreadPool *workerPool;
+
+    /**
+     * @brief 计算通道任务队列，存放待执行的函数对象。
+     */
+    TaskQueue tasks;
+
+    /**
+     * @brief I/O 通道任务队列。
+     */
+    TaskQueue ioTasks;
+
+    /**
+     * @brief 队列同步互斥锁，同时保护工作线程槽位与计数。
+     */
+    mutable std::mutex queue_mutex;
+
+    /**
+     * @brief 条件变量，通知计算线程有新任务。
      */
     std::condition_variable condition;
 
+    /**
+     * @brief 条件变量，通知 I/O 线程有新任务。
+     */
+    std::condition_variable ioCondition;
+
+    /**
+     * @brief 条件变量，通知 wait() 中的等待者有任务完成或有新任务加入。
+     */
+    std::condition_variable completion;
+
+    /**
+     * @brief 当前阻塞在 wait() 中的等待者数量，为 0 时工作线程无需发出完成通知。
+     */
+    std::atomic<size_t> waiters;
+
     /**
      * @brief 停止标志，析构时设置，阻止新任务加入。
      */
     bool stop;
+
+    /**
+     * @brief 线程池构造时间。
+     */
+    std::chrono::steady_clock::time_point startTime;
+
+    /**
+     * @brief 已提交与已完成的任务数量。
+     */
+    std::atomic<uint64_t> enqueuedCount;
+    std::atomic<uint64_t> completedCount;
+
+    /**
+     * @brief 计算通道排队任务数量的历史峰值，受 queue_mutex 保护。
+     */
+    size_t peakQueueDepth;
+
+    /**
+     * @brief 每个计算工作线程槽位与 I/O 工作线程累计的忙碌纳秒数。
+     * @note 使用 deque 保证新增槽位时已有元素的地址不变，工作线程在启动时取得自己计数器的引用后即可无锁累加。
+     */
+    std::deque<std::atomic<uint64_t>> workerBusy;
+    std::deque<std::atomic<uint64_t>> ioWorkerBusy;
+
+    /**
+     * @brief 排队时间与执行时间的直方图，单位纳秒。
+     */
+    LHistogram queueWaitHistogram;
+    LHistogram runTimeHistogram;
 };
 
 
 template <class F, class... Args>
-inline auto LThreadPool::enqueue(F &&f, Args &&...args)
-    -> std::future<typename std::result_of<F(Args...)>::type>
+inline auto LThreadPool::package(F &&f, Args &&...args)
+    -> std::pair<std::future<std::invoke_result_t<F, Args...>>, std::function<void()>>
 {
-    using return_type = typename std::result_of<F(Args...)>::type;
+    using return_type = std::invoke_result_t<F, Args...>;
 
     // 将函数和参数绑定到一个 packaged_task。
     auto task = std::make_shared<std::packaged_task<return_type()>>(std::bind(std::forward<F>(f), std::forward<Args>(args)...));
 
-    // 获取 future 用于返回调用结果。
-    std::future<return_type> res = task->get_future();
+    // 获取 future 用于返回调用结果，并将任务封装成 void() 类型。
+    return {task->get_future(), [task]()
+            { (*task)(); }};
+}
 
-    // 这对大括号的作用是限定 std::unique_lock 的生命周期！确保互斥锁只在操作任务队列（检查 stop、加入任务、通知线程）期间持有。离开这个作用域时，lock 自动释放锁，从而允许被唤醒的线程顺利获取锁执行任务，避免长时间持锁导致线程池卡住或死锁。cpp 中两处括号的作用同理。
-    {
-        std::unique_lock<std::mutex> lock(queue_mutex);
+template <class F, class... Args>
+inline auto LThreadPool::enqueue(F &&f, Args &&...args)
+    -> std::future<std::invoke_result_t<F, Args...>>
+{
+    return enqueue(Priority::Normal, std::forward<F>(f), std::forward<Args>(args)...);
+}
 
-        // 不允许在线程池停止后加入任务。
-        if (stop) throw std::runtime_error("Enqueue to a stopped thread pool");
+template <class F, class... Args>
+inline auto LThreadPool::enqueue(Priority priority, F &&f, Args &&...args)
+    -> std::future<std::invoke_result_t<F, Args...>>
+{
+    auto packaged = package(std::forward<F>(f), std::forward<Args>(args)...);
+    push(std::move(packaged.second), priority, Lane::Cpu);
 
-        // 将任务封装成 void() 类型，放入队列。
-        tasks.emplace([task]()
-                      { (*task)(); });
 
-        // 通知一个等待线程有新任务。
-        condition.notify_one();
+    return std::move(packaged.first);
+}
+
+template <class F, class... Args>
+inline auto LThreadPool::enqueueOnNode(int node, Priority priority, F &&f, Args &&...args)
+    -> std::future<std::invoke_result_t<F, Args...>>
+{
+    auto packaged = package(std::forward<F>(f), std::forward<Args>(args)...);
+    push(std::move(packaged.second), priority, Lane::Cpu, node);
+
+
+    return std::move(packaged.first);
+}
+
+template <class F, class... Args>
+inline auto LThreadPool::enqueueIo(Priority priority, F &&f, Args &&...args)
+    -> std::future<std::invoke_result_t<F, Args...>>
+{
+    auto packaged = package(std::forward<F>(f), std::forward<Args>(args)...);
+    push(std::move(packaged.second), priority, Lane::Io);
+
+
+    return std::move(packaged.first);
+}
+
+template <class T>
+inline T LThreadPool::wait(std::future<T> &future)
+{
+    auto isReady = [&future]() { return std::future_status::ready == future.wait_for(std::chrono::seconds(0)); };
+
+    while (!isReady())
+    {
+        // 优先帮助执行队列中的任务，被等待的子任务可能就在其中。
+        if (runPendingTask()) continue;
+
+        // 队列为空，说明被等待的任务正在其他线程执行，等待任务完成或新任务加入的通知。
+        // 被等待的 future 也可能由线程池外部完成，因此设置超时兜底，定期重新检查。
+        std::unique_lock<std::mutex> lock(queue_mutex);
+        ++waiters;
+        completion.wait_for(lock, std::chrono::milliseconds(10), [this, &isReady] { //
+            return !this->tasks.empty() || !this->ioTasks.empty() || isReady();
+        });
+        --waiters;
     }
 
 
-    return res;
+    return future.get();
 }
 
 
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <future>
+#include <numeric>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#include "ltask.h"
+#include "lasyncfile.h"
+
+
+static LTask<int> square(LThreadPool &pool, int value)
+{
+    co_await pool.schedule();
+    co_return value * value;
+}
+
+static LTask<int> sumOfSquares(LThreadPool &pool, int count)
+{
+    int sum = 0;
+    for (int i = 0; i < count; ++i) sum += co_await square(pool, i);
+    co_return sum;
+}
+
+static LTask<void> fail(LThreadPool &pool)
+{
+    co_await pool.schedule();
+    throw std::runtime_error("failed");
+}
+
+static LTask<size_t> roundTrip(LAsyncFile &file, int index)
+{
+    // 每个协程写入并读回自己的一段，等待 I/O 期间协程挂起。
+    std::vector<int> out(1024, index);
+    std::vector<int> in(1024, -1);
+    long long offset = static_cast<long long>(index) * out.size() * sizeof(int);
+
+    co_await file.write(out.data(), out.size() * sizeof(int), offset);
+    size_t bytes = co_await file.read(in.data(), in.size() * sizeof(int), offset);
+
+    co_return in == out ? bytes : 0;
+}
+
+
+static LTask<size_t> readAfter(LAsyncFile &file, std::atomic<bool> &started)
+{
+    std::vector<int> in(1024);
+    started = true;
+    co_return co_await file.read(in.data(), in.size() * sizeof(int), 0);
+}
+
+
+TEST(LTaskTest, ScheduleTest)
+{
+    LThreadPool pool(2);
+
+    EXPECT_EQ(LCoroutine::syncWait(pool, square(pool, 7)), 49);
+    EXPECT_EQ(LCoroutine::syncWait(pool, sumOfSquares(pool, 5)), 0 + 1 + 4 + 9 + 16);
+    EXPECT_THROW(LCoroutine::syncWait(pool, fail(pool)), std::runtime_error);
+}
+
+TEST(LTaskTest, AsyncFileTest)
+{
+    // 一个计算线程、一个 I/O 线程，同时在途的协程数远多于线程数。
+    LThreadPool pool(1, 1);
+
+    const std::string testFile = "ltask_test.bin";
+    LAsyncFile readWrite(&pool);
+    readWrite.open(testFile, LAsyncFile::OpenMode::ReadWrite);
+
+    std::vector<std::future<size_t>> futures;
+    for (int i = 0; i < 64; ++i) futures.push_back(LCoroutine::spawn(pool, roundTrip(readWrite, i)));
+    for (auto &f : futures) EXPECT_EQ(pool.wait(f), 1024 * sizeof(int));
+
+    EXPECT_EQ(readWrite.size(), 64 * 1024 * sizeof(int));
+
+    readWrite.close();
+    std::remove(testFile.c_str());
+}
+
+TEST(LTaskTest, StoppedPoolTest)
+{
+    // 读请求排在被占用的 I/O 线程之后，其间线程池停止：读完成后无法调度回计算通道，异常应交给 future，而不是让协程永远挂起。
+    LThreadPool pool(1, 1);
+
+    const std::string testFile = "ltask_stopped_test.bin";
+    LAsyncFile file(&pool);
+    file.open(testFile, LAsyncFile::OpenMode::ReadWrite);
+
+    std::promise<void> release;
+    std::shared_future<void> released = release.get_future().share();
+    pool.enqueueIo(LThreadPool::Priority::Normal, [released] { released.wait(); });
+
+    std::atomic<bool> started = {false};
+    std::future<size_t> result = LCoroutine::spawn(pool, readAfter(file, started));
+    while (!started || 0 == pool.stats().ioQueueDepth) std::this_thread::yield();
+
+    pool.shutdown();
+    release.set_value();
+
+    ASSERT_EQ(std::future_status::ready, result.wait_for(std::chrono::seconds(10)));
+    EXPECT_THROW(result.get(), std::runtime_error);
+
+    file.close();
+    std::remove(testFile.c_str());
+}
@@ -0,0 +1,143 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <functional>
+#include <numeric>
+#include <vector>
+
+#include "lblockio.h"
+#include "liouring.h"
+#include "lnuma.h"
+
+
+/**
+ * @brief 依次以两种后端分别配合普通读写、O_DIRECT 与页缓存提示执行测试体。
+ */
+static void forEachBackend(const std::function<void(const LIoOptions &)> &body)
+{
+    for (LIoBackend backend : {LIoBackend::Stream, LIoBackend::IoUring})
+        for (int mode = 0; mode < 3; ++mode)
+        {
+            LIoOptions options;
+            options.backend = backend;
+            options.blockSize = 4096;
+            options.queueDepth = 4;
+            options.direct = 1 == mode;
+            options.cacheHints = 2 == mode;
+
+            SCOPED_TRACE(std::string(LIoBackend::Stream == backend ? "Stream" : "IoUring") + (1 == mode ? " direct" : 2 == mode ? " cacheHints" : ""));
+            body(options);
+        }
+}
+
+TEST(LBlockIoTest, BackendTest)
+{
+    LIoOptions options;
+    options.backend = LIoBackend::IoUring;
+
+    EXPECT_EQ(LBlockIo::effectiveBackend(options), LIoUring::available() ? LIoBackend::IoUring : LIoBackend::Stream);
+    EXPECT_EQ(LBlockIo::effectiveBackend(LIoOptions()), LIoBackend::Stream);
+}
+
+TEST(LBlockIoTest, RangeTest)
+{
+    forEachBackend([](const LIoOptions &options) {
+        const std::string testFile = "lblockio_range_test.bin";
+
+        // 元素个数不是块大小的整数倍，验证末尾不完整的块。
+        std::vector<int> data(100003);
+        std::iota(data.begin(), data.end(), -50000);
+        LBlockIo::writeFile(testFile, data.data(), data.size() * sizeof(int), options);
+
+        std::vector<int> part(30000);
+        LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), 70003 * sizeof(int), options);
+        EXPECT_TRUE(std::equal(part.begin(), part.end(), data.begin() + 70003));
+
+        // 区间超出文件末尾时抛出异常。
+        EXPECT_THROW(LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), 80000 * sizeof(int), options), std::runtime_error);
+        EXPECT_THROW(LBlockIo::readRange("lblockio_missing.bin", part.data(), sizeof(int), 0, options), std::runtime_error);
+
+        std::remove(testFile.c_str());
+    });
+}
+
+TEST(LBlockIoTest, StreamTest)
+{
+    forEachBackend([](const LIoOptions &options) {
+        const std::string testFile = "lblockio_stream_test.bin";
+
+        // 以不规则的大小多次写入。
+        std::vector<int> data(54321);
+        std::iota(data.begin(), data.end(), 0);
+        {
+            LBlockWriter writer(testFile, options);
+            for (size_t begin = 0, step = 1; begin < data.size(); begin += step, step = step * 3 % 2000 + 1)
+                writer.write(data.data() + begin, std::min(step, data.size() - begin) * sizeof(int));
+            writer.close();
+        }
+
+        LBlockReader reader(testFile, options);
+        std::vector<int> actual;
+        const char *block;
+        while (size_t bytes = reader.next(block))
+        {
+            EXPECT_LE(bytes, options.blockSize);
+            actual.insert(actual.end(), reinterpret_cast<const int *>(block), reinterpret_cast<const int *>(block + bytes));
+        }
+        EXPECT_EQ(actual, data);
+        EXPECT_EQ(reader.next(block), 0);
+
+        // 空文件。
+        LBlockWriter(testFile, options).close();
+        EXPECT_EQ(LBlockReader(testFile, options).next(block), 0);
+
+        std::remove(testFile.c_str());
+    });
+}
+
+TEST(LBlockIoTest, DirectTest)
+{
+    forEachBackend([](const LIoOptions &options) {
+        const std::string testFile = "lblockio_direct_test.bin";
+
+        // 对齐的缓冲区使用 O_DIRECT 直接读写，元素个数使文件末尾不足一个对齐单位，块大小也不是对齐单位的整数倍。
+        LIoOptions io = options;
+        io.blockSize = 3 * 4096 + 100 * sizeof(int);
+
+        std::vector<int, LNumaAllocator<int>> data(100003);
+        std::iota(data.begin(), data.end(), 7);
+        LBlockIo::writeFile(testFile, data.data(), data.size() * sizeof(int), io);
+        EXPECT_EQ(std::filesystem::file_size(testFile), data.size() * sizeof(int));
+
+        // 对齐偏移、不对齐长度的区间，以及不对齐偏移（退化为普通读取）的区间。
+        std::vector<int, LNumaAllocator<int>> part(30001);
+        LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), 10 * 4096, io);
+        EXPECT_TRUE(std::equal(part.begin(), part.end(), data.begin() + 10 * 4096 / sizeof(int)));
+        LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), 70002 * sizeof(int), io);
+        EXPECT_TRUE(std::equal(part.begin(), part.end(), data.begin() + 70002));
+
+        // 区间恰好到文件末尾，以及超出文件末尾。
+        LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), (data.size() - part.size()) * sizeof(int), io);
+        EXPECT_TRUE(std::equal(part.begin(), part.end(), data.end() - part.size()));
+        EXPECT_THROW(LBlockIo::readRange(testFile, part.data(), part.size() * sizeof(int), 80 * 4096, io), std::runtime_error);
+
+        // 流式写出的最后一块补零后被截断到实际长度。
+        {
+            LBlockWriter writer(testFile, io);
+            writer.write(data.data(), 12345 * sizeof(int));
+            writer.write(data.data() + 12345, (data.size() - 12345) * sizeof(int));
+            writer.close();
+        }
+        EXPECT_EQ(std::filesystem::file_size(testFile), data.size() * sizeof(int));
+
+        LBlockReader reader(testFile, io);
+        std::vector<int> actual;
+        const char *block;
+        while (size_t bytes = reader.next(block)) actual.insert(actual.end(), reinterpret_cast<const int *>(block), reinterpret_cast<const int *>(block + bytes));
+        EXPECT_TRUE(std::equal(actual.begin(), actual.end(), data.begin(), data.end()));
+
+        std::remove(testFile.c_str());
+    });
+}
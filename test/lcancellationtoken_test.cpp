@@ -0,0 +1,51 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+
+#include "lcancellationtoken.h"
+
+
+TEST(LCancellationTokenTest, CancelTest)
+{
+    LCancellationToken token;
+    LCancellationToken copy = token;
+    EXPECT_FALSE(copy.isCancelled());
+    EXPECT_NO_THROW(copy.throwIfCancelled());
+
+    // 副本共享同一份状态。
+    std::thread([token]() mutable { token.cancel(); }).join();
+    EXPECT_TRUE(copy.isCancelled());
+
+    try
+    {
+        copy.throwIfCancelled();
+        FAIL();
+    }
+    catch (const LCancelledError &e)
+    {
+        EXPECT_FALSE(e.deadlineExceeded());
+    }
+
+    // 新构造的令牌不受影响。
+    EXPECT_FALSE(LCancellationToken().isCancelled());
+}
+
+TEST(LCancellationTokenTest, DeadlineTest)
+{
+    LCancellationToken token;
+    token.setTimeout(std::chrono::milliseconds(20));
+    EXPECT_FALSE(token.isCancelled());
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    EXPECT_TRUE(token.isCancelled());
+
+    try
+    {
+        token.throwIfCancelled();
+        FAIL();
+    }
+    catch (const LCancelledError &e)
+    {
+        EXPECT_TRUE(e.deadlineExceeded());
+    }
+}
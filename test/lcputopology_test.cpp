@@ -0,0 +1,46 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+#include "lglobalmacros.h"
+#include "lcputopology.h"
+#include "lthreadpool.h"
+
+
+TEST(LCpuTopologyTest, ParseCpuListTest)
+{
+    EXPECT_EQ(LCpuTopology::parseCpuList("0-3,8,10-11\n"), std::vector<int>({0, 1, 2, 3, 8, 10, 11}));
+    EXPECT_EQ(LCpuTopology::parseCpuList("5"), std::vector<int>({5}));
+    EXPECT_TRUE(LCpuTopology::parseCpuList("").empty());
+}
+
+TEST(LCpuTopologyTest, TopologyTest)
+{
+    std::vector<int> cpus = LCpuTopology::availableCpus();
+    ASSERT_FALSE(cpus.empty());
+
+    size_t count = LCpuTopology::recommendedThreadCount();
+    EXPECT_GE(count, 1);
+    EXPECT_LE(count, cpus.size());
+
+    // 拓扑信息覆盖所有可用 CPU，且按 NUMA 节点分组排列。
+    std::vector<LCpuInfo> infos = LCpuTopology::topology();
+    ASSERT_EQ(infos.size(), cpus.size());
+    EXPECT_TRUE(std::is_sorted(infos.begin(), infos.end(), [](const LCpuInfo &a, const LCpuInfo &b) { return a.numaNode < b.numaNode; }));
+}
+
+TEST(LCpuTopologyTest, PinWorkersTest)
+{
+    LThreadPoolOptions options;
+    options.threads = 2;
+    options.pinWorkers = true;
+    LThreadPool pool(options);
+
+    EXPECT_EQ(pool.size(), 2);
+
+    std::vector<LCpuInfo> infos = LCpuTopology::topology();
+    EXPECT_EQ(pool.workerCpu(0), infos[0].cpu);
+    EXPECT_EQ(pool.workerCpu(1), infos[1 % infos.size()].cpu);
+
+    EXPECT_EQ(pool.enqueue([] { return 1; }).get(), 1);
+}
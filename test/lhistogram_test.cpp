@@ -0,0 +1,52 @@
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+#include "lhistogram.h"
+
+
+TEST(LHistogramTest, BucketTest)
+{
+    // 下标连续覆盖整个 64 位取值范围，且每个值都落在所在桶的上下界之间。
+    EXPECT_EQ(LHistogram::bucketIndex(0), 0);
+    EXPECT_EQ(LHistogram::bucketIndex(31), 31);
+    EXPECT_EQ(LHistogram::bucketIndex(32), 32);
+    EXPECT_EQ(LHistogram::bucketIndex(UINT64_MAX), LHistogram::bucketCount - 1);
+    EXPECT_EQ(LHistogram::bucketUpperBound(LHistogram::bucketCount - 1), UINT64_MAX);
+
+    for (size_t i = 0; i + 1 < LHistogram::bucketCount; ++i) EXPECT_EQ(LHistogram::bucketUpperBound(i) + 1, LHistogram::bucketLowerBound(i + 1));
+
+    for (uint64_t value : {1ULL, 100ULL, 12345ULL, 1000000007ULL, 1ULL << 50})
+    {
+        size_t index = LHistogram::bucketIndex(value);
+        EXPECT_LE(LHistogram::bucketLowerBound(index), value);
+        EXPECT_GE(LHistogram::bucketUpperBound(index), value);
+    }
+}
+
+TEST(LHistogramTest, PercentileTest)
+{
+    LHistogram histogram;
+    EXPECT_EQ(histogram.snapshot().percentile(50), 0);
+
+    // 四个线程并发记录 1 到 10000，各记录一遍。
+    std::vector<std::thread> threads;
+    for (int t = 0; t < 4; ++t)
+        threads.emplace_back([&histogram] {
+            for (uint64_t i = 1; i <= 10000; ++i) histogram.record(i);
+        });
+    for (auto &thread : threads) thread.join();
+
+    LHistogramSnapshot snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 40000);
+    EXPECT_EQ(snapshot.min, 1);
+    EXPECT_EQ(snapshot.max, 10000);
+    EXPECT_DOUBLE_EQ(snapshot.mean(), 5000.5);
+
+    // 相对误差不超过 1/32。
+    EXPECT_NEAR(snapshot.percentile(50), 5000, 5000 / 32);
+    EXPECT_NEAR(snapshot.percentile(99), 9900, 9900 / 32);
+    EXPECT_EQ(snapshot.percentile(100), 10000);
+    EXPECT_EQ(snapshot.percentile(0), 1);
+}
@@ -0,0 +1,148 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "llinesorter.h"
+#include "lutil.h"
+
+
+/**
+ * @brief 生成随机文本行：长短不一、共享长前缀、含空行与零字节，最后一行没有换行符。
+ */
+static std::vector<std::string> randomLines(size_t count, unsigned int seed)
+{
+    std::mt19937 engine(seed);
+    std::vector<std::string> prefixes = {"", "user-", "2025-01-01T00:00:00 INFO request id=", std::string(40, 'a')};
+
+    std::vector<std::string> lines;
+    for (size_t i = 0; i < count; ++i)
+    {
+        std::string line = prefixes[engine() % prefixes.size()];
+        size_t length = engine() % 24;
+        for (size_t j = 0; j < length; ++j) line.push_back(static_cast<char>(engine() % 5 ? 'a' + engine() % 4 : engine() % 256));
+        line.erase(std::remove(line.begin(), line.end(), '\n'), line.end());
+        lines.push_back(line);
+    }
+
+
+    return lines;
+}
+
+/**
+ * @brief 按行拼接，最后一行之后不加换行符。
+ */
+static std::string joinLines(const std::vector<std::string> &lines)
+{
+    std::string text;
+    for (size_t i = 0; i < lines.size(); ++i) text += lines[i] + (i + 1 < lines.size() ? "\n" : "");
+
+
+    return text;
+}
+
+/**
+ * @brief 按字节序排序后拼接，每行以换行符结尾。
+ */
+static std::string sortedText(std::vector<std::string> lines)
+{
+    std::sort(lines.begin(), lines.end(), [](const std::string &a, const std::string &b) {
+        return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), [](char x, char y) { return static_cast<unsigned char>(x) < static_cast<unsigned char>(y); });
+    });
+
+    std::string text;
+    for (const std::string &line : lines) text += line + "\n";
+
+
+    return text;
+}
+
+
+TEST(LLineSorterTest, StreamTest)
+{
+    std::vector<std::string> lines = randomLines(50000, 48);
+    std::string expected = sortedText(lines);
+
+    LThreadPool pool(4, 1);
+
+    // 小块多轮归并、内存归并段，以及比块还长的行。
+    LSorterOptions options;
+    options.chunkSize = 16 * 1024;
+    options.k = 4;
+    for (uint64_t budget : {uint64_t(0), uint64_t(64) << 20})
+    {
+        SCOPED_TRACE(budget);
+        options.memoryBudget = budget;
+
+        LLineSorter sorter(&pool, options);
+        std::istringstream input(joinLines(lines));
+        std::ostringstream output;
+        sorter.sortStream(input, output);
+        EXPECT_EQ(output.str(), expected);
+    }
+
+    std::vector<std::string> longLines = {std::string(100000, 'z'), "b", std::string(70000, 'z') + "a", "", std::string(70000, 'z')};
+    LLineSorter sorter(&pool, 16 * 1024, 2);
+    std::istringstream input(joinLines(longLines) + "\n");
+    std::ostringstream output;
+    sorter.sortStream(input, output);
+    EXPECT_EQ(output.str(), sortedText(longLines));
+
+    // 多于 1000 个归并段：多轮归并的输出文件名不能冲突。
+    {
+        std::vector<std::string> manyLines = randomLines(3000, 50);
+        LLineSorter manySorter(&pool, 64, 8);
+        std::istringstream manyInput(joinLines(manyLines) + "\n");
+        std::ostringstream manyOutput;
+        manySorter.sortStream(manyInput, manyOutput);
+        EXPECT_EQ(manyOutput.str(), sortedText(manyLines));
+    }
+
+    // 空输入。
+    std::istringstream empty;
+    std::ostringstream emptyOutput;
+    sorter.sortStream(empty, emptyOutput);
+    EXPECT_TRUE(emptyOutput.str().empty());
+
+    EXPECT_EQ(std::count_if(std::filesystem::directory_iterator(LUtil::executableDirectory()), std::filesystem::directory_iterator(), [](const auto &entry) {
+                  std::string name = entry.path().filename().string();
+                  return 0 == name.rfind("lines_", 0) || 0 == name.rfind("tmp_merge_", 0);
+              }),
+              0);
+}
+
+TEST(LLineSorterTest, RunTest)
+{
+    const std::string testFile = "llinesorter_test.txt";
+    std::vector<std::string> lines = randomLines(30000, 49);
+    {
+        std::ofstream ofs(testFile, std::ios::binary);
+        ofs << joinLines(lines);
+    }
+
+    LThreadPool pool(2, 1);
+    LLineSorter sorter(&pool, 8 * 1024, 3);
+    sorter.run(testFile);
+
+    std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+    std::stringstream actual;
+    actual << ifs.rdbuf();
+    EXPECT_EQ(actual.str(), sortedText(lines));
+
+    // 取消时不留下结果文件。
+    ifs.close();
+    std::remove((testFile + ".sorted").c_str());
+    LCancellationToken token;
+    token.cancel();
+    EXPECT_THROW(sorter.run(testFile, token), LCancelledError);
+    EXPECT_FALSE(std::filesystem::exists(testFile + ".sorted"));
+
+    EXPECT_THROW(sorter.run("llinesorter_missing.txt"), std::runtime_error);
+
+    std::remove(testFile.c_str());
+}
@@ -0,0 +1,79 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <vector>
+
+#include "lglobalmacros.h"
+#include "lmappedfile.h"
+
+#ifdef L_OS_LINUX
+#include <sys/stat.h>
+#endif
+
+
+TEST(LMappedFileTest, MapTest)
+{
+    const std::string testFile = "lmappedfile_test.bin";
+    std::vector<int> expected(100000);
+    std::iota(expected.begin(), expected.end(), -50000);
+    {
+        std::ofstream ofs(testFile, std::ios::binary);
+        ofs.write(reinterpret_cast<const char *>(expected.data()), expected.size() * sizeof(int));
+    }
+
+    for (bool populate : {false, true})
+    {
+        SCOPED_TRACE(populate);
+
+        LMappedFile file(testFile, populate);
+#ifdef L_OS_LINUX
+        ASSERT_TRUE(file.isMapped());
+        EXPECT_EQ(file.size(), expected.size() * sizeof(int));
+
+        // 按偏移复制任意区间，预读的起始偏移不必按页对齐。
+        size_t offset = 12345 * sizeof(int);
+        file.prefetch(offset, 1000 * sizeof(int));
+        std::vector<int> slice(1000);
+        std::memcpy(slice.data(), file.data() + offset, slice.size() * sizeof(int));
+        EXPECT_TRUE(std::equal(slice.begin(), slice.end(), expected.begin() + 12345));
+        EXPECT_EQ(0, std::memcmp(file.data(), expected.data(), file.size()));
+
+        // 越界的预读被忽略。
+        file.prefetch(file.size(), 4096);
+        file.prefetch(file.size() - 1, 1 << 20);
+#else
+        EXPECT_FALSE(file.isMapped());
+#endif
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LMappedFileTest, FallbackTest)
+{
+    // 不存在的文件。
+    LMappedFile missing("lmappedfile_missing.bin");
+    EXPECT_FALSE(missing.isMapped());
+    EXPECT_EQ(missing.data(), nullptr);
+    EXPECT_EQ(missing.size(), 0);
+    missing.prefetch(0, 4096);
+
+    // 空文件无法映射。
+    const std::string emptyFile = "lmappedfile_empty.bin";
+    std::ofstream(emptyFile, std::ios::binary).close();
+    EXPECT_FALSE(LMappedFile(emptyFile).isMapped());
+    std::remove(emptyFile.c_str());
+
+#ifdef L_OS_LINUX
+    // 管道不是普通文件，不映射。
+    const std::string fifo = "lmappedfile_fifo";
+    std::remove(fifo.c_str());
+    ASSERT_EQ(0, ::mkfifo(fifo.c_str(), 0600));
+    EXPECT_FALSE(LMappedFile(fifo).isMapped());
+    std::remove(fifo.c_str());
+#endif
+}
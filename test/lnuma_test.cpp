@@ -0,0 +1,37 @@
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "lnuma.h"
+
+
+TEST(LNumaTest, AllocateTest)
+{
+    EXPECT_GE(LNuma::nodeCount(), 1);
+
+    // 在节点 0 上分配并写入，所有平台上都应可用；支持 NUMA 策略时页应位于节点 0。
+    size_t bytes = 1 << 20;
+    char *ptr = static_cast<char *>(LNuma::allocate(bytes, 0));
+    ASSERT_NE(ptr, nullptr);
+    for (size_t i = 0; i < bytes; i += 4096) ptr[i] = 1;
+
+    if (LNuma::available())
+    {
+        EXPECT_EQ(LNuma::nodeOfAddress(ptr), 0);
+    }
+
+    LNuma::deallocate(ptr, bytes);
+}
+
+TEST(LNumaTest, AllocatorTest)
+{
+    std::vector<int, LNumaAllocator<int>> a(LNumaAllocator<int>(0));
+    std::vector<int, LNumaAllocator<int>> b;
+
+    for (int i = 0; i < 100000; ++i) a.push_back(i);
+    b.swap(a);
+
+    EXPECT_EQ(b.size(), 100000);
+    EXPECT_EQ(b.get_allocator().node(), 0);
+    EXPECT_EQ(b[99999], 99999);
+}
@@ -0,0 +1,89 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include "lfloatless.h"
+#include "lradixsort.h"
+
+
+/**
+ * @brief 基数排序 values，返回结果。
+ */
+template <typename Key>
+static std::vector<Key> radixSorted(std::vector<Key> values)
+{
+    std::vector<Key> scratch(values.size());
+    Key *sorted = LRadixSort::sort(values.data(), scratch.data(), values.size());
+
+
+    return std::vector<Key>(sorted, sorted + values.size());
+}
+
+
+TEST(LRadixSortTest, SortTest)
+{
+    std::mt19937_64 engine(50);
+
+    // 随机 64 位键，以及高位全部相同、只需部分轮次的 32 位键。
+    std::vector<uint64_t> wide(100000);
+    for (uint64_t &v : wide) v = engine();
+    std::vector<uint32_t> narrow(100001);
+    for (uint32_t &v : narrow) v = 0xABCD0000u | static_cast<uint32_t>(engine() % 3000);
+
+    std::vector<uint64_t> wideExpected = wide;
+    std::sort(wideExpected.begin(), wideExpected.end());
+    EXPECT_EQ(radixSorted(wide), wideExpected);
+
+    std::vector<uint32_t> narrowExpected = narrow;
+    std::sort(narrowExpected.begin(), narrowExpected.end());
+    EXPECT_EQ(radixSorted(narrow), narrowExpected);
+
+    // 空输入、单个元素与全部相同。
+    EXPECT_TRUE(radixSorted(std::vector<uint32_t>()).empty());
+    EXPECT_EQ(radixSorted(std::vector<uint8_t>{7}), std::vector<uint8_t>{7});
+    EXPECT_EQ(radixSorted(std::vector<uint16_t>(1000, 9)), std::vector<uint16_t>(1000, 9));
+}
+
+TEST(LRadixSortTest, FloatKeyTest)
+{
+    using Key = LFloatKey<double>;
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+
+    // 全序：-inf < 负数 < -0.0 < +0.0 < 正数 < +inf < 正 NaN < 负 NaN。
+    std::vector<double> ordered = {-inf, -std::numeric_limits<double>::max(), -1.5, -std::numeric_limits<double>::denorm_min(), -0.0, 0.0, std::numeric_limits<double>::denorm_min(), 1.5, std::numeric_limits<double>::max(), inf, nan, -nan};
+    for (size_t i = 0; i + 1 < ordered.size(); ++i)
+    {
+        SCOPED_TRACE(i);
+        EXPECT_LT(Key::encode(ordered[i]), Key::encode(ordered[i + 1]));
+        EXPECT_TRUE(LFloatLess<double>()(ordered[i], ordered[i + 1]));
+        EXPECT_FALSE(LFloatLess<double>()(ordered[i + 1], ordered[i]));
+    }
+    EXPECT_EQ(Key::encode(-inf), 0u);
+    EXPECT_FALSE(LFloatLess<double>()(nan, nan));
+
+    // 编码是双射，解码逐位还原，包括 NaN 的符号与负载。
+    std::mt19937_64 engine(50);
+    for (int i = 0; i < 100000; ++i)
+    {
+        uint64_t bits = engine();
+        double value;
+        std::memcpy(&value, &bits, sizeof(value));
+        double decoded = Key::decode(Key::encode(value));
+        EXPECT_EQ(0, std::memcmp(&decoded, &value, sizeof(value)));
+    }
+    for (uint32_t bits : {0u, 0x80000000u, 0x7F800000u, 0xFF800000u, 0x7F800001u, 0xFFFFFFFFu, 0x7FFFFFFFu})
+    {
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        float decoded = LFloatKey<float>::decode(LFloatKey<float>::encode(value));
+        uint32_t decodedBits;
+        std::memcpy(&decodedBits, &decoded, sizeof(decoded));
+        EXPECT_EQ(decodedBits, bits);
+    }
+}
@@ -0,0 +1,121 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <random>
+#include <vector>
+
+#include "lruncodec.h"
+
+
+/**
+ * @brief 编码后逐帧解码，返回还原出的序列。
+ */
+static std::vector<int> roundTrip(const std::vector<int> &values, LRunCodec::Bytes &encoded)
+{
+    encoded.clear();
+    LRunCodec::encode(values.data(), values.size(), encoded);
+
+    std::vector<int> decoded;
+    std::vector<int> frame(LRunCodec::frameSize);
+    size_t offset = 0;
+    while (offset < encoded.size())
+    {
+        size_t bytes = LRunCodec::frameBytes(encoded.data() + offset, encoded.size() - offset);
+        EXPECT_GT(bytes, 0);
+        EXPECT_LE(offset + bytes, encoded.size());
+        size_t count = LRunCodec::decodeFrame(encoded.data() + offset, bytes, frame.data());
+        decoded.insert(decoded.end(), frame.begin(), frame.begin() + count);
+        offset += bytes;
+    }
+
+
+    return decoded;
+}
+
+
+TEST(LRunCodecTest, RoundTripTest)
+{
+    std::mt19937 engine(42);
+    LRunCodec::Bytes encoded;
+
+    // 跨越多帧、末帧与末组不满的随机有序序列。
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+    std::vector<int> values(3 * LRunCodec::frameSize + 1000);
+    for (int &v : values) v = dist(engine);
+    std::sort(values.begin(), values.end());
+    EXPECT_EQ(roundTrip(values, encoded), values);
+
+    // 边界长度：空、1 个值、恰好一组差值、多一个差值。
+    for (size_t n : {size_t(0), size_t(1), LRunCodec::groupSize, LRunCodec::groupSize + 1, LRunCodec::frameSize, LRunCodec::frameSize + 1})
+    {
+        SCOPED_TRACE(n);
+        std::vector<int> part(values.begin(), values.begin() + n);
+        EXPECT_EQ(roundTrip(part, encoded), part);
+    }
+    EXPECT_TRUE(roundTrip({}, encoded).empty());
+    EXPECT_TRUE(encoded.empty());
+
+    // 全部相等时差值位宽为 0。
+    std::vector<int> duplicates(1000, 7);
+    EXPECT_EQ(roundTrip(duplicates, encoded), duplicates);
+
+    // INT_MIN 到 INT_MAX 的差值需要完整的 32 位。
+    std::vector<int> extremes = {INT_MIN, INT_MIN, -1, 0, INT_MAX, INT_MAX};
+    EXPECT_EQ(roundTrip(extremes, encoded), extremes);
+    extremes = {INT_MIN, INT_MAX};
+    EXPECT_EQ(roundTrip(extremes, encoded), extremes);
+
+    // 无序序列按回绕的差值编码，仍可正确还原。
+    std::vector<int> unsorted(5000);
+    for (int &v : unsorted) v = dist(engine);
+    EXPECT_EQ(roundTrip(unsorted, encoded), unsorted);
+}
+
+TEST(LRunCodecTest, RatioTest)
+{
+    // 相邻差值小于 16 时每个值约占 4 位，压缩到原始大小的八分之一左右。
+    std::mt19937 engine(7);
+    std::uniform_int_distribution<int> step(0, 15);
+    std::vector<int> values(100000);
+    int current = -500000;
+    for (int &v : values) v = current += step(engine);
+
+    LRunCodec::Bytes encoded;
+    EXPECT_EQ(roundTrip(values, encoded), values);
+    EXPECT_LT(encoded.size(), values.size() * sizeof(int) / 7);
+}
+
+TEST(LRunCodecTest, CorruptedTest)
+{
+    std::vector<int> values(1000);
+    for (size_t i = 0; i < values.size(); ++i) values[i] = static_cast<int>(i * 3);
+
+    LRunCodec::Bytes encoded;
+    LRunCodec::encode(values.data(), values.size(), encoded);
+    std::vector<int> frame(LRunCodec::frameSize);
+
+    // 不足一个帧头时返回 0。
+    EXPECT_EQ(LRunCodec::frameBytes(encoded.data(), LRunCodec::headerBytes - 1), 0);
+    EXPECT_EQ(LRunCodec::frameBytes(encoded.data(), encoded.size()), encoded.size());
+
+    // 截断的帧。
+    EXPECT_THROW(LRunCodec::decodeFrame(encoded.data(), encoded.size() - 1, frame.data()), std::runtime_error);
+
+    // 非法的值个数。
+    LRunCodec::Bytes corrupted = encoded;
+    uint32_t zero = 0;
+    std::memcpy(corrupted.data() + 4, &zero, sizeof(zero));
+    EXPECT_THROW(LRunCodec::frameBytes(corrupted.data(), corrupted.size()), std::runtime_error);
+
+    // 非法的位宽。
+    corrupted = encoded;
+    corrupted[LRunCodec::headerBytes] = 33;
+    EXPECT_THROW(LRunCodec::decodeFrame(corrupted.data(), corrupted.size(), frame.data()), std::runtime_error);
+
+    // 位宽与帧的字节数不一致。
+    corrupted = encoded;
+    corrupted[LRunCodec::headerBytes] = 1;
+    EXPECT_THROW(LRunCodec::decodeFrame(corrupted.data(), corrupted.size(), frame.data()), std::runtime_error);
+}
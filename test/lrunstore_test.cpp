@@ -0,0 +1,258 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+#include "lrunstore.h"
+#include "lruncodec.h"
+
+
+TEST(LRunStoreTest, BudgetTest)
+{
+    LRunStore store(1000 * sizeof(int));
+    EXPECT_EQ(store.memoryBudget(), 1000 * sizeof(int));
+
+    // 预算内接管缓冲区，原缓冲区变为空，元素地址不变（没有复制）。
+    LRunBuffer buffer(600);
+    std::iota(buffer.begin(), buffer.end(), 0);
+    const int *data = buffer.data();
+
+    LRun run = store.adopt(buffer);
+    ASSERT_TRUE(run.inMemory());
+    EXPECT_TRUE(buffer.empty());
+    EXPECT_EQ(run.buffer().data(), data);
+    EXPECT_EQ(run.buffer().size(), 600);
+    EXPECT_EQ(store.memoryUsed(), 600 * sizeof(int));
+
+    // 超出预算时返回空的归并段，缓冲区保持不变。
+    LRunBuffer other(500);
+    EXPECT_TRUE(store.adopt(other).empty());
+    EXPECT_EQ(other.size(), 500);
+    EXPECT_TRUE(store.reserve(401, -1).empty());
+
+    LRun reserved = store.reserve(400, -1);
+    ASSERT_TRUE(reserved.inMemory());
+    EXPECT_TRUE(reserved.buffer().empty());
+    EXPECT_GE(reserved.buffer().capacity(), 400);
+    EXPECT_EQ(store.memoryUsed(), 1000 * sizeof(int));
+
+    // 副本共享内存，最后一个引用释放时归还预算。
+    LRun copy = run;
+    run.discard();
+    EXPECT_TRUE(run.empty());
+    EXPECT_EQ(store.memoryUsed(), 1000 * sizeof(int));
+    copy = LRun();
+    EXPECT_EQ(store.memoryUsed(), 400 * sizeof(int));
+    reserved.discard();
+    EXPECT_EQ(store.memoryUsed(), 0);
+
+    // 预算为 0 时所有归并段都不留在内存中。
+    LRunStore disabled(0);
+    LRunBuffer small(1);
+    EXPECT_TRUE(disabled.adopt(small).empty());
+}
+
+TEST(LRunStoreTest, TypedBufferTest)
+{
+    // 预算按元素字节数计算，内存归并段按字节读取。
+    LRunStore store(1000 * sizeof(double));
+
+    LRunBufferT<double> buffer = {0.5, 1.5, 2.5};
+    buffer.reserve(600);
+    LRun run = store.adopt(buffer);
+    ASSERT_TRUE(run.inMemory());
+    EXPECT_EQ(run.buffer<double>().size(), 3);
+    EXPECT_EQ(run.memoryBytes(), 3 * sizeof(double));
+    EXPECT_EQ(store.memoryUsed(), run.buffer<double>().capacity() * sizeof(double));
+
+    EXPECT_TRUE(store.reserve<double>(401, -1).empty());
+    LRun reserved = store.reserve<int64_t>(400, -1);
+    ASSERT_TRUE(reserved.inMemory());
+    EXPECT_GE(reserved.buffer<int64_t>().capacity(), 400);
+
+    {
+        LRunReader reader(run, LIoOptions());
+        const char *data;
+        EXPECT_EQ(reader.next(data), 3 * sizeof(double));
+        EXPECT_EQ(reinterpret_cast<const double *>(data)[2], 2.5);
+    }
+
+    run.discard();
+    reserved.discard();
+    EXPECT_EQ(store.memoryUsed(), 0);
+}
+
+TEST(LRunStoreTest, ReaderTest)
+{
+    LIoOptions options;
+    options.blockSize = 4096;
+
+    std::vector<int> expected(10000);
+    std::iota(expected.begin(), expected.end(), -5000);
+
+    // 内存归并段一次返回整个缓冲区。
+    LRunStore store(1 << 20);
+    LRunBuffer buffer(expected.begin(), expected.end());
+    LRun memoryRun = store.adopt(buffer);
+    {
+        LRunReader reader(memoryRun, options);
+        const char *data;
+        EXPECT_EQ(reader.next(data), expected.size() * sizeof(int));
+        EXPECT_EQ(reinterpret_cast<const int *>(data), memoryRun.buffer().data());
+        EXPECT_EQ(reader.next(data), 0);
+    }
+
+    // 磁盘归并段按块读取，discard() 删除文件。
+    const std::string testFile = "lrunstore_reader_test.bin";
+    LBlockIo::writeFile(testFile, expected.data(), expected.size() * sizeof(int), options);
+    LRun fileRun(testFile);
+    EXPECT_FALSE(fileRun.inMemory());
+    {
+        LRunReader reader(fileRun, options);
+        std::vector<int> actual;
+        const char *data;
+        while (size_t bytes = reader.next(data)) actual.insert(actual.end(), reinterpret_cast<const int *>(data), reinterpret_cast<const int *>(data + bytes));
+        EXPECT_EQ(actual, expected);
+    }
+
+    fileRun.discard();
+    EXPECT_TRUE(fileRun.empty());
+    EXPECT_FALSE(std::filesystem::exists(testFile));
+
+    // 压缩归并段逐帧解码，帧跨越读取的块。
+    LRunCodec::Bytes encoded;
+    LRunCodec::encode(expected.data(), expected.size(), encoded);
+    LBlockIo::writeFile(testFile, encoded.data(), encoded.size(), options);
+    LRun compressedRun(testFile, true);
+    EXPECT_TRUE(compressedRun.compressed());
+    {
+        LRunReader reader(compressedRun, options);
+        std::vector<int> actual;
+        const char *data;
+        while (size_t bytes = reader.next(data)) actual.insert(actual.end(), reinterpret_cast<const int *>(data), reinterpret_cast<const int *>(data + bytes));
+        EXPECT_EQ(actual, expected);
+    }
+
+    // 截断的压缩归并段读到末尾时抛出异常。
+    LBlockIo::writeFile(testFile, encoded.data(), encoded.size() - 1, options);
+    {
+        LRunReader reader(compressedRun, options);
+        const char *data;
+        EXPECT_THROW(
+            {
+                while (reader.next(data)) continue;
+            },
+            std::runtime_error);
+    }
+
+    compressedRun.discard();
+    EXPECT_FALSE(compressedRun.compressed());
+    EXPECT_FALSE(std::filesystem::exists(testFile));
+}
+
+TEST(LRunStoreTest, MergerTest)
+{
+    LIoOptions options;
+    options.blockSize = 4096;
+
+    // 内存归并段与磁盘归并段混合归并，包含重复值与空归并段。
+    std::vector<int> a = {-5, 0, 0, 3, 9};
+    std::vector<int> b(3000);
+    std::iota(b.begin(), b.end(), -1000);
+
+    LRunStore store(1 << 20);
+    LRunBuffer buffer(a.begin(), a.end());
+    LRunBuffer emptyBuffer;
+    const std::string testFile = "lrunstore_merger_test.bin";
+    LBlockIo::writeFile(testFile, b.data(), b.size() * sizeof(int), options);
+
+    std::vector<int> expected = a;
+    expected.insert(expected.end(), b.begin(), b.end());
+    std::sort(expected.begin(), expected.end());
+
+    std::vector<LRun> runs = {store.adopt(buffer), LRun(testFile), store.adopt(emptyBuffer)};
+    {
+        LRunMerger merger(runs, options, 100);
+        std::vector<int> actual;
+        const int *data;
+        while (size_t count = merger.next(data))
+        {
+            EXPECT_LE(count, 100);
+            actual.insert(actual.end(), data, data + count);
+        }
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(merger.next(data), 0);
+    }
+
+    // 只有一个输入时直接返回该输入的各块。
+    {
+        LRunMerger merger({LRun(testFile)}, options, 100);
+        std::vector<int> actual;
+        const int *data;
+        while (size_t count = merger.next(data)) actual.insert(actual.end(), data, data + count);
+        EXPECT_EQ(actual, b);
+    }
+
+    // 没有输入。
+    LRunMerger empty({}, options, 100);
+    const int *data;
+    EXPECT_EQ(empty.next(data), 0);
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LRunStoreTest, TypedMergerTest)
+{
+    // 按比较器归并：降序的 64 位整数。
+    LIoOptions options;
+    LRunStore store(1 << 20);
+
+    LRunBufferT<int64_t> a = {int64_t(1) << 40, 7, -3};
+    LRunBufferT<int64_t> b = {int64_t(1) << 41, 7, 0, -(int64_t(1) << 40)};
+    std::vector<LRun> runs = {store.adopt(a), store.adopt(b)};
+
+    LBasicRunMerger<int64_t, std::greater<int64_t>> merger(runs, options, 2);
+    std::vector<int64_t> actual;
+    const int64_t *data;
+    while (size_t count = merger.next(data)) actual.insert(actual.end(), data, data + count);
+    EXPECT_EQ(actual, (std::vector<int64_t>{int64_t(1) << 41, int64_t(1) << 40, 7, 7, 0, -3, -(int64_t(1) << 40)}));
+
+    // 按键比较的记录：堆中只缓存键与记录地址，磁盘归并段逐块读取时记录仍完整输出。
+    struct Record
+    {
+        int key;
+        int payload[7];
+    };
+    struct RecordKey
+    {
+        int operator()(const Record &record) const { return record.key; }
+    };
+
+    options.blockSize = 4 * sizeof(Record);
+    std::vector<Record> c(50), d(30);
+    for (int i = 0; i < 50; ++i) c[i] = {2 * i, {i, i, i, i, i, i, i}};
+    for (int i = 0; i < 30; ++i) d[i] = {3 * i, {-i, -i, -i, -i, -i, -i, -i}};
+    const std::string testFile = "lrunstore_keyed_test.bin";
+    LBlockIo::writeFile(testFile, d.data(), d.size() * sizeof(Record), options);
+
+    LRunBufferT<Record> buffer(c.begin(), c.end());
+    LBasicRunMerger<Record, LKeyLess<RecordKey>> keyed({store.adopt(buffer), LRun(testFile)}, options, 7);
+    std::vector<Record> merged;
+    const Record *records;
+    while (size_t count = keyed.next(records)) merged.insert(merged.end(), records, records + count);
+
+    ASSERT_EQ(merged.size(), 80);
+    EXPECT_TRUE(std::is_sorted(merged.begin(), merged.end(), LKeyLess<RecordKey>()));
+    for (const Record &record : merged)
+    {
+        bool fromC = record.payload[0] >= 0 && record.key == 2 * record.payload[0];
+        bool fromD = record.payload[0] <= 0 && record.key == -3 * record.payload[0];
+        EXPECT_TRUE(fromC || fromD);
+        EXPECT_EQ(record.payload[6], record.payload[0]);
+    }
+
+    std::remove(testFile.c_str());
+}
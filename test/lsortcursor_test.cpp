@@ -0,0 +1,98 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <numeric>
+#include <vector>
+
+#include "lsortcursor.h"
+
+
+/**
+ * @brief 将有序数据写成磁盘归并段。
+ */
+static LRun writeRun(const std::string &filePath, const std::vector<int> &values, const LIoOptions &options)
+{
+    LBlockIo::writeFile(filePath, values.data(), values.size() * sizeof(int), options);
+
+
+    return LRun(filePath);
+}
+
+
+TEST(LSortCursorTest, NextTest)
+{
+    LIoOptions options;
+    options.blockSize = 4096;
+
+    // 一个内存归并段与两个磁盘归并段交错归并。
+    std::vector<int> a(5000), b(3000), c(7000);
+    for (size_t i = 0; i < a.size(); ++i) a[i] = static_cast<int>(3 * i);
+    for (size_t i = 0; i < b.size(); ++i) b[i] = static_cast<int>(3 * i + 1);
+    for (size_t i = 0; i < c.size(); ++i) c[i] = static_cast<int>(3 * i + 2) - 10000;
+
+    std::vector<int> expected;
+    expected.insert(expected.end(), a.begin(), a.end());
+    expected.insert(expected.end(), b.begin(), b.end());
+    expected.insert(expected.end(), c.begin(), c.end());
+    std::sort(expected.begin(), expected.end());
+
+    LRunStore store(1 << 20);
+    LRunBuffer buffer(a.begin(), a.end());
+    std::vector<LRun> runs = {store.adopt(buffer), writeRun("lsortcursor_b.bin", b, options), writeRun("lsortcursor_c.bin", c, options)};
+    ASSERT_TRUE(runs[0].inMemory());
+
+    LSortCursor cursor(runs, options, LCancellationToken());
+    std::vector<int> actual;
+    const int *data;
+    while (size_t count = cursor.next(data))
+    {
+        EXPECT_LE(count, options.blockSize / sizeof(int));
+        actual.insert(actual.end(), data, data + count);
+    }
+    EXPECT_EQ(actual, expected);
+
+    // 读完后归并段已丢弃，继续调用返回 0。
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_b.bin"));
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_c.bin"));
+    runs.clear();
+    EXPECT_EQ(store.memoryUsed(), 0);
+    EXPECT_EQ(cursor.next(data), 0);
+
+    // 没有归并段的游标立即结束。
+    LSortCursor empty({}, options, LCancellationToken());
+    EXPECT_EQ(empty.next(data), 0);
+}
+
+TEST(LSortCursorTest, DiscardTest)
+{
+    LIoOptions options;
+    options.blockSize = 4096;
+
+    std::vector<int> values(10000);
+    std::iota(values.begin(), values.end(), 0);
+
+    // 未读完就析构时删除临时文件。
+    {
+        LSortCursor cursor({writeRun("lsortcursor_d1.bin", values, options), writeRun("lsortcursor_d2.bin", values, options)}, options, LCancellationToken());
+        const int *data;
+        EXPECT_GT(cursor.next(data), 0);
+    }
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_d1.bin"));
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_d2.bin"));
+
+    // 取消后 next() 抛出异常，析构时同样清理。
+    LCancellationToken token;
+    {
+        LSortCursor cursor({writeRun("lsortcursor_d1.bin", values, options)}, options, token);
+        token.cancel();
+        const int *data;
+        EXPECT_THROW(cursor.next(data), LCancelledError);
+    }
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_d1.bin"));
+
+    // 打开失败时构造函数丢弃其余归并段并抛出异常。
+    LRun existing = writeRun("lsortcursor_d1.bin", values, options);
+    EXPECT_THROW(LSortCursor({existing, LRun("lsortcursor_missing.bin")}, options, LCancellationToken()), std::runtime_error);
+    EXPECT_FALSE(std::filesystem::exists("lsortcursor_d1.bin"));
+}
@@ -1,6 +1,113 @@
 #include <gtest/gtest.h>
 
+#include <fstream>
+#include <algorithm>
+#include <filesystem>
+#include <thread>
+#include <sstream>
+#include <cstring>
+#include <random>
+#include <cmath>
+#include <limits>
+
+#include "lglobalmacros.h"
+
 #include "lsorter.h"
+#include "lrandom.h"
+#include "lutil.h"
+
+#ifdef L_OS_LINUX
+#include <unistd.h>
+#endif
+
+
+/**
+ * @brief 统计目录中文件名以指定前缀开头的文件数量。
+ */
+static size_t countFiles(const std::string &directory, const std::string &prefix)
+{
+    size_t count = 0;
+    for (const auto &entry : std::filesystem::directory_iterator(directory.empty() ? "." : directory))
+        if (0 == entry.path().filename().string().rfind(prefix, 0)) ++count;
+
+
+    return count;
+}
+
+
+/**
+ * @brief 将 values 写入文件，用 LBasicSorter<T, Compare> 排序，返回结果文件的内容。
+ */
+template <typename T, typename Compare = LDefaultLess<T>>
+static std::vector<T> sortValues(LThreadPool &pool, const std::string &testFile, const std::vector<T> &values, const LSorterOptions &options, Compare compare = Compare())
+{
+    {
+        std::ofstream ofs(testFile, std::ios::binary);
+        ofs.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(T));
+    }
+
+    LBasicSorter<T, Compare> sorter(&pool, options, compare);
+    sorter.runAsync(testFile).get();
+
+    std::vector<T> actual(values.size());
+    std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+    ifs.read(reinterpret_cast<char *>(actual.data()), actual.size() * sizeof(T));
+    EXPECT_EQ(ifs.gcount(), values.size() * sizeof(T));
+    EXPECT_EQ(std::filesystem::file_size(testFile + ".sorted"), values.size() * sizeof(T));
+    ifs.close();
+
+    std::remove((testFile + ".sorted").c_str());
+    std::remove(testFile.c_str());
+
+
+    return actual;
+}
+
+/**
+ * @brief 12 字节的记录，大小不整除 4 KiB。
+ */
+struct LSorterTestRecord
+{
+    uint32_t key;
+    uint32_t index;
+    uint32_t payload;
+};
+
+/**
+ * @brief 64 字节的记录：8 字节的键加 56 字节的负载。
+ */
+struct LSorterTestWideRecord
+{
+    int64_t key;
+    uint32_t index;
+    char payload[52];
+};
+
+/**
+ * @brief 6 字节的记录，大小不整除 4：16 位的键加 32 位的下标，按 16 位拆开存放以免补齐。
+ */
+struct LSorterTestOddRecord
+{
+    uint16_t key;
+    uint16_t indexHigh;
+    uint16_t indexLow;
+
+    uint32_t index() const
+    {
+        return (uint32_t(indexHigh) << 16) | indexLow;
+    }
+};
+
+/**
+ * @brief LSorterTestWideRecord 的取键函数对象。
+ */
+struct LSorterTestWideKey
+{
+    int64_t operator()(const LSorterTestWideRecord &record) const
+    {
+        return record.key;
+    }
+};
 
 
 TEST(LSorterTest, Test1)
@@ -10,4 +117,1114 @@ TEST(LSorterTest, Test1)
             LSorter(nullptr);
         },
         std::runtime_error);
+
+    // k 小于 2 时归并无法收敛。
+    LThreadPool pool(1);
+    EXPECT_THROW(LSorter(&pool, 64 * 1024, 0), std::runtime_error);
+    EXPECT_THROW(LSorter(&pool, 64 * 1024, 1), std::runtime_error);
+    EXPECT_NO_THROW(LSorter(&pool, 64 * 1024, 2));
+}
+
+TEST(LSorterTest, RunTest)
+{
+    const std::string testFile = "lsorter_test.bin";
+    int count = 300000;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    // 块大小取得较小，保证产生多个块并经过多轮归并。
+    LThreadPool pool(4);
+    LSorter sorter(&pool, 64 * 1024, 4);
+    sorter.run(testFile);
+
+    std::vector<int> actual(count);
+    std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+    ASSERT_TRUE(ifs.is_open());
+    ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+    EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+    EXPECT_EQ(actual, expected);
+
+    ifs.close();
+    std::remove(testFile.c_str());
+    std::remove((testFile + ".sorted").c_str());
+}
+
+TEST(LSorterTest, ManyChunksTest)
+{
+    // 1100 块、k = 8：同一层的归并节点超过 1000 个，各轮之间没有屏障，归并输出的文件名不能冲突。
+    LSorterOptions options;
+    options.chunkSize = 64;
+    options.k = 8;
+
+    std::mt19937 engine(27);
+    std::vector<int> values(1100 * options.chunkSize / sizeof(int));
+    for (int &v : values) v = static_cast<int>(engine());
+
+    std::vector<int> expected = values;
+    std::sort(expected.begin(), expected.end());
+
+    // 冲突与否取决于各轮归并的执行先后，每种线程数重复几次。
+    for (unsigned int threads : {1u, 4u})
+    {
+        SCOPED_TRACE(threads);
+        LThreadPool pool(threads, 1);
+        for (int i = 0; i < 5; ++i) EXPECT_EQ(sortValues(pool, "lsorter_many_chunks_test.bin", values, options), expected);
+    }
+
+    EXPECT_EQ(countFiles(".", "lsorter_many_chunks_test.bin.part"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+}
+
+TEST(LSorterTest, CancelTest)
+{
+    const std::string testFile = "lsorter_cancel_test.bin";
+    LRandom::genRandomFile(testFile, -1000000, 1000000, 2000000);
+
+    LThreadPool pool(2, 1);
+    LSorter sorter(&pool, 64 * 1024, 4);
+
+    // 运行前已取消，立即抛出。
+    LCancellationToken cancelled;
+    cancelled.cancel();
+    EXPECT_THROW(sorter.run(testFile, cancelled), LCancelledError);
+
+    // 取消后不留下任何临时文件与结果文件。
+    auto expectCleanedUp = [&testFile]() {
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+        EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+        EXPECT_FALSE(std::filesystem::exists(testFile + ".sorted"));
+    };
+
+    // 运行中取消：在生成第一个有序段后由进度回调取消，此时还有段未生成、归并未开始，应抛出。
+    LCancellationToken token;
+    auto result = sorter.runAsync(
+        testFile, [token](const LSortProgress &progress) mutable {
+            if (progress.runsProduced > 0) token.cancel();
+        },
+        token);
+    EXPECT_THROW(result.get(), LCancelledError);
+    expectCleanedUp();
+
+    // 截止时间同样生效：截止时间已过，区别于主动取消。
+    LCancellationToken deadline;
+    deadline.setDeadline(LCancellationToken::Clock::now() - std::chrono::milliseconds(1));
+    try
+    {
+        sorter.run(testFile, deadline);
+        FAIL();
+    }
+    catch (const LCancelledError &e)
+    {
+        EXPECT_TRUE(e.deadlineExceeded());
+    }
+    expectCleanedUp();
+
+    // 取消后线程池仍可正常使用。
+    EXPECT_EQ(pool.enqueue([] { return 1; }).get(), 1);
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, RunAsyncTest)
+{
+    const std::string testFiles[] = {"lsorter_async_test_0.bin", "lsorter_async_test_1.bin"};
+    int count = 200000;
+    for (const std::string &testFile : testFiles) LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    LThreadPool pool(2, 1);
+    LSorter sorter(&pool, 64 * 1024, 4);
+
+    // 两个作业同时提交，在同一线程池上重叠执行。
+    std::vector<LSortProgress> reports[2];
+    std::vector<std::future<void>> results;
+    for (int j = 0; j < 2; ++j) results.push_back(sorter.runAsync(testFiles[j], [&reports, j](const LSortProgress &progress) { reports[j].push_back(progress); }));
+    for (auto &result : results) result.get();
+
+    for (int j = 0; j < 2; ++j)
+    {
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFiles[j] + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end()));
+
+        // 进度单调推进，最后一次回调为 Done 且所有计数到达总数。
+        const std::vector<LSortProgress> &progress = reports[j];
+        ASSERT_FALSE(progress.empty());
+        for (size_t i = 1; i < progress.size(); ++i)
+        {
+            EXPECT_GE(progress[i].bytesRead, progress[i - 1].bytesRead);
+            EXPECT_GE(progress[i].runsProduced, progress[i - 1].runsProduced);
+            EXPECT_GE(progress[i].mergeRoundsDone, progress[i - 1].mergeRoundsDone);
+            EXPECT_GE(static_cast<int>(progress[i].phase), static_cast<int>(progress[i - 1].phase));
+        }
+
+        const LSortProgress &last = progress.back();
+        EXPECT_EQ(last.phase, LSortProgress::Phase::Done);
+        EXPECT_EQ(last.bytesRead, count * sizeof(int));
+        EXPECT_EQ(last.totalBytes, count * sizeof(int));
+        EXPECT_EQ(last.runsProduced, last.totalRuns);
+        EXPECT_EQ(last.totalRuns, 13);
+        EXPECT_EQ(last.totalMergeRounds, 2);
+        EXPECT_EQ(last.mergeRoundsDone, last.totalMergeRounds);
+
+        ifs.close();
+        std::remove(testFiles[j].c_str());
+        std::remove((testFiles[j] + ".sorted").c_str());
+    }
+
+    // 文件不存在时 future 中保存异常。
+    auto missing = sorter.runAsync("lsorter_async_missing.bin");
+    EXPECT_THROW(missing.get(), std::runtime_error);
+}
+
+TEST(LSorterTest, IoUringTest)
+{
+    const std::string testFile = "lsorter_iouring_test.bin";
+    int count = 300000;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    // io_uring 不可用时退化为文件流，结果相同。
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    options.io.backend = LIoBackend::IoUring;
+    options.io.blockSize = 16 * 1024;
+
+    // 同一线程池上多次排序，工作线程复用各自缓存的 io_uring 实例，队列深度变化时重新创建。
+    // 队列深度超过内核上限时无法创建实例，退化为同步读写，结果相同。
+    LThreadPool pool(2, 1);
+    for (unsigned int queueDepth : {4u, 4u, 8u, 1u << 20})
+    {
+        SCOPED_TRACE(queueDepth);
+        options.io.queueDepth = queueDepth;
+
+        LSorter sorter(&pool, options);
+        sorter.runAsync(testFile).get();
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, DirectTest)
+{
+    const std::string testFile = "lsorter_direct_test.bin";
+    // 元素个数使输入文件、最后一块与各归并段的末尾都不足一个对齐单位。
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    options.io.blockSize = 16 * 1024;
+    options.io.direct = true;
+    options.directInput = true;
+    options.directOutput = true;
+
+    for (LIoBackend backend : {LIoBackend::Stream, LIoBackend::IoUring})
+    {
+        SCOPED_TRACE(LIoBackend::Stream == backend ? "Stream" : "IoUring");
+        options.io.backend = backend;
+
+        LThreadPool pool(2, 1);
+        LSorter sorter(&pool, options);
+        sorter.runAsync(testFile).get();
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_EQ(std::filesystem::file_size(testFile + ".sorted"), count * sizeof(int));
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, CacheHintsTest)
+{
+    const std::string testFile = "lsorter_cachehints_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    options.io.blockSize = 16 * 1024;
+    options.io.cacheHints = true;
+
+    LThreadPool pool(2, 1);
+    LSorter sorter(&pool, options);
+    sorter.runAsync(testFile).get();
+
+    std::vector<int> actual(count);
+    std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+    ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+    EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+    ifs.close();
+    std::remove(testFile.c_str());
+    std::remove((testFile + ".sorted").c_str());
+}
+
+TEST(LSorterTest, TempDirectoriesTest)
+{
+    const std::string testFile = "lsorter_tempdirs_test.bin";
+    // 9 个块，k 大于块数，所有归并段生成后才开始唯一的一次归并。
+    int count = 9 * 16 * 1024;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<std::string> directories;
+    for (int i = 0; i < 3; ++i)
+    {
+        directories.push_back((std::filesystem::temp_directory_path() / ("lsorter_tempdirs_" + std::to_string(i))).string());
+        std::filesystem::create_directories(directories.back());
+    }
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 16;
+
+    LThreadPool pool(2, 1);
+
+    // 不存在的目录。
+    options.tempDirectories = {"lsorter_missing_directory"};
+    EXPECT_THROW(LSorter(&pool, options), std::runtime_error);
+
+    options.tempDirectories = directories;
+    for (auto placement : {LSorterOptions::TempPlacement::RoundRobin, LSorterOptions::TempPlacement::FreeSpace})
+    {
+        options.tempPlacement = placement;
+
+        LSorter sorter(&pool, options);
+
+        // 最后一个归并段生成时统计各目录中的归并段数量。
+        std::vector<size_t> parts;
+        sorter
+            .runAsync(testFile,
+                      [&](const LSortProgress &progress) {
+                          if (progress.runsProduced != progress.totalRuns || !parts.empty()) return;
+                          for (const auto &directory : directories) parts.push_back(countFiles(directory, testFile + ".part"));
+                      })
+            .get();
+
+        size_t total = 0;
+        for (size_t n : parts) total += n;
+        EXPECT_EQ(total, 9);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+        if (LSorterOptions::TempPlacement::RoundRobin == placement)
+        {
+            EXPECT_EQ(parts, std::vector<size_t>({3, 3, 3}));
+        }
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end()));
+
+        for (const auto &directory : directories) EXPECT_EQ(countFiles(directory, ""), 0);
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    for (const auto &directory : directories) std::filesystem::remove_all(directory);
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, MemoryBudgetTest)
+{
+    const std::string testFile = "lsorter_budget_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+
+    // 预算足以容纳所有归并段时不产生任何临时文件；预算只够几块时部分归并段溢写到磁盘，结果相同。
+    for (uint64_t budget : {uint64_t(64) << 20, uint64_t(3 * 64 * 1024)})
+    {
+        SCOPED_TRACE(budget);
+        options.memoryBudget = budget;
+
+        LThreadPool pool(2, 1);
+        LSorter sorter(&pool, options);
+
+        size_t maxTempFiles = 0;
+        sorter
+            .runAsync(testFile,
+                      [&](const LSortProgress &progress) {
+                          // 根节点的输出即结果文件，在最后一轮归并完成前统计。
+                          if (progress.mergeRoundsDone == progress.totalMergeRounds) return;
+                          maxTempFiles = std::max(maxTempFiles, countFiles(".", testFile + ".part") + countFiles(LUtil::executableDirectory(), "tmp_merge_"));
+                      })
+            .get();
+
+        if (budget > uint64_t(count) * 2 * sizeof(int)) EXPECT_EQ(maxTempFiles, 0);
+        else EXPECT_GT(maxTempFiles, 0);
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, CompressRunsTest)
+{
+    // 取值范围小的数据排序后相邻差值很小，压缩后的临时文件明显小于原始数据。
+    const std::string testFile = "lsorter_compress_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -10000, 10000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    options.compressRuns = true;
+
+    LThreadPool pool(2, 1);
+    LSorter sorter(&pool, options);
+
+    uint64_t maxTempBytes = 0;
+    sorter
+        .runAsync(testFile,
+                  [&](const LSortProgress &progress) {
+                      if (progress.mergeRoundsDone == progress.totalMergeRounds) return;
+                      uint64_t bytes = 0;
+                      for (const auto &entry : std::filesystem::directory_iterator("."))
+                          if (0 == entry.path().filename().string().rfind(testFile + ".part", 0)) bytes += entry.file_size();
+                      maxTempBytes = std::max(maxTempBytes, bytes);
+                  })
+        .get();
+
+    EXPECT_GT(maxTempBytes, 0);
+    EXPECT_LT(maxTempBytes, uint64_t(count) * sizeof(int) / 2);
+
+    std::vector<int> actual(count);
+    std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+    ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+    EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+    EXPECT_EQ(actual, expected);
+    EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+
+    ifs.close();
+    std::remove((testFile + ".sorted").c_str());
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, MapInputTest)
+{
+    const std::string testFile = "lsorter_mapinput_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    options.mapInput = true;
+
+    // 多个 I/O 工作线程并发地从映射中复制各块；与 directInput 同时开启时退化为按偏移读取，结果相同。
+    for (bool directInput : {false, true})
+    {
+        SCOPED_TRACE(directInput);
+        options.directInput = directInput;
+
+        LThreadPool pool(2, 2);
+        LSorter sorter(&pool, options);
+        sorter.runAsync(testFile).get();
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, InputReadersTest)
+{
+    const std::string testFile = "lsorter_readers_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+
+    // 多条读取链按各自的偏移并发读取，块数不是读者数的整数倍；读者数多于块数与 0 个读者同样正确。
+    for (unsigned int readers : {0u, 3u, 4u, 1000u})
+    {
+        SCOPED_TRACE(readers);
+        options.inputReaders = readers;
+
+        LThreadPool pool(2, 4);
+        LSorter sorter(&pool, options);
+        sorter.runAsync(testFile).get();
+
+        std::vector<int> actual(count);
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), count * sizeof(int));
+        EXPECT_EQ(ifs.gcount(), count * sizeof(int));
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+
+        ifs.close();
+        std::remove((testFile + ".sorted").c_str());
+    }
+
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, StreamTest)
+{
+    // 长度未知的输入：块数多于 k 的平方，需要中间归并轮；末尾多出的 2 个字节被忽略。
+    std::mt19937 engine(2025);
+    std::uniform_int_distribution<int> dist(-1000000, 1000000);
+    std::vector<int> expected(300001);
+    for (int &v : expected) v = dist(engine);
+    std::string input(reinterpret_cast<const char *>(expected.data()), expected.size() * sizeof(int));
+    input += "xy";
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+
+    // 全部溢写、压缩溢写、部分留在内存中的归并段。
+    for (int mode = 0; mode < 3; ++mode)
+    {
+        SCOPED_TRACE(mode);
+        options.compressRuns = 1 == mode;
+        options.memoryBudget = 2 == mode ? 6 * 64 * 1024 : 0;
+
+        LThreadPool pool(2, 1);
+        LSorter sorter(&pool, options);
+
+        std::istringstream in(input);
+        std::ostringstream out;
+        sorter.sortStream(in, out);
+
+        std::string result = out.str();
+        ASSERT_EQ(result.size(), expected.size() * sizeof(int));
+        EXPECT_EQ(0, std::memcmp(result.data(), expected.data(), result.size()));
+        EXPECT_EQ(countFiles(LUtil::executableDirectory(), "stream_"), 0);
+        EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+    }
+
+    // 多于 1000 个归并段：多轮归并的输出文件名不能冲突。
+    {
+        LSorterOptions tiny;
+        tiny.chunkSize = 64;
+        tiny.k = 8;
+        std::string manyRuns = input.substr(0, 1100 * tiny.chunkSize);
+        std::vector<int> manyExpected(manyRuns.size() / sizeof(int));
+        std::memcpy(manyExpected.data(), manyRuns.data(), manyRuns.size());
+        std::sort(manyExpected.begin(), manyExpected.end());
+
+        LThreadPool pool(2, 1);
+        LSorter sorter(&pool, tiny);
+        std::istringstream in(manyRuns);
+        std::ostringstream out;
+        sorter.sortStream(in, out);
+
+        std::string result = out.str();
+        ASSERT_EQ(result.size(), manyRuns.size());
+        EXPECT_EQ(0, std::memcmp(result.data(), manyExpected.data(), result.size()));
+        EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+    }
+
+    // 空输入产生空输出。
+    LThreadPool pool(2, 1);
+    LSorter sorter(&pool, options);
+    std::istringstream empty;
+    std::ostringstream out;
+    sorter.sortStream(empty, out);
+    EXPECT_TRUE(out.str().empty());
+
+    // 取消后抛出异常且不留下临时文件。
+    LCancellationToken cancelled;
+    cancelled.cancel();
+    std::istringstream in(input);
+    EXPECT_THROW(sorter.sortStream(in, out, cancelled), LCancelledError);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "stream_"), 0);
+
+#ifdef L_OS_LINUX
+    // 从管道读取、写到管道：写者线程分多次写入输入，读者线程收集输出。
+    int inputPipe[2];
+    int outputPipe[2];
+    ASSERT_EQ(0, ::pipe(inputPipe));
+    ASSERT_EQ(0, ::pipe(outputPipe));
+
+    std::thread producer([&]() {
+        for (size_t offset = 0; offset < input.size();)
+        {
+            ssize_t n = ::write(inputPipe[1], input.data() + offset, std::min<size_t>(12345, input.size() - offset));
+            if (n <= 0) break;
+            offset += static_cast<size_t>(n);
+        }
+        ::close(inputPipe[1]);
+    });
+
+    std::string result;
+    std::thread consumer([&]() {
+        char block[65536];
+        ssize_t n;
+        while ((n = ::read(outputPipe[0], block, sizeof(block))) > 0) result.append(block, static_cast<size_t>(n));
+    });
+
+    sorter.sortStream(inputPipe[0], outputPipe[1]);
+    ::close(outputPipe[1]);
+    producer.join();
+    consumer.join();
+    ::close(inputPipe[0]);
+    ::close(outputPipe[0]);
+
+    ASSERT_EQ(result.size(), expected.size() * sizeof(int));
+    EXPECT_EQ(0, std::memcmp(result.data(), expected.data(), result.size()));
+#endif
+}
+
+TEST(LSorterTest, CursorTest)
+{
+    const std::string testFile = "lsorter_cursor_test.bin";
+    int count = 300001;
+    LRandom::genRandomFile(testFile, -1000000, 1000000, count);
+
+    std::vector<int> expected(count);
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(expected.data()), count * sizeof(int));
+    }
+    std::sort(expected.begin(), expected.end());
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    LThreadPool pool(2, 1);
+
+    // 多块（需要中间归并轮）与单块：最后一轮归并由游标拉取，不生成结果文件，读完后不留下临时文件。
+    for (unsigned int chunkSize : {64u * 1024, 4u * 1024 * 1024})
+    {
+        SCOPED_TRACE(chunkSize);
+        options.chunkSize = chunkSize;
+
+        std::unique_ptr<LSortCursor> cursor;
+        {
+            // 游标不依赖排序器对象。
+            LSorter sorter(&pool, options);
+            cursor = sorter.openCursor(testFile);
+        }
+        EXPECT_FALSE(std::filesystem::exists(testFile + ".sorted"));
+
+        std::vector<int> actual;
+        const int *data;
+        while (size_t n = cursor->next(data)) actual.insert(actual.end(), data, data + n);
+        EXPECT_EQ(actual, expected);
+        EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+        EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+    }
+
+    LSorter sorter(&pool, options);
+
+    // 提前析构游标时删除剩余的临时文件。
+    options.chunkSize = 64 * 1024;
+    LSorter small(&pool, options);
+    {
+        std::unique_ptr<LSortCursor> cursor = small.openCursor(testFile);
+        const int *data;
+        ASSERT_GT(cursor->next(data), 0);
+        EXPECT_EQ(*data, expected[0]);
+    }
+    EXPECT_EQ(countFiles(".", testFile + ".part"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+
+    // 输入流游标。
+    {
+        std::ifstream ifs(testFile, std::ios::binary);
+        std::unique_ptr<LSortCursor> cursor = small.openCursor(ifs);
+        std::vector<int> actual;
+        const int *data;
+        while (size_t n = cursor->next(data)) actual.insert(actual.end(), data, data + n);
+        EXPECT_EQ(actual, expected);
+    }
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "stream_"), 0);
+
+    // 空文件的游标立即结束，也不生成结果文件。
+    const std::string emptyFile = "lsorter_cursor_empty.bin";
+    std::ofstream(emptyFile, std::ios::binary).close();
+    {
+        std::unique_ptr<LSortCursor> cursor = sorter.openCursor(emptyFile);
+        const int *data;
+        EXPECT_EQ(cursor->next(data), 0);
+    }
+    EXPECT_FALSE(std::filesystem::exists(emptyFile + ".sorted"));
+
+    EXPECT_THROW(sorter.openCursor("lsorter_cursor_missing.bin"), std::runtime_error);
+
+    std::remove(emptyFile.c_str());
+    std::remove(testFile.c_str());
+}
+
+TEST(LSorterTest, ElementTypeTest)
+{
+    // 块大小取得较小，保证产生多个块并经过多轮归并。
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    LThreadPool pool(2, 1);
+
+    std::mt19937_64 engine(46);
+
+    // 64 位整数：取值超出 int 的范围。
+    {
+        std::vector<int64_t> values(100001);
+        for (int64_t &v : values) v = static_cast<int64_t>(engine());
+
+        std::vector<int64_t> expected = values;
+        std::sort(expected.begin(), expected.end());
+        EXPECT_EQ(sortValues(pool, "lsorter_int64_test.bin", values, options), expected);
+    }
+
+    // 浮点数降序，归并段留在内存中；compressRuns 只适用于 int，这里被忽略。
+    {
+        LSorterOptions memory = options;
+        memory.memoryBudget = 1 << 20;
+        memory.compressRuns = true;
+
+        std::uniform_real_distribution<double> distribution(-1e6, 1e6);
+        std::vector<double> values(100001);
+        for (double &v : values) v = distribution(engine);
+
+        std::vector<double> expected = values;
+        std::sort(expected.begin(), expected.end(), std::greater<double>());
+        EXPECT_EQ(sortValues(pool, "lsorter_double_test.bin", values, memory, std::greater<double>()), expected);
+    }
+
+    // 12 字节的记录按 key 排序，O_DIRECT 读写时块大小取 12 与 4 KiB 的公倍数，记录不会跨块。
+    {
+        LSorterOptions direct = options;
+        direct.chunkSize = 60000;
+        direct.io.blockSize = 16 * 1024;
+        direct.io.direct = true;
+        direct.directInput = true;
+        direct.directOutput = true;
+
+        auto byKey = [](const LSorterTestRecord &a, const LSorterTestRecord &b) { return a.key < b.key; };
+
+        std::vector<LSorterTestRecord> values(50001);
+        for (uint32_t i = 0; i < values.size(); ++i) values[i] = {static_cast<uint32_t>(engine() % 1000), i, i * 7};
+
+        std::vector<LSorterTestRecord> actual = sortValues(pool, "lsorter_record_test.bin", values, direct, byKey);
+        ASSERT_EQ(actual.size(), values.size());
+        EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end(), byKey));
+
+        // 每条记录原样出现一次。
+        std::vector<bool> seen(values.size(), false);
+        for (const LSorterTestRecord &record : actual)
+        {
+            ASSERT_LT(record.index, values.size());
+            EXPECT_FALSE(seen[record.index]);
+            seen[record.index] = true;
+            EXPECT_EQ(record.key, values[record.index].key);
+            EXPECT_EQ(record.payload, record.index * 7);
+        }
+    }
+
+    // 流式排序与游标同样按元素类型与比较器工作。
+    {
+        std::vector<uint16_t> values(70001);
+        for (uint16_t &v : values) v = static_cast<uint16_t>(engine());
+        std::vector<uint16_t> expected = values;
+        std::sort(expected.begin(), expected.end(), std::greater<uint16_t>());
+
+        LBasicSorter<uint16_t, std::greater<uint16_t>> sorter(&pool, options);
+        std::istringstream input(std::string(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(uint16_t)) + "x");
+        std::ostringstream output;
+        sorter.sortStream(input, output);
+
+        std::string bytes = output.str();
+        ASSERT_EQ(bytes.size(), values.size() * sizeof(uint16_t));
+        std::vector<uint16_t> actual(values.size());
+        std::memcpy(actual.data(), bytes.data(), bytes.size());
+        EXPECT_EQ(actual, expected);
+
+        input.clear();
+        input.seekg(0);
+        std::unique_ptr<LBasicSortCursor<uint16_t, std::greater<uint16_t>>> cursor = sorter.openCursor(input);
+        actual.clear();
+        const uint16_t *data;
+        while (size_t n = cursor->next(data)) actual.insert(actual.end(), data, data + n);
+        EXPECT_EQ(actual, expected);
+    }
+
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "stream_"), 0);
+}
+
+TEST(LSorterTest, RecordTest)
+{
+    // 记录模式：块排序只排序（键，下标）标签，归并只比较缓存的键，负载原样保留。
+    std::mt19937_64 engine(47);
+    std::vector<LSorterTestWideRecord> values(40001);
+    for (uint32_t i = 0; i < values.size(); ++i)
+    {
+        values[i].key = static_cast<int64_t>(engine() % 5000) - 2500;
+        values[i].index = i;
+        std::memset(values[i].payload, static_cast<int>(i % 251), sizeof(values[i].payload));
+    }
+
+    using Compare = LKeyLess<LSorterTestWideKey>;
+
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    LThreadPool pool(2, 1);
+
+    // 磁盘归并段与内存归并段。
+    for (uint64_t budget : {uint64_t(0), uint64_t(16) << 20})
+    {
+        SCOPED_TRACE(budget);
+        options.memoryBudget = budget;
+
+        std::vector<LSorterTestWideRecord> actual = sortValues(pool, "lsorter_record_wide_test.bin", values, options, Compare());
+        ASSERT_EQ(actual.size(), values.size());
+        EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end(), Compare()));
+
+        std::vector<bool> seen(values.size(), false);
+        for (const LSorterTestWideRecord &record : actual)
+        {
+            ASSERT_LT(record.index, values.size());
+            EXPECT_FALSE(seen[record.index]);
+            seen[record.index] = true;
+            EXPECT_EQ(record.key, values[record.index].key);
+            EXPECT_EQ(0, std::memcmp(record.payload, values[record.index].payload, sizeof(record.payload)));
+        }
+    }
+
+    EXPECT_EQ(countFiles(".", "lsorter_record_wide_test.bin.part"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+}
+
+TEST(LSorterTest, OddRecordTest)
+{
+    // 记录大小不整除 4 时，块读写器的块大小也须为记录大小的整数倍，记录不能跨块，否则归并会丢弃跨块的记录并错位。
+    static_assert(sizeof(LSorterTestOddRecord) == 6, "LSorterTestOddRecord must be 6 bytes.");
+
+    std::mt19937 engine(53);
+    std::vector<LSorterTestOddRecord> values(1 << 18);
+    for (uint32_t i = 0; i < values.size(); ++i) values[i] = {static_cast<uint16_t>(engine()), static_cast<uint16_t>(i >> 16), static_cast<uint16_t>(i)};
+
+    auto byKey = [](const LSorterTestOddRecord &a, const LSorterTestOddRecord &b) { return a.key < b.key; };
+
+    // 26 个归并段，4 路归并需要多轮，每个归并段跨越多个块。
+    LSorterOptions options;
+    options.chunkSize = 60000;
+    options.k = 4;
+    options.io.blockSize = 16 * 1024;
+    LThreadPool pool(2, 1);
+
+    for (LIoBackend backend : {LIoBackend::Stream, LIoBackend::IoUring})
+    {
+        SCOPED_TRACE(LIoBackend::Stream == backend ? "Stream" : "IoUring");
+        options.io.backend = backend;
+
+        std::vector<LSorterTestOddRecord> actual = sortValues(pool, "lsorter_record_odd_test.bin", values, options, byKey);
+        ASSERT_EQ(actual.size(), values.size());
+        EXPECT_TRUE(std::is_sorted(actual.begin(), actual.end(), byKey));
+
+        std::vector<bool> seen(values.size(), false);
+        for (const LSorterTestOddRecord &record : actual)
+        {
+            ASSERT_LT(record.index(), values.size());
+            EXPECT_FALSE(seen[record.index()]);
+            seen[record.index()] = true;
+            EXPECT_EQ(record.key, values[record.index()].key);
+        }
+    }
+
+    EXPECT_EQ(countFiles(".", "lsorter_record_odd_test.bin.part"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+}
+
+TEST(LSorterTest, TextFormatTest)
+{
+    std::mt19937 engine(49);
+    std::vector<int> values(60001);
+    for (int &v : values) v = static_cast<int>(engine());
+    values[0] = INT32_MIN;
+    values[1] = INT32_MAX;
+
+    std::vector<int> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::string expected;
+    for (int v : sorted) expected += std::to_string(v) + "\n";
+
+    // 混用换行、空格、制表符、逗号与 CRLF，正数部分带 '+'，最后一个数字之后没有分隔符。
+    const char *separators[] = {"\n", " ", ",", "\t", "\r\n", ", "};
+    std::string input;
+    for (size_t i = 0; i < values.size(); ++i)
+    {
+        input += (values[i] > 0 && 0 == i % 3 ? "+" : "") + std::to_string(values[i]);
+        if (i + 1 < values.size()) input += separators[i % 6];
+    }
+
+    // 块很小，大量数字跨块；两种内存预算下各排序一次。
+    LSorterOptions options;
+    options.chunkSize = 4 * 1024;
+    options.k = 4;
+    options.inputFormat = LSorterOptions::Format::Text;
+    options.outputFormat = LSorterOptions::Format::Text;
+    LThreadPool pool(4, 1);
+
+    for (uint64_t budget : {uint64_t(0), uint64_t(64) << 20})
+    {
+        SCOPED_TRACE(budget);
+        options.memoryBudget = budget;
+
+        LSorter sorter(&pool, options);
+        std::istringstream in(input);
+        std::ostringstream out;
+        sorter.sortStream(in, out);
+        EXPECT_EQ(out.str(), expected);
+    }
+
+    // 文件：文本输入、文本结果，进度只在结束时上报一次。
+    const std::string testFile = "lsorter_text_test.txt";
+    {
+        std::ofstream ofs(testFile, std::ios::binary);
+        ofs << input;
+    }
+    options.chunkSize = 64 * 1024;
+    {
+        LSorter sorter(&pool, options);
+        std::vector<LSortProgress::Phase> phases;
+        sorter.runAsync(testFile, [&phases](const LSortProgress &progress) { phases.push_back(progress.phase); }).get();
+        EXPECT_EQ(phases, std::vector<LSortProgress::Phase>{LSortProgress::Phase::Done});
+
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        std::stringstream actual;
+        actual << ifs.rdbuf();
+        EXPECT_EQ(actual.str(), expected);
+    }
+
+    // 文本输入、二进制结果，以及游标。
+    {
+        LSorterOptions binaryOutput = options;
+        binaryOutput.outputFormat = LSorterOptions::Format::Binary;
+        LSorter sorter(&pool, binaryOutput);
+        sorter.runAsync(testFile).get();
+
+        std::vector<int> actual(sorted.size());
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        ifs.read(reinterpret_cast<char *>(actual.data()), actual.size() * sizeof(int));
+        EXPECT_EQ(actual, sorted);
+        EXPECT_EQ(std::filesystem::file_size(testFile + ".sorted"), sorted.size() * sizeof(int));
+
+        auto cursor = sorter.openCursor(testFile);
+        std::vector<int> pulled;
+        const int *data;
+        while (size_t count = cursor->next(data)) pulled.insert(pulled.end(), data, data + count);
+        EXPECT_EQ(pulled, sorted);
+    }
+
+    // 二进制输入、文本结果。
+    {
+        LSorterOptions binaryInput = options;
+        binaryInput.inputFormat = LSorterOptions::Format::Binary;
+        LSorter sorter(&pool, binaryInput);
+        {
+            std::ofstream ofs(testFile, std::ios::binary);
+            ofs.write(reinterpret_cast<const char *>(values.data()), values.size() * sizeof(int));
+        }
+        sorter.runAsync(testFile).get();
+
+        std::ifstream ifs(testFile + ".sorted", std::ios::binary);
+        std::stringstream actual;
+        actual << ifs.rdbuf();
+        EXPECT_EQ(actual.str(), expected);
+    }
+    std::remove((testFile + ".sorted").c_str());
+    std::remove(testFile.c_str());
+
+    // 64 位整数。
+    {
+        LBasicSorter<int64_t> sorter(&pool, options);
+        std::istringstream in("9223372036854775807\n-5,-9223372036854775808 +0\n1234567890123");
+        std::ostringstream out;
+        sorter.sortStream(in, out);
+        EXPECT_EQ(out.str(), "-9223372036854775808\n-5\n0\n1234567890123\n9223372036854775807\n");
+    }
+
+    // 非法字符、超出取值范围与空输入。
+    for (const char *invalid : {"1\n2x\n3", "1 2147483648", "+-1", "1 - 2", "0x10"})
+    {
+        SCOPED_TRACE(invalid);
+        LSorter sorter(&pool, options);
+        std::istringstream in(invalid);
+        std::ostringstream out;
+        EXPECT_THROW(sorter.sortStream(in, out), std::runtime_error);
+    }
+    {
+        LSorter sorter(&pool, options);
+        std::istringstream in(" \n,\n");
+        std::ostringstream out;
+        sorter.sortStream(in, out);
+        EXPECT_TRUE(out.str().empty());
+    }
+
+    // 非整数元素类型不支持文本格式。
+    EXPECT_THROW((LBasicSorter<double>(&pool, options)), std::runtime_error);
+
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "stream_"), 0);
+    EXPECT_EQ(countFiles(LUtil::executableDirectory(), "tmp_merge_"), 0);
+}
+
+TEST(LSorterTest, FloatTest)
+{
+    // float 与 double 默认按 LFloatLess 全序排序：块排序为整数键的基数排序，归并比较缓存的整数键。
+    LSorterOptions options;
+    options.chunkSize = 64 * 1024;
+    options.k = 4;
+    LThreadPool pool(2, 1);
+
+    std::mt19937_64 engine(50);
+    std::uniform_real_distribution<double> distribution(-1e3, 1e3);
+
+    const double inf = std::numeric_limits<double>::infinity();
+    const double nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<double> values(100001);
+    for (double &v : values)
+    {
+        switch (engine() % 16)
+        {
+            case 0: v = nan; break;
+            case 1: v = -nan; break;
+            case 2: v = 0.0; break;
+            case 3: v = -0.0; break;
+            case 4: v = engine() % 2 ? inf : -inf; break;
+            default: v = distribution(engine); break;
+        }
+    }
+
+    std::vector<double> expected = values;
+    std::sort(expected.begin(), expected.end(), LFloatLess<double>());
+
+    // 逐位比较：-inf 在最前，-0.0 在 +0.0 之前，正 NaN 在 +inf 之后，负 NaN 在最后。
+    auto sameBits = [](const std::vector<double> &a, const std::vector<double> &b) { return a.size() == b.size() && 0 == std::memcmp(a.data(), b.data(), a.size() * sizeof(double)); };
+    ASSERT_TRUE(std::signbit(expected.front()) && std::isinf(expected.front()));
+    ASSERT_TRUE(std::signbit(expected.back()) && std::isnan(expected.back()));
+
+    for (uint64_t budget : {uint64_t(0), uint64_t(16) << 20})
+    {
+        SCOPED_TRACE(budget);
+        options.memoryBudget = budget;
+        EXPECT_TRUE(sameBits(sortValues(pool, "lsorter_float_test.bin", values, options), expected));
+    }
+
+    auto firstZero = std::find(expected.begin(), expected.end(), 0.0);
+    auto lastZero = std::find_if(firstZero, expected.end(), [](double v) { return v != 0.0; });
+    ASSERT_NE(firstZero, lastZero);
+    EXPECT_TRUE(std::signbit(*firstZero));
+    EXPECT_FALSE(std::signbit(*(lastZero - 1)));
+    EXPECT_TRUE(std::isnan(*lastZero) || std::isinf(*lastZero) || *lastZero > 0);
+
+    // float 的流式排序。
+    std::vector<float> floats(50001);
+    for (float &v : floats) v = engine() % 8 ? static_cast<float>(distribution(engine)) : std::numeric_limits<float>::quiet_NaN();
+    std::vector<float> floatExpected = floats;
+    std::sort(floatExpected.begin(), floatExpected.end(), LFloatLess<float>());
+
+    LBasicSorter<float> sorter(&pool, options);
+    std::istringstream in(std::string(reinterpret_cast<const char *>(floats.data()), floats.size() * sizeof(float)));
+    std::ostringstream out;
+    sorter.sortStream(in, out);
+    ASSERT_EQ(out.str().size(), floats.size() * sizeof(float));
+    EXPECT_EQ(0, std::memcmp(out.str().data(), floatExpected.data(), out.str().size()));
 }
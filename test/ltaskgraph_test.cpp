@@ -0,0 +1,100 @@
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <stdexcept>
+
+#include "ltaskgraph.h"
+
+
+TEST(LTaskGraphTest, DependencyTest)
+{
+    LThreadPool pool(4);
+    LTaskGraph graph(&pool);
+
+    // 菱形依赖：a -> b, a -> c, b -> d, c -> d。
+    std::atomic<int> step = {0};
+    int a = -1, b = -1, c = -1, d = -1;
+
+    auto na = graph.addNode([&] { a = step++; });
+    auto nb = graph.addNode([&] { b = step++; });
+    auto nc = graph.addNode([&] { c = step++; });
+    auto nd = graph.addNode([&] { d = step++; });
+
+    graph.addEdge(na, nb);
+    graph.addEdge(na, nc);
+    graph.addEdge(nb, nd);
+    graph.addEdge(nc, nd);
+
+    graph.run();
+
+    EXPECT_EQ(a, 0);
+    EXPECT_LT(a, b);
+    EXPECT_LT(a, c);
+    EXPECT_EQ(d, 3);
+}
+
+TEST(LTaskGraphTest, ExceptionTest)
+{
+    LThreadPool pool(2);
+    LTaskGraph graph(&pool);
+
+    bool executed = false;
+    auto na = graph.addNode([] { throw std::runtime_error("failed"); });
+    auto nb = graph.addNode([&] { executed = true; });
+    graph.addEdge(na, nb);
+
+    EXPECT_THROW(graph.run(), std::runtime_error);
+    EXPECT_FALSE(executed);
+}
+
+TEST(LTaskGraphTest, StoppedPoolTest)
+{
+    // 线程池已停止：根节点无法提交，run() 重新抛出提交失败的异常，而不是永远等待。
+    {
+        LThreadPool pool(2, 1);
+        pool.shutdown();
+
+        LTaskGraph graph(&pool);
+        bool executed = false;
+        auto na = graph.addNode([&] { executed = true; });
+        auto nb = graph.addNode([&] { executed = true; }, LThreadPool::Priority::Normal, LThreadPool::Lane::Io);
+        graph.addEdge(na, nb);
+
+        EXPECT_THROW(graph.run(), std::runtime_error);
+        EXPECT_FALSE(executed);
+    }
+
+    // 执行中途停止：后继节点无法提交，其整棵子树都不再执行，run() 同样返回。
+    {
+        LThreadPool pool(2);
+        LTaskGraph graph(&pool);
+
+        std::atomic<int> executed = {0};
+        auto na = graph.addNode([&] { pool.shutdown(); });
+        auto nb = graph.addNode([&] { ++executed; });
+        auto nc = graph.addNode([&] { ++executed; });
+        auto nd = graph.addNode([&] { ++executed; });
+        graph.addEdge(na, nb);
+        graph.addEdge(na, nc);
+        graph.addEdge(nb, nd);
+        graph.addEdge(nc, nd);
+
+        EXPECT_THROW(graph.run(), std::runtime_error);
+        EXPECT_EQ(executed, 0);
+    }
+}
+
+TEST(LTaskGraphTest, CycleTest)
+{
+    LThreadPool pool(1);
+    LTaskGraph graph(&pool);
+
+    auto na = graph.addNode([] {});
+    auto nb = graph.addNode([] {});
+    auto nc = graph.addNode([] {});
+    graph.addEdge(na, nb);
+    graph.addEdge(nb, nc);
+    graph.addEdge(nc, nb);
+
+    EXPECT_THROW(graph.run(), std::logic_error);
+}
@@ -33,3 +33,152 @@ TEST(LThreadPoolTest, Test1)
         EXPECT_EQ(val, i * i);
     }
 }
+
+TEST(LThreadPoolTest, ShutdownTest)
+{
+    // 停止后不再接收新任务，已在队列中的任务仍会执行完毕。
+    LThreadPool pool(1, 1);
+    std::future<int> queued = pool.enqueue([] { return 1; });
+    pool.shutdown();
+
+    EXPECT_EQ(queued.get(), 1);
+    EXPECT_THROW(pool.enqueue([] { return 2; }), std::runtime_error);
+    EXPECT_THROW(pool.enqueueIo(LThreadPool::Priority::Normal, [] { return 3; }), std::runtime_error);
+    pool.shutdown();
+}
+
+TEST(LThreadPoolTest, ZeroThreadsTest)
+{
+    // 按线程数构造时 0 表示不创建计算线程，任务由 wait() 的调用者执行；按选项构造时 0 表示按 CPU 拓扑决定线程数。
+    LThreadPool pool(0);
+    EXPECT_EQ(pool.size(), 0);
+
+    std::future<int> result = pool.enqueue([] { return 7; });
+    EXPECT_EQ(pool.wait(result), 7);
+
+    LThreadPool sized{LThreadPoolOptions()};
+    EXPECT_EQ(sized.size(), LCpuTopology::recommendedThreadCount());
+}
+
+TEST(LThreadPoolTest, NestedWaitTest)
+{
+    // 只有一个工作线程时，任务内部用 get() 等待子任务必然死锁，wait() 会在等待期间执行子任务。
+    LThreadPool pool(1);
+
+    auto f = pool.enqueue([&pool] { //
+        std::vector<std::future<int>> children;
+        for (int i = 0; i < 4; ++i) children.push_back(pool.enqueue([i] { return i; }));
+
+        int sum = 0;
+        for (auto &child : children) sum += pool.wait(child);
+
+
+        return sum;
+    });
+
+    EXPECT_EQ(pool.wait(f), 0 + 1 + 2 + 3);
+}
+
+TEST(LThreadPoolTest, PriorityTest)
+{
+    LThreadPool pool(1, 1);
+
+    // 先用一个任务占住唯一的计算线程，再提交不同优先级的任务，检查执行顺序。
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    auto blocker = pool.enqueue([opened] { opened.wait(); });
+
+    std::mutex orderMutex;
+    std::vector<int> order;
+    auto record = [&orderMutex, &order](int value) {
+        std::unique_lock<std::mutex> lock(orderMutex);
+        order.push_back(value);
+    };
+
+    auto low = pool.enqueue(LThreadPool::Priority::Low, record, 0);
+    auto normal = pool.enqueue(LThreadPool::Priority::Normal, record, 1);
+    auto high = pool.enqueue(LThreadPool::Priority::High, record, 2);
+
+    // I/O 通道由独立线程执行，不受被占住的计算线程影响。
+    auto io = pool.enqueueIo(LThreadPool::Priority::Normal, [] { return 42; });
+    EXPECT_EQ(io.get(), 42);
+
+    gate.set_value();
+    blocker.get();
+    low.get();
+    normal.get();
+    high.get();
+
+    EXPECT_EQ(order, std::vector<int>({2, 1, 0}));
+}
+
+TEST(LThreadPoolTest, ElasticTest)
+{
+    LThreadPoolOptions options;
+    options.threads = 1;
+    options.maxThreads = 3;
+    options.idleTimeout = std::chrono::milliseconds(50);
+    LThreadPool pool(options);
+
+    EXPECT_EQ(pool.size(), 1);
+
+    // 唯一的线程阻塞在 BlockingScope 中时，队列中的任务应由新增的线程执行。
+    std::promise<void> gate;
+    std::shared_future<void> opened = gate.get_future().share();
+    auto blocked = pool.enqueue([opened] {
+        LThreadPool::BlockingScope blocking;
+        opened.wait();
+    });
+    auto other = pool.enqueue([] { return 7; });
+
+    EXPECT_EQ(std::future_status::ready, other.wait_for(std::chrono::seconds(5)));
+    EXPECT_EQ(other.get(), 7);
+    EXPECT_GE(pool.size(), 2);
+
+    gate.set_value();
+    blocked.get();
+
+    // 多余的线程空闲超时后退出，回到下限。
+    for (int i = 0; i < 100 && pool.size() > 1; ++i) std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    EXPECT_EQ(pool.size(), 1);
+
+    EXPECT_EQ(pool.enqueue([] { return 8; }).get(), 8);
+}
+
+TEST(LThreadPoolTest, StatsTest)
+{
+    LThreadPool pool(2, 1);
+
+    std::vector<std::future<void>> results;
+    for (int i = 0; i < 20; ++i) results.emplace_back(pool.enqueue([] { std::this_thread::sleep_for(std::chrono::milliseconds(2)); }));
+    results.emplace_back(pool.enqueueIo(LThreadPool::Priority::Normal, [] { std::this_thread::sleep_for(std::chrono::milliseconds(5)); }));
+    for (auto &result : results) result.get();
+
+    // future 就绪时任务的统计可能还未写入，稍等片刻。
+    LThreadPoolStats stats = pool.stats();
+    for (int i = 0; i < 100 && stats.completed < 21; ++i)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        stats = pool.stats();
+    }
+
+    EXPECT_EQ(stats.enqueued, 21);
+    EXPECT_EQ(stats.completed, 21);
+    EXPECT_EQ(stats.queueDepth, 0);
+    EXPECT_EQ(stats.ioQueueDepth, 0);
+    EXPECT_GE(stats.peakQueueDepth, 1);
+    EXPECT_EQ(stats.liveThreads, 2);
+    ASSERT_EQ(stats.workerBusy.size(), 2);
+    ASSERT_EQ(stats.ioWorkerBusy.size(), 1);
+
+    // 20 个 2 ms 的计算任务分摊在两个线程上，I/O 线程执行了一个 5 ms 的任务。
+    EXPECT_GE((stats.workerBusy[0] + stats.workerBusy[1]).count(), 40000000);
+    EXPECT_GE(stats.ioWorkerBusy[0].count(), 5000000);
+    EXPECT_GT(stats.utilization(), 0);
+    EXPECT_LE(stats.utilization(), 1);
+
+    EXPECT_EQ(stats.runTime.count, 21);
+    EXPECT_EQ(stats.queueWait.count, 21);
+    EXPECT_GE(stats.runTime.percentile(50), 2000000);
+    EXPECT_GE(stats.queueWait.max, 2000000); // 至少有任务排在前一批任务之后。
+}